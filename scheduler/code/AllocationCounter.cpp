@@ -0,0 +1,34 @@
+#include "RunMetrics.h"
+#include "cstdlib"
+#include "new"
+
+using namespace std;
+
+/// Replaces the global operator new so the allocations of each run can be written to its metrics. It is a diagnostic
+/// and only linked into the executables which want it, see CMakeLists.txt. The aligned forms are not counted.
+void *operator new(size_t size){
+    threadAllocationCount.allocations++;
+    threadAllocationCount.bytes += size;
+    while(true){
+        void *memory = malloc(size == 0 ? 1 : size);
+        if(memory != nullptr){
+            return memory;
+        }
+        new_handler handler = get_new_handler();
+        if(handler == nullptr){
+            throw bad_alloc();
+        }
+        handler();
+    }
+}
+
+void operator delete(void *memory) noexcept{
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept{
+    free(memory);
+}
+
+/// the metrics only report the allocations of the executables which link this file
+[[maybe_unused]] static const bool counting = (allocationsCounted = true);
@@ -0,0 +1,470 @@
+#include "BusChargePlanner.h"
+#include "algorithm"
+#include "cmath"
+#include "ModelIR.h"
+
+using namespace std;
+
+/// the tolerance of the comparisons of times and capacities with the grid
+static const double GRID_TOLERANCE = 1e-9;
+
+/// value[r] becomes the cheapest value[r'] plus price for each of the r - r' energy steps, with r - r' at most units
+/// and r at most top. queue is the buffer of the monotone queue of the sliding window minimum
+static void addEnergyPiece(vector<double> &value, vector<int> &origin, vector<double> &buffer,
+                           vector<int> &bufferOrigin, vector<int> &queue, int top, int units, double stepPrice){
+    int head = 0;
+    queue.clear();
+    for(int r = 0; r <= top; r++){
+        if(value[r] < INFINITE_BOUND){
+            double key = value[r] - stepPrice * r;
+            while(queue.size() > head && value[queue.back()] - stepPrice * queue.back() >= key){
+                queue.pop_back();
+            }
+            queue.push_back(r);
+        }
+        while(queue.size() > head && queue[head] < r - units){
+            head++;
+        }
+        if(queue.size() > head){
+            int from = queue[head];
+            buffer[r] = value[from] + stepPrice * (r - from);
+            bufferOrigin[r] = origin[from];
+        }
+        else{
+            buffer[r] = INFINITE_BOUND;
+        }
+    }
+    for(int r = 0; r <= top; r++){
+        value[r] = buffer[r];
+        origin[r] = bufferOrigin[r];
+    }
+}
+
+BusChargePlanner::BusChargePlanner(const ModelParameters &parameters, const RunConfig &config,
+                                   const vector<CleanEnergyWindow> &windows): windows(windows){
+    timeStep = config.dpTimeStep;
+    energyStep = config.dpEnergyStep;
+    chargeRate = config.chargeRate;
+    maxBatteryCapacity = config.maxBatteryCapacity;
+    minBatteryCapacity = config.minBatteryCapacity;
+    startingCapacity = config.startingCapacity;
+    minChargeTime = config.minChargeTime;
+    maxChargeTime = config.maxChargeTime;
+    horizonEndTime = config.horizonEndTime;
+    spm = config.method == "SPM";
+    discountFactor = spm ? config.discountFactor : 0.0;
+    windowIndex.build(windows, config.deviationTime, maxChargeTime);
+
+    chargingStation = vector<int>(parameters.numberStations);
+    for(int i = 0; i < parameters.chargingStops.size() && i < chargingStation.size(); i++){
+        chargingStation[i] = parameters.chargingStops[i];
+    }
+    int firstStep = max(1, (int) ceil(config.minChargeTime / timeStep - GRID_TOLERANCE));
+    for(int j = firstStep; j * timeStep <= maxChargeTime + GRID_TOLERANCE; j++){
+        chargeTimes.push_back(j * timeStep);
+    }
+    if(chargeTimes.empty() || chargeTimes.back() < maxChargeTime - GRID_TOLERANCE){
+        chargeTimes.push_back(maxChargeTime);
+    }
+
+    /// the stops at stations without a charger are skipped like in the model, the first arrival of a stop is the
+    /// earliest one, the others are the grid points up to the latest one
+    ModelParameters fleet = parameters;
+    fleet.setLegs(config.busEnergyCost, config.busSpeed);
+    buses = vector<BusGrid>(fleet.numberBuses());
+    for(int n = 0; n < fleet.numberBuses(); n++){
+        BusGrid &bus = buses[n];
+        bus.parameters = fleet.singleBus(n);
+        bus.segments.build(bus.parameters, chargingStation, config.deviationTime, maxChargeTime, true);
+        double consumed = 0.0;
+        for(int s = 0; s < bus.parameters.totalStops(); s++){
+            consumed += bus.parameters.legCost[s];
+            if(!bus.segments.isKept(s)){
+                continue;
+            }
+            double lower = bus.segments.arrivalLower[s];
+            double upper = bus.segments.arrivalUpper[s];
+            vector<double> times{lower};
+            for(long k = (long) floor(lower / timeStep) + 1; k * timeStep <= upper + GRID_TOLERANCE; k++){
+                if(k * timeStep > lower + GRID_TOLERANCE){
+                    times.push_back(k * timeStep);
+                }
+            }
+            vector<int> reachable;
+            if(bus.segments.chargeLimit[s] > 0.0){
+                windowIndex.reachableWindows(bus.parameters.scheduledTimes[s], reachable);
+            }
+            bus.stops.push_back(s);
+            bus.consumed.push_back(consumed);
+            bus.arrivalTimes.push_back(times);
+            bus.reachableWindows.push_back(reachable);
+        }
+    }
+}
+
+int BusChargePlanner::numberBuses() const{
+    return buses.size();
+}
+
+/// the first arrival on the grid which is not earlier than time
+int BusChargePlanner::arrivalIndex(const vector<double> &arrivalTimes, double time) const{
+    return lower_bound(arrivalTimes.begin(), arrivalTimes.end(), time - GRID_TOLERANCE) - arrivalTimes.begin();
+}
+
+/// the clean energy the bus can use from CEW k. The limit is shared by the stops of the bus, so a stop may be planned
+/// with clean energy which an earlier stop already used, it is then counted as non-clean energy by buildPlan
+double BusChargePlanner::windowLimit(const PlanQuery &query, int k) const{
+    double limit = windows[k].availableEnergy;
+    if(!query.windowEnergy.empty()){
+        limit = min(limit, query.windowEnergy[k]);
+    }
+    return max(0.0, limit);
+}
+
+/// the pieces of the cost of a charge at the kept stop p, in increasing order of price. After the end of the horizon
+/// SPM discounts a share of the energy (2.4), so a kWh of clean energy covers more than a kWh of the charge
+void BusChargePlanner::energyPieces(const BusGrid &bus, int p, double arrival, double chargeTime,
+                                    const PlanQuery &query, vector<EnergyPiece> &pieces) const{
+    pieces.clear();
+    double share = spm && arrival >= horizonEndTime ? 1.0 - discountFactor : 1.0;
+    int units = (int) floor(chargeRate * chargeTime / energyStep + GRID_TOLERANCE);
+    for(int k: bus.reachableWindows[p]){
+        double overlap = min(arrival + chargeTime, windows[k].endTime) - max(arrival, windows[k].startTime);
+        double price = query.windowPrices.empty() ? 0.0 : query.windowPrices[k];
+        if(overlap <= 0.0 || price >= 1.0){
+            continue;
+        }
+        /// constraints 3.18, 3.19, 3.23 and 3.27
+        double energy = min(chargeRate * min(overlap, 1.0), windowLimit(query, k));
+        pieces.push_back({share * price, (int) floor(energy / share / energyStep + GRID_TOLERANCE)});
+    }
+    sort(pieces.begin(), pieces.end(), [](const EnergyPiece &a, const EnergyPiece &b){
+        return a.price < b.price;
+    });
+    int used = 0;
+    for(auto &piece: pieces){
+        piece.units = min(piece.units, units - used);
+        used += piece.units;
+    }
+    pieces.push_back({share, units - used});
+}
+
+ChargePlan BusChargePlanner::plan(int n, const PlanQuery &query) const{
+    const BusGrid &bus = buses[n];
+    const StopSegments &segments = bus.segments;
+    int numberKept = bus.stops.size();
+
+    /// level q of kept stop p is the energy charged before it of (offset[p] + q) * energyStep, which leaves the
+    /// battery with the starting capacity plus that energy minus the energy consumed. The levels of a stop are the ones
+    /// which keep the capacity between the minimum and the maximum
+    vector<int> offset(numberKept);
+    vector<int> topLevel(numberKept);
+    int levels = 0;
+    for(int p = 0; p < numberKept; p++){
+        offset[p] = (int) ceil((bus.consumed[p] + minBatteryCapacity - startingCapacity) / energyStep -
+                               GRID_TOLERANCE);
+        topLevel[p] = (int) floor((bus.consumed[p] + maxBatteryCapacity - startingCapacity) / energyStep +
+                                  GRID_TOLERANCE) - offset[p];
+        levels = max(levels, topLevel[p] + 1);
+    }
+    auto capacity = [&](int p, int q){
+        return startingCapacity + (offset[p] + q) * energyStep - bus.consumed[p];
+    };
+    int startLevel = -offset[0];
+
+    /// the sum of the charges has to cover the route (see addConstraints), a bus which needs no energy can not charge
+    double energyNeeded = minBatteryCapacity - startingCapacity;
+    for(int s = 1; s < bus.parameters.totalStops(); s++){
+        energyNeeded += bus.parameters.legCost[s];
+    }
+    bool mayCharge = energyNeeded > 0;
+
+    /// the value of each arrival and level of each kept stop, and the step which reached it
+    vector<vector<double>> value(numberKept);
+    vector<vector<Step>> steps(numberKept);
+    value[0] = vector<double>(levels, INFINITE_BOUND);
+    value[0][startLevel] = 0.0;
+    steps[0] = vector<Step>(levels, Step{-1, -1, -1, 0.0});
+
+    vector<double> charged(levels);
+    vector<double> buffer(levels);
+    vector<int> origin(levels);
+    vector<int> bufferOrigin(levels);
+    vector<int> queue;
+    vector<double> options;
+    vector<EnergyPiece> pieces;
+    for(int p = 0; p < numberKept - 1; p++){
+        int s = bus.stops[p];
+        int next = bus.stops[p + 1];
+        const vector<double> &times = bus.arrivalTimes[p];
+        const vector<double> &nextTimes = bus.arrivalTimes[p + 1];
+        int nextArrivals = nextTimes.size();
+        value[p + 1].assign(nextArrivals * levels, INFINITE_BOUND);
+        steps[p + 1].assign(nextArrivals * levels, Step{-1, -1, -1, 0.0});
+
+        /// leave stop p with the capacities of charged, constraints 3.6 and 3.7 and the deviation of the skipped stops
+        auto depart = [&](int a, double departure, double chargeTime){
+            if(departure > segments.latestDeparture[next] + GRID_TOLERANCE){
+                return;
+            }
+            int nextArrival = arrivalIndex(nextTimes, departure + segments.segmentTime[next]);
+            if(nextArrival >= nextArrivals){
+                return;
+            }
+            double *nextValue = value[p + 1].data() + nextArrival * levels;
+            Step *nextStep = steps[p + 1].data() + nextArrival * levels;
+            for(int r = 0; r <= topLevel[p]; r++){
+                int q = r + offset[p] - offset[p + 1];
+                if(charged[r] >= INFINITE_BOUND || q < 0 || q > topLevel[p + 1]){
+                    continue;
+                }
+                if(charged[r] < nextValue[q]){
+                    nextValue[q] = charged[r];
+                    nextStep[q] = {a, origin[r], r, chargeTime};
+                }
+            }
+        };
+
+        for(int a = 0; a < times.size(); a++){
+            const double *row = value[p].data() + a * levels;
+            if(*min_element(row, row + levels) >= INFINITE_BOUND){
+                continue;
+            }
+            double arrival = times[a];
+            auto resetCharged = [&](){
+                for(int r = 0; r < levels; r++){
+                    charged[r] = row[r];
+                    origin[r] = r;
+                }
+            };
+            resetCharged();
+            depart(a, arrival, 0.0);
+            if(!mayCharge || segments.chargeLimit[s] == 0.0){
+                continue;
+            }
+            /// the charge times of the grid, and the charge until the latest departure, which is seldom on the grid
+            options.clear();
+            double latest = min(segments.departureUpper[s], segments.latestDeparture[next]);
+            for(double chargeTime: chargeTimes){
+                if(arrival + chargeTime > latest + GRID_TOLERANCE){
+                    break;
+                }
+                options.push_back(chargeTime);
+            }
+            double untilLatest = min(latest - arrival, maxChargeTime);
+            if(untilLatest >= minChargeTime - GRID_TOLERANCE && untilLatest > 0.0
+               && (options.empty() || untilLatest > options.back() + GRID_TOLERANCE)){
+                options.push_back(untilLatest);
+            }
+            for(double chargeTime: options){
+                double departure = arrival + chargeTime;
+                bool chargerFree = true;
+                if(!query.busyCharges.empty()){
+                    for(auto &busy: query.busyCharges[s]){
+                        if(departure > busy.first + GRID_TOLERANCE && arrival < busy.second - GRID_TOLERANCE){
+                            chargerFree = false;
+                        }
+                    }
+                }
+                if(!chargerFree){
+                    continue;
+                }
+                energyPieces(bus, p, arrival, chargeTime, query, pieces);
+                resetCharged();
+                for(auto &piece: pieces){
+                    if(piece.units > 0){
+                        addEnergyPiece(charged, origin, buffer, bufferOrigin, queue, topLevel[p], piece.units,
+                                       piece.price * energyStep);
+                    }
+                }
+                double timeCost = query.chargeTimePrices.empty() ? 0.0 : query.chargeTimePrices[s] * chargeTime;
+                for(int r = 0; r <= topLevel[p]; r++){
+                    if(charged[r] < INFINITE_BOUND){
+                        charged[r] += timeCost;
+                    }
+                }
+                depart(a, departure, chargeTime);
+            }
+        }
+
+        /// a fuller battery can drop energy and an earlier bus can wait
+        double *nextValue = value[p + 1].data();
+        Step *nextStep = steps[p + 1].data();
+        for(int a = 0; a < nextArrivals; a++){
+            for(int q = a * levels + levels - 2; q >= a * levels; q--){
+                if(nextValue[q + 1] < nextValue[q]){
+                    nextValue[q] = nextValue[q + 1];
+                    nextStep[q] = nextStep[q + 1];
+                }
+            }
+            for(int q = a * levels; a > 0 && q < (a + 1) * levels; q++){
+                if(nextValue[q - levels] < nextValue[q]){
+                    nextValue[q] = nextValue[q - levels];
+                    nextStep[q] = nextStep[q - levels];
+                }
+            }
+        }
+    }
+
+    /// the earliest arrival at the last stop with the cheapest value, and the fullest battery it is reached with
+    int last = numberKept - 1;
+    int lastArrivals = bus.arrivalTimes[last].size();
+    double best = value[last][(lastArrivals - 1) * levels];
+    if(best >= INFINITE_BOUND){
+        return ChargePlan();
+    }
+    int a = 0;
+    while(value[last][a * levels] > best + GRID_TOLERANCE){
+        a++;
+    }
+    int q = levels - 1;
+    while(value[last][a * levels + q] > best + GRID_TOLERANCE){
+        q--;
+    }
+
+    vector<int> arrival(numberKept);
+    vector<double> capacities(numberKept);
+    vector<double> chargeAmount(numberKept, 0.0);
+    vector<double> chargeTime(numberKept, 0.0);
+    for(int p = last; p >= 0; p--){
+        arrival[p] = a;
+        capacities[p] = p == 0 ? startingCapacity : capacity(p, q);
+        if(p > 0){
+            const Step &step = steps[p][a * levels + q];
+            chargeAmount[p - 1] = (step.departureLevel - step.level) * energyStep;
+            chargeTime[p - 1] = step.chargeTime;
+            a = step.arrival;
+            q = step.level;
+        }
+    }
+    trimCharges(bus, arrival, chargeTime, query, capacities, chargeAmount);
+    return buildPlan(bus, arrival, capacities, chargeAmount, chargeTime, query);
+}
+
+/// the charges are whole energy steps, so the bus usually keeps more than it needs. The most expensive energy of the
+/// charges is cut by what every later stop can spare
+void BusChargePlanner::trimCharges(const BusGrid &bus, const vector<int> &arrival, const vector<double> &chargeTime,
+                                   const PlanQuery &query, vector<double> &capacity,
+                                   vector<double> &chargeAmount) const{
+    int numberKept = bus.stops.size();
+    vector<EnergyPiece> pieces;
+    vector<pair<double, int>> charges;
+    for(int p = 0; p < numberKept - 1; p++){
+        if(chargeTime[p] <= 0.0 || chargeAmount[p] <= 0.0){
+            continue;
+        }
+        /// the price of the last kWh of the charge
+        energyPieces(bus, p, bus.arrivalTimes[p][arrival[p]], chargeTime[p], query, pieces);
+        double energy = 0.0;
+        for(auto &piece: pieces){
+            energy += piece.units * energyStep;
+            if(energy >= chargeAmount[p] - GRID_TOLERANCE){
+                charges.push_back({-piece.price, p});
+                break;
+            }
+        }
+    }
+    sort(charges.begin(), charges.end());
+    for(auto &charge: charges){
+        int p = charge.second;
+        double spare = chargeAmount[p];
+        for(int later = p + 1; later < numberKept; later++){
+            spare = min(spare, capacity[later] - minBatteryCapacity);
+        }
+        if(spare <= 0.0){
+            continue;
+        }
+        chargeAmount[p] -= spare;
+        for(int later = p + 1; later < numberKept; later++){
+            capacity[later] -= spare;
+        }
+    }
+}
+
+/// the schedule of the decisions on the grid. The clean energy of each charge is taken from the cheapest CEW first,
+/// the limits of the query are shared by the stops in order, and the objective is the one of the model
+ChargePlan BusChargePlanner::buildPlan(const BusGrid &bus, const vector<int> &arrival, const vector<double> &capacity,
+                                       const vector<double> &chargeAmount, const vector<double> &chargeTime,
+                                       const PlanQuery &query) const{
+    ChargePlan plan;
+    plan.feasible = true;
+    const ModelParameters &parameters = bus.parameters;
+    primitiveVariables &schedule = plan.schedule;
+    int numberStops = parameters.totalStops();
+    schedule.buses = parameters.busKeys;
+    schedule.stopStart = parameters.stopStart;
+    schedule.chargingStations = chargingStation;
+    schedule.busSequences = parameters.stations;
+    schedule.scheduledTime = parameters.scheduledTimes;
+    schedule.powerExcess = windows;
+    schedule.arrivalTime = vector<double>(numberStops, 0.0);
+    schedule.deviationTime = vector<double>(numberStops, 0.0);
+    schedule.capacity = vector<double>(numberStops, 0.0);
+    schedule.chargeTime = vector<double>(numberStops, 0.0);
+    schedule.chargeAmount = vector<double>(numberStops, 0.0);
+    schedule.nonRenewable = vector<double>(numberStops, 0.0);
+    schedule.charge = vector<int>(numberStops, 0);
+    if(spm){
+        schedule.ases = vector<int>(numberStops, 0);
+        schedule.discounts = vector<double>(numberStops, 0.0);
+    }
+
+    vector<double> windowLeft(windows.size());
+    for(int k = 0; k < windows.size(); k++){
+        windowLeft[k] = windowLimit(query, k);
+    }
+    vector<pair<double, int>> cheapest;
+    for(int p = 0; p < bus.stops.size(); p++){
+        int s = bus.stops[p];
+        double time = bus.arrivalTimes[p][arrival[p]];
+        double duration = chargeTime[p];
+        double energy = chargeAmount[p];
+        schedule.arrivalTime[s] = time;
+        schedule.deviationTime[s] = abs(time - parameters.scheduledTimes[s]);
+        schedule.capacity[s] = capacity[p];
+        schedule.chargeTime[s] = duration;
+        schedule.chargeAmount[s] = energy;
+        schedule.charge[s] = duration > 0.0 ? 1 : 0;
+
+        double share = spm && time >= horizonEndTime ? 1.0 - discountFactor : 1.0;
+        double cleanEnergy = 0.0;
+        cheapest.clear();
+        for(int k: bus.reachableWindows[p]){
+            double price = query.windowPrices.empty() ? 0.0 : query.windowPrices[k];
+            if(duration > 0.0 && price < 1.0){
+                cheapest.push_back({price, k});
+            }
+        }
+        sort(cheapest.begin(), cheapest.end());
+        for(auto &window: cheapest){
+            int k = window.second;
+            double overlap = min(time + duration, windows[k].endTime) - max(time, windows[k].startTime);
+            if(overlap <= 0.0){
+                continue;
+            }
+            double use = min(min(chargeRate * min(overlap, 1.0), share * energy - cleanEnergy), windowLeft[k]);
+            windowLeft[k] -= use;
+            if(use > 0.0){
+                schedule.cleanEnergy.push_back({k, 0, s, use, min(overlap, 1.0), 1});
+                cleanEnergy += use;
+                plan.objectiveValue += window.first * use;
+            }
+        }
+
+        /// ase_bi has to be 1 for arrivals before the end of the horizon, only later charges are discounted
+        double discount = 0.0;
+        if(spm){
+            schedule.ases[s] = time < horizonEndTime ? 1 : 0;
+            discount = schedule.ases[s] == 0 ? min(discountFactor * energy, energy - cleanEnergy) : 0.0;
+            schedule.discounts[s] = discount;
+        }
+        schedule.nonRenewable[s] = max(0.0, energy - cleanEnergy - discount);
+        plan.nonRenewable += schedule.nonRenewable[s];
+        plan.objectiveValue += schedule.nonRenewable[s];
+        if(!query.chargeTimePrices.empty()){
+            plan.objectiveValue += query.chargeTimePrices[s] * duration;
+        }
+    }
+    bus.segments.expand(parameters, schedule, horizonEndTime, spm);
+    return plan;
+}
@@ -0,0 +1,112 @@
+#ifndef SCHEDULER_BUS_CHARGE_PLANNER_H
+#define SCHEDULER_BUS_CHARGE_PLANNER_H
+#include "vector"
+#include "DataStructures.h"
+#include "RunConfig.h"
+#include "StopSegments.h"
+#include "WindowIndex.h"
+
+using namespace std;
+
+/// what a plan is solved for besides the non-clean energy, an empty vector leaves that part of the model unchanged
+struct PlanQuery{
+    /// the price of a kWh of clean energy from each CEW, and of an hour of charge time at each stop of the bus
+    vector<double> windowPrices;
+    vector<double> chargeTimePrices;
+
+    /// the most clean energy the bus may use from each CEW, and for each stop of the bus the start and end of the
+    /// charges of other buses at its charger, which the charge of the bus can not overlap
+    vector<double> windowEnergy;
+    vector<vector<pair<double, double>>> busyCharges;
+};
+
+/// the plan of a single bus
+struct ChargePlan{
+    bool feasible = false;
+
+    /// the objective with the prices of the query, and the non-clean energy alone
+    double objectiveValue = 0.0;
+    double nonRenewable = 0.0;
+
+    /// the schedule of the bus alone (bus index 0), the window of each CleanEnergyUse is an index of the CEW of the
+    /// planner
+    primitiveVariables schedule;
+};
+
+/// Solves the model of a single bus (constraints 3.1-3.9 and 3.16-3.26, and 2.1-2.4 for SPM) without a solver. The
+/// plan is a shortest path over the kept stops of the bus (StopSegments), the state at a stop is the arrival time on
+/// a grid of timeStep hours and the energy charged so far on a grid of energyStep kWh, which gives the exact battery
+/// capacity. The bus may wait and may drop energy (3.6), so an earlier arrival or a fuller battery is never worse,
+/// and each state holds the cheapest way to arrive at that time or earlier with at least that capacity. A charge has
+/// a charge time on the grid or lasts until the latest departure from the stop, and costs its energy at the price of
+/// the CEW it overlaps, up to their clean energy, and at the price of non-clean energy for the rest. Its cost is
+/// piecewise linear in the energy, so the cheapest charge to every capacity is found by a sliding window minimum per
+/// piece. Arrivals are rounded up to the grid, so the plan is feasible for the model and the cheapest one on the grid.
+class BusChargePlanner{
+public:
+    /// parameters holds the buses which can be planned, the windows of the plans are indices of windows
+    BusChargePlanner(const ModelParameters &parameters, const RunConfig &config,
+                     const vector<CleanEnergyWindow> &windows);
+
+    /// the plan of the bus with index n, several buses can be planned at the same time
+    ChargePlan plan(int n, const PlanQuery &query = PlanQuery()) const;
+    int numberBuses() const;
+
+private:
+    /// how a state was reached: the arrival and the energy level at the previous kept stop, the energy level it left
+    /// with and its charge time (0 if it did not charge)
+    struct Step{
+        int arrival;
+        int level;
+        int departureLevel;
+        double chargeTime;
+    };
+
+    /// the kept stops of a bus, the energy used to reach each of them and the arrival times on the grid
+    struct BusGrid{
+        ModelParameters parameters;
+        StopSegments segments;
+        vector<int> stops;
+        vector<double> consumed;
+        vector<vector<double>> arrivalTimes;
+        vector<vector<int>> reachableWindows;
+    };
+
+    /// one piece of the cost of a charge: a price per kWh for up to units energy steps
+    struct EnergyPiece{
+        double price;
+        int units;
+    };
+    double windowLimit(const PlanQuery &query, int k) const;
+    void energyPieces(const BusGrid &bus, int p, double arrival, double chargeTime, const PlanQuery &query,
+                      vector<EnergyPiece> &pieces) const;
+    int arrivalIndex(const vector<double> &arrivalTimes, double time) const;
+    void trimCharges(const BusGrid &bus, const vector<int> &arrival, const vector<double> &chargeTime,
+                     const PlanQuery &query, vector<double> &capacity, vector<double> &chargeAmount) const;
+    ChargePlan buildPlan(const BusGrid &bus, const vector<int> &arrival, const vector<double> &capacity,
+                         const vector<double> &chargeAmount, const vector<double> &chargeTime,
+                         const PlanQuery &query) const;
+
+    vector<BusGrid> buses;
+    vector<CleanEnergyWindow> windows;
+    WindowIndex windowIndex;
+    vector<int> chargingStation;
+
+    /// the charge times of a charging stop with the longest charge maxChargeTime, the grid points from minChargeTime
+    /// on and maxChargeTime itself
+    vector<double> chargeTimes;
+
+    double timeStep;
+    double energyStep;
+    double chargeRate;
+    double maxBatteryCapacity;
+    double minBatteryCapacity;
+    double startingCapacity;
+    double minChargeTime;
+    double maxChargeTime;
+    double horizonEndTime;
+    double discountFactor;
+    bool spm;
+};
+
+#endif //SCHEDULER_BUS_CHARGE_PLANNER_H
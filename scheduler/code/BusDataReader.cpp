@@ -0,0 +1,207 @@
+#include "BusDataReader.h"
+#include "fstream"
+#include "cctype"
+
+using namespace std;
+
+BusDataReader::BusDataReader(ModelParameters &parameters): parameters(parameters){}
+
+bool BusDataReader::read(std::string busDataFile, std::string &error){
+    /// a larger buffer than the default, the parser takes the file one character at a time
+    vector<char> buffer(1 << 20);
+    ifstream file;
+    file.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    file.open(busDataFile, ios::binary);
+    if(!file){
+        error = busDataFile + " can not be opened";
+        return false;
+    }
+    containers.clear();
+    currentKey = KEY_OTHER;
+    errorMessage.clear();
+    bool parsed = json::sax_parse(file, this);
+    error = errorMessage.empty() && !parsed ? busDataFile + " is not a valid bus data file" : errorMessage;
+    return parsed && errorMessage.empty();
+}
+
+/// the container which starts within the current one
+BusDataReader::Container BusDataReader::child(bool object) const{
+    if(containers.empty()){
+        return ROUTES;
+    }
+    switch(containers.back()){
+        case ROUTES:
+            return object ? ROUTE : IGNORED;
+        case ROUTE:
+            return !object && currentKey == KEY_BUSES ? BUSES : IGNORED;
+        case BUSES:
+            return object ? BUS : IGNORED;
+        case BUS:
+            return !object && currentKey == KEY_PATH ? PATH : IGNORED;
+        case PATH:
+            return object ? STOP : IGNORED;
+        default:
+            return IGNORED;
+    }
+}
+
+bool BusDataReader::fail(std::string message){
+    errorMessage = message;
+    return false;
+}
+
+/// any value of rest marks a driver rest, as only the presence of the key is checked
+bool BusDataReader::null(){
+    if(!containers.empty() && containers.back() == STOP && currentKey == KEY_REST){
+        stopRest = 1;
+    }
+    return true;
+}
+
+bool BusDataReader::boolean(bool value){
+    return null();
+}
+
+bool BusDataReader::number_integer(number_integer_t value){
+    return number(value);
+}
+
+bool BusDataReader::number_unsigned(number_unsigned_t value){
+    return number(value);
+}
+
+bool BusDataReader::number_float(number_float_t value, const string_t &text){
+    return number(value);
+}
+
+/// the bus number and the station of a stop, numbers are truncated as they were when converted from the document
+bool BusDataReader::number(double value){
+    if(containers.empty()){
+        return true;
+    }
+    if(containers.back() == BUS && currentKey == KEY_BUS){
+        busNumber = (int) value;
+        hasBusNumber = true;
+    }
+    else if(containers.back() == STOP && currentKey == KEY_STATION_ID){
+        stopStation = (int) value;
+        hasStopStation = true;
+    }
+    return null();
+}
+
+/// the hours and minutes of a time of the form HH:MM, any other form is converted by Utils::convertTime. Both give the
+/// same value for whole minutes
+static bool wholeMinutes(const std::string &time, double &converted){
+    int hours = 0;
+    int minutes = 0;
+    int i = 0;
+    for(; i < time.size() && isdigit(time[i]); i++){
+        hours = hours * 10 + (time[i] - '0');
+    }
+    if(i == 0 || i > 4 || i == time.size() || time[i] != ':' || i + 1 == time.size() || time.size() - i > 5){
+        return false;
+    }
+    for(i++; i < time.size(); i++){
+        if(!isdigit(time[i])){
+            return false;
+        }
+        minutes = minutes * 10 + (time[i] - '0');
+    }
+    converted = hours + (double) minutes / 60;
+    return true;
+}
+
+bool BusDataReader::string(string_t &value){
+    if(!containers.empty() && containers.back() == STOP && currentKey == KEY_TIME){
+        if(!wholeMinutes(value, stopTime)){
+            stopTime = utils.convertTime(value);
+        }
+        hasStopTime = true;
+    }
+    return null();
+}
+
+bool BusDataReader::binary(binary_t &value){
+    return null();
+}
+
+/// the keys are compared once, the values only check the kind of key they belong to
+bool BusDataReader::key(string_t &value){
+    if(value == "time"){
+        currentKey = KEY_TIME;
+    }
+    else if(value == "station_id"){
+        currentKey = KEY_STATION_ID;
+    }
+    else if(value == "rest"){
+        currentKey = KEY_REST;
+    }
+    else if(value == "bus"){
+        currentKey = KEY_BUS;
+    }
+    else if(value == "path"){
+        currentKey = KEY_PATH;
+    }
+    else if(value == "buses"){
+        currentKey = KEY_BUSES;
+    }
+    else{
+        currentKey = KEY_OTHER;
+    }
+    return true;
+}
+
+bool BusDataReader::start_object(size_t elements){
+    null();
+    Container container = child(true);
+    if(container == BUS){
+        hasBusNumber = false;
+    }
+    else if(container == STOP){
+        hasStopTime = false;
+        hasStopStation = false;
+        stopRest = 0;
+    }
+    containers.push_back(container);
+    return true;
+}
+
+bool BusDataReader::end_object(){
+    Container container = containers.back();
+    containers.pop_back();
+    int busStops = parameters.stations.size() - parameters.stopStart.back();
+    if(container == STOP){
+        if(!hasStopTime || !hasStopStation){
+            return fail("stop " + to_string(busStops) + " of bus " + to_string(parameters.busKeys.size()) +
+                        " needs a time and a station_id");
+        }
+        /// a time of 00:00 is the end of the day
+        parameters.scheduledTimes.push_back(stopTime == 0 ? 24.0 : stopTime);
+        parameters.stations.push_back(stopStation);
+        parameters.rests.push_back(stopRest);
+    }
+    else if(container == BUS){
+        if(!hasBusNumber){
+            return fail("bus " + to_string(parameters.busKeys.size()) + " has no bus number");
+        }
+        parameters.busKeys.push_back(busNumber);
+        parameters.stopStart.push_back(parameters.stations.size());
+    }
+    return true;
+}
+
+bool BusDataReader::start_array(size_t elements){
+    null();
+    containers.push_back(child(false));
+    return true;
+}
+
+bool BusDataReader::end_array(){
+    containers.pop_back();
+    return true;
+}
+
+bool BusDataReader::parse_error(size_t position, const std::string &lastToken, const nlohmann::detail::exception &ex){
+    return fail(ex.what());
+}
@@ -0,0 +1,80 @@
+#ifndef SCHEDULER_BUS_DATA_READER_H
+#define SCHEDULER_BUS_DATA_READER_H
+#include "string"
+#include "vector"
+#include <nlohmann/json.hpp>
+#include "DataStructures.h"
+#include "Utils.h"
+
+using namespace std;
+using json = nlohmann::json;
+
+/// Streaming reader of the bus data file. The file is a list of routes, each with a list of buses:
+///     [{"buses": [{"bus": 0, "path": [{"time": "06:00", "station_id": 28, "rest": 1}, ...]}, ...]}, ...]
+/// The stops are appended to the per stop arrays of ModelParameters while the file is parsed, so no document is held in
+/// memory. Keys which are not part of the schedule are skipped.
+class BusDataReader: public nlohmann::json_sax<json>{
+public:
+    explicit BusDataReader(ModelParameters &parameters);
+
+    /// appends the buses of busDataFile to the parameters, error describes the problem if false is returned
+    bool read(std::string busDataFile, std::string &error);
+
+    bool null() override;
+    bool boolean(bool value) override;
+    bool number_integer(number_integer_t value) override;
+    bool number_unsigned(number_unsigned_t value) override;
+    bool number_float(number_float_t value, const string_t &text) override;
+    bool string(string_t &value) override;
+    bool binary(binary_t &value) override;
+    bool start_object(size_t elements) override;
+    bool key(string_t &value) override;
+    bool end_object() override;
+    bool start_array(size_t elements) override;
+    bool end_array() override;
+    bool parse_error(size_t position, const std::string &lastToken, const nlohmann::detail::exception &ex) override;
+
+private:
+    /// the containers of the file which hold a part of the schedule, all others are IGNORED along with their values
+    enum Container{
+        ROUTES,
+        ROUTE,
+        BUSES,
+        BUS,
+        PATH,
+        STOP,
+        IGNORED
+    };
+
+    /// the keys of the schedule
+    enum Key{
+        KEY_BUSES,
+        KEY_BUS,
+        KEY_PATH,
+        KEY_TIME,
+        KEY_STATION_ID,
+        KEY_REST,
+        KEY_OTHER
+    };
+
+    Container child(bool object) const;
+    bool number(double value);
+    bool fail(std::string message);
+
+    ModelParameters &parameters;
+    Utils utils;
+    vector<Container> containers;
+    Key currentKey;
+    std::string errorMessage;
+
+    /// the bus and the stop being read
+    int busNumber;
+    bool hasBusNumber;
+    double stopTime;
+    int stopStation;
+    bool hasStopTime;
+    bool hasStopStation;
+    int stopRest;
+};
+
+#endif //SCHEDULER_BUS_DATA_READER_H
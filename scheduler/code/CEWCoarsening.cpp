@@ -0,0 +1,161 @@
+#include "CEWCoarsening.h"
+#include "algorithm"
+#include "cmath"
+#include "numeric"
+#include "queue"
+#include "tuple"
+
+using namespace std;
+
+CEWCoarsening::CEWCoarsening(const vector<CleanEnergyWindow> &windows, double chargeRate, int chargers,
+                             double tolerance): windows(windows){
+    int numberWindows = windows.size();
+    vector<int> order(numberWindows);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&windows](int a, int b){
+        return windows[a].startTime < windows[b].startTime;
+    });
+
+    /// a group is named by its first position in order and holds the positions up to next of it
+    vector<double> energy(numberWindows), slack(numberWindows), minEnergy(numberWindows), endTime(numberWindows);
+    vector<double> groupBound(numberWindows, 0.0);
+    vector<int> next(numberWindows), previous(numberWindows), version(numberWindows, 0);
+    double budget = 0.0;
+    for(int p = 0; p < numberWindows; p++){
+        const CleanEnergyWindow &window = windows[order[p]];
+        energy[p] = window.availableEnergy;
+        minEnergy[p] = window.availableEnergy;
+        slack[p] = max(0.0, chargers * chargeRate * (window.endTime - window.startTime) - window.availableEnergy);
+        endTime[p] = window.endTime;
+        next[p] = p + 1;
+        previous[p] = p - 1;
+        budget += window.availableEnergy;
+    }
+    budget *= tolerance;
+
+    auto mergedBound = [&](int a, int b){
+        return min(slack[a] + slack[b], energy[a] + energy[b] - min(minEnergy[a], minEnergy[b]));
+    };
+
+    /// the growth of the bound of merging a group with the next one, with the versions of both groups, a merge
+    /// changes the versions so the candidates of the old groups are skipped
+    using Candidate = tuple<double, int, int, int, int>;
+    priority_queue<Candidate, vector<Candidate>, greater<Candidate>> candidates;
+    auto addCandidate = [&](int a){
+        if(a < 0 || next[a] >= numberWindows || abs(endTime[a] - windows[order[next[a]]].startTime) > 1e-9){
+            return;
+        }
+        int b = next[a];
+        candidates.push({mergedBound(a, b) - groupBound[a] - groupBound[b], a, b, version[a], version[b]});
+    };
+    for(int p = 0; p < numberWindows; p++){
+        addCandidate(p);
+    }
+
+    while(!candidates.empty()){
+        auto [growth, a, b, versionA, versionB] = candidates.top();
+        candidates.pop();
+        if(version[a] != versionA || version[b] != versionB){
+            continue;
+        }
+        /// the valid candidates are all in the queue, so no other merge fits either
+        if(bound + growth > budget + 1e-9){
+            break;
+        }
+        bound += growth;
+        groupBound[a] = mergedBound(a, b);
+        energy[a] += energy[b];
+        slack[a] += slack[b];
+        minEnergy[a] = min(minEnergy[a], minEnergy[b]);
+        endTime[a] = endTime[b];
+        next[a] = next[b];
+        if(next[b] < numberWindows){
+            previous[next[b]] = a;
+        }
+        version[a]++;
+        version[b]++;
+        addCandidate(previous[a]);
+        addCandidate(a);
+    }
+
+    for(int p = 0; p < numberWindows; p = next[p]){
+        coarse.push_back(CleanEnergyWindow{.startTime=windows[order[p]].startTime, .endTime=endTime[p],
+                                           .availableEnergy=energy[p]});
+        groups.push_back(vector<int>(order.begin() + p, order.begin() + next[p]));
+    }
+}
+
+const vector<CleanEnergyWindow> &CEWCoarsening::coarseWindows() const{
+    return coarse;
+}
+
+double CEWCoarsening::errorBound() const{
+    return bound;
+}
+
+/// the schedule may only hold the windows its model used, so its windows are found by their start
+int CEWCoarsening::coarseWindow(const CleanEnergyWindow &window) const{
+    auto position = lower_bound(coarse.begin(), coarse.end(), window.startTime - 1e-9,
+                                [](const CleanEnergyWindow &coarseWindow, double startTime){
+        return coarseWindow.startTime < startTime;
+    });
+    if(position == coarse.end() || abs(position->startTime - window.startTime) > 1e-9){
+        return -1;
+    }
+    return position - coarse.begin();
+}
+
+primitiveVariables CEWCoarsening::refine(const primitiveVariables &schedule, const RunConfig &config) const{
+    primitiveVariables refined = schedule;
+    refined.cleanEnergy.clear();
+    refined.powerExcess = windows;
+    bool spm = config.method == "SPM" && !schedule.ases.empty();
+    vector<double> windowRemaining;
+    for(auto &window: windows){
+        windowRemaining.push_back(window.availableEnergy);
+    }
+
+    /// the clean energy a stop takes from a coarse window is taken from the windows of the group in order, the stops
+    /// are served in order of their arrival
+    vector<CleanEnergyUse> uses = schedule.cleanEnergy;
+    stable_sort(uses.begin(), uses.end(), [&schedule](const CleanEnergyUse &a, const CleanEnergyUse &b){
+        return schedule.arrivalTime[schedule.stopStart[a.bus] + a.stop] <
+               schedule.arrivalTime[schedule.stopStart[b.bus] + b.stop];
+    });
+    vector<double> cleanEnergy(schedule.arrivalTime.size(), 0.0);
+    for(auto &use: uses){
+        int s = schedule.stopStart[use.bus] + use.stop;
+        int group = coarseWindow(schedule.powerExcess[use.window]);
+        if(schedule.charge[s] != 1 || group < 0){
+            continue;
+        }
+        double start = schedule.arrivalTime[s];
+        double end = start + schedule.chargeTime[s];
+        double wanted = use.energy;
+        for(int k: groups[group]){
+            double overlap = min(end, windows[k].endTime) - max(start, windows[k].startTime);
+            if(overlap <= 0){
+                continue;
+            }
+            double energy = max(0.0, min(overlap * config.chargeRate, min(windowRemaining[k], wanted)));
+            refined.cleanEnergy.push_back({k, use.bus, use.stop, energy, overlap, 1});
+            windowRemaining[k] -= energy;
+            wanted -= energy;
+            cleanEnergy[s] += energy;
+        }
+    }
+
+    for(int s = 0; s < schedule.charge.size(); s++){
+        if(schedule.charge[s] != 1){
+            continue;
+        }
+        double amount = schedule.chargeAmount[s];
+        double discount = 0.0;
+        if(spm && schedule.ases[s] == 0){
+            discount = max(0.0, min(config.discountFactor * amount, amount - cleanEnergy[s]));
+            refined.discounts[s] = discount;
+        }
+        refined.nonRenewable[s] = max(0.0, amount - cleanEnergy[s] - discount);
+    }
+    return refined;
+}
@@ -0,0 +1,44 @@
+#ifndef SCHEDULER_CEW_COARSENING_H
+#define SCHEDULER_CEW_COARSENING_H
+#include "vector"
+#include "DataStructures.h"
+#include "RunConfig.h"
+
+using namespace std;
+
+/// Merges adjacent CEW into coarser windows, so the model has fewer CEW columns and rows (constraints 3.16-3.27). A
+/// merged window holds the energy of its windows, which a charge in any part of it can use, so the model with the
+/// merged windows is a relaxation of the model with the original ones and its objective is never higher. A set of
+/// charges can use at most chargers * chargeRate * d_k of the energy E_k of a window of length d_k, so a merge can
+/// give them at most min(sum_k max(0, chargers * chargeRate * d_k - E_k), sum_k E_k - min_k E_k) more clean energy.
+/// The merges with the smallest growth of this bound are taken first, until the sum of the bounds of the merged
+/// windows would exceed tolerance times the clean energy of all windows. Windows which all chargers together can not
+/// empty merge without error. Windows with a gap between them, such as the windows without energy Parser drops, are
+/// not merged.
+class CEWCoarsening{
+public:
+    CEWCoarsening() = default;
+    CEWCoarsening(const vector<CleanEnergyWindow> &windows, double chargeRate, int chargers, double tolerance);
+
+    const vector<CleanEnergyWindow> &coarseWindows() const;
+
+    /// the largest amount of clean energy the coarse windows can add to a schedule, which bounds the difference of
+    /// the objectives of the coarse and the original model
+    double errorBound() const;
+
+    /// the schedule of the coarse windows as a schedule of the original windows. The clean energy a stop uses from
+    /// a coarse window is taken from the windows of the coarse window it overlaps, as far as they have energy left
+    /// when the stops are served in order of their arrival, the rest becomes non-clean energy
+    primitiveVariables refine(const primitiveVariables &schedule, const RunConfig &config) const;
+
+private:
+    int coarseWindow(const CleanEnergyWindow &window) const;
+
+    vector<CleanEnergyWindow> windows;
+    vector<CleanEnergyWindow> coarse;
+    /// the original windows of each coarse window, in order of time
+    vector<vector<int>> groups;
+    double bound = 0.0;
+};
+
+#endif //SCHEDULER_CEW_COARSENING_H
@@ -0,0 +1,162 @@
+#include "CEWStore.h"
+#include "Parser.h"
+#include "fstream"
+#include "cstring"
+#include "algorithm"
+#include "filesystem"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const char storeMagic[8] = {'E', 'B', 'U', 'S', 'C', 'E', 'W', '\0'};
+
+bool CEWStore::compile(string folder, string storeFile, long &numberFiles, string &error){
+    error.clear();
+    numberFiles = 0;
+    if(!filesystem::is_directory(folder)){
+        error = folder + " is not a folder";
+        return false;
+    }
+    vector<pair<string, vector<CleanEnergyWindow>>> files;
+    Parser parser;
+    for(auto &file: filesystem::recursive_directory_iterator(folder)){
+        if(!file.is_regular_file() || file.path().extension() != ".txt"){
+            continue;
+        }
+        filesystem::path relative = filesystem::relative(file.path(), folder);
+        string key = relative.replace_extension("").generic_string();
+        if(key.size() >= sizeof(CEWStoreEntry::key)){
+            error = key + " is longer than the " + to_string(sizeof(CEWStoreEntry::key) - 1) + " characters of a key";
+            return false;
+        }
+        vector<CleanEnergyWindow> windows;
+        if(!Parser::splitCleanEnergyWindows(parser.readCEWFile(file.path().string()), windows, error)){
+            error = file.path().string() + ": " + error;
+            return false;
+        }
+        files.push_back({key, windows});
+    }
+    sort(files.begin(), files.end(), [](const auto &a, const auto &b){
+        return a.first < b.first;
+    });
+
+    vector<CEWStoreEntry> directory(files.size());
+    vector<CleanEnergyWindow> windows;
+    for(int e = 0; e < files.size(); e++){
+        CEWStoreEntry &entry = directory[e];
+        memset(entry.key, 0, sizeof(entry.key));
+        memcpy(entry.key, files[e].first.data(), files[e].first.size());
+        entry.firstWindow = windows.size();
+        entry.numberWindows = files[e].second.size();
+        windows.insert(windows.end(), files[e].second.begin(), files[e].second.end());
+    }
+
+    CEWStoreHeader header;
+    memcpy(header.magic, storeMagic, sizeof(storeMagic));
+    header.version = version;
+    header.numberEntries = directory.size();
+    header.fileSize = sizeof(header) + directory.size() * sizeof(CEWStoreEntry) +
+                      windows.size() * sizeof(CleanEnergyWindow);
+    ofstream file(storeFile, ios::binary);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(directory.data()), directory.size() * sizeof(CEWStoreEntry));
+    file.write(reinterpret_cast<const char *>(windows.data()), windows.size() * sizeof(CleanEnergyWindow));
+    if(!file){
+        error = storeFile + " can not be written";
+        return false;
+    }
+    numberFiles = files.size();
+    return true;
+}
+
+CEWStore::~CEWStore(){
+    close();
+}
+
+void CEWStore::close(){
+    if(data != nullptr){
+        munmap((void *) data, size);
+    }
+    data = nullptr;
+    size = 0;
+}
+
+bool CEWStore::open(string storeFile, string &error){
+    close();
+    error.clear();
+    int descriptor = ::open(storeFile.c_str(), O_RDONLY);
+    if(descriptor < 0){
+        error = storeFile + " can not be opened";
+        return false;
+    }
+    struct stat status;
+    if(fstat(descriptor, &status) != 0 || status.st_size < (off_t) sizeof(CEWStoreHeader)){
+        ::close(descriptor);
+        error = storeFile + " is too small to be a CEW store";
+        return false;
+    }
+    void *mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if(mapping == MAP_FAILED){
+        error = storeFile + " can not be mapped";
+        return false;
+    }
+    data = static_cast<const char *>(mapping);
+    size = status.st_size;
+
+    const CEWStoreHeader *header = reinterpret_cast<const CEWStoreHeader *>(data);
+    uint64_t windowsStart = sizeof(CEWStoreHeader) + (uint64_t) header->numberEntries * sizeof(CEWStoreEntry);
+    if(memcmp(header->magic, storeMagic, sizeof(storeMagic)) != 0){
+        error = storeFile + " is not a CEW store";
+    }
+    else if(header->version == 0 || header->version > version){
+        error = storeFile + " has store version " + to_string(header->version) + ", only versions up to " +
+                to_string(version) + " can be read";
+    }
+    else if(header->fileSize != size || windowsStart > size){
+        error = storeFile + " is truncated";
+    }
+    for(int e = 0; error.empty() && e < header->numberEntries; e++){
+        const CEWStoreEntry &entry = entries()[e];
+        uint64_t numberWindows = (size - windowsStart) / sizeof(CleanEnergyWindow);
+        if(entry.key[sizeof(entry.key) - 1] != '\0' || entry.firstWindow > numberWindows ||
+           entry.numberWindows > numberWindows - entry.firstWindow){
+            error = storeFile + " has a corrupt entry " + to_string(e);
+        }
+    }
+    if(!error.empty()){
+        close();
+        return false;
+    }
+    return true;
+}
+
+const CEWStoreEntry *CEWStore::entries() const{
+    return reinterpret_cast<const CEWStoreEntry *>(data + sizeof(CEWStoreHeader));
+}
+
+int CEWStore::numberEntries() const{
+    return data == nullptr ? 0 : reinterpret_cast<const CEWStoreHeader *>(data)->numberEntries;
+}
+
+string CEWStore::key(int entry) const{
+    return entries()[entry].key;
+}
+
+bool CEWStore::windows(string key, vector<CleanEnergyWindow> &windows) const{
+    const CEWStoreEntry *first = entries();
+    const CEWStoreEntry *last = first + numberEntries();
+    const CEWStoreEntry *entry = lower_bound(first, last, key, [](const CEWStoreEntry &entry, const string &key){
+        return strcmp(entry.key, key.c_str()) < 0;
+    });
+    if(entry == last || key != entry->key){
+        return false;
+    }
+    const CleanEnergyWindow *storeWindows = reinterpret_cast<const CleanEnergyWindow *>(
+            data + sizeof(CEWStoreHeader) + numberEntries() * sizeof(CEWStoreEntry));
+    windows.assign(storeWindows + entry->firstWindow, storeWindows + entry->firstWindow + entry->numberWindows);
+    return true;
+}
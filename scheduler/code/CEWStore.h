@@ -0,0 +1,61 @@
+#ifndef SCHEDULER_CEW_STORE_H
+#define SCHEDULER_CEW_STORE_H
+#include "string"
+#include "vector"
+#include "cstdint"
+#include "DataStructures.h"
+
+using namespace std;
+
+/// the start of every store
+struct CEWStoreHeader{
+    char magic[8];
+    uint32_t version;
+    uint32_t numberEntries;
+    uint64_t fileSize;
+};
+
+/// the CEW of one key, the windows are numberWindows CleanEnergyWindow starting at index firstWindow of the windows
+/// of the store. The key is padded with '\0'
+struct CEWStoreEntry{
+    char key[48];
+    uint64_t firstWindow;
+    uint64_t numberWindows;
+};
+
+/// The CEW of a folder of CEW files in one binary file. The key of a file is its path below the folder without
+/// ".txt", e.g. predicted/MPM/2022-2-14-6 for the datatype, method, date and hour of the layout of the CEW folders.
+/// The entries are sorted by key and followed by the windows of all entries, the file is little endian and read
+/// through a memory mapping, so a lookup is a binary search without a parse pass. The windows hold the energy of the
+/// files, before the power ratio is applied and with the windows without energy.
+class CEWStore{
+public:
+    static const uint32_t version = 1;
+
+    CEWStore() = default;
+    ~CEWStore();
+    CEWStore(const CEWStore &) = delete;
+    CEWStore &operator=(const CEWStore &) = delete;
+
+    /// writes the CEW of every .txt file below folder to storeFile, numberFiles is the number of files. error
+    /// describes the problem if false is returned
+    static bool compile(string folder, string storeFile, long &numberFiles, string &error);
+
+    /// maps the file and checks that every entry lies within it, error describes the problem if false is returned
+    bool open(string storeFile, string &error);
+    void close();
+
+    int numberEntries() const;
+    string key(int entry) const;
+
+    /// the windows of key, false if the store has no such key
+    bool windows(string key, vector<CleanEnergyWindow> &windows) const;
+
+private:
+    const CEWStoreEntry *entries() const;
+
+    const char *data = nullptr;
+    uint64_t size = 0;
+};
+
+#endif //SCHEDULER_CEW_STORE_H
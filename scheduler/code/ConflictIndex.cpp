@@ -0,0 +1,70 @@
+#include "ConflictIndex.h"
+#include "algorithm"
+#include "cmath"
+
+using namespace std;
+
+/// group the visits of every bus by station and sort each group by scheduled arrival time
+void ConflictIndex::build(const vector<int> &stopStart, const vector<int> &stations, const vector<double> &times){
+    stationVisits.clear();
+    for(int busIndex = 0; busIndex + 1 < stopStart.size(); busIndex++){
+        for(int s = stopStart[busIndex]; s < stopStart[busIndex + 1]; s++){
+            if(stations[s] >= stationVisits.size()){
+                stationVisits.resize(stations[s] + 1);
+            }
+            stationVisits[stations[s]].push_back(StationVisit{times[s], busIndex, s - stopStart[busIndex]});
+        }
+    }
+    for(auto &visits: stationVisits){
+        sort(visits.begin(), visits.end(), [](const StationVisit &a, const StationVisit &b){
+            return a.time < b.time;
+        });
+    }
+}
+
+/// sweep over the sorted visits of each station and return every pair of different buses whose scheduled arrivals
+/// are at most window apart. Pairs are ordered as the original bus/stop loop would have created them.
+vector<ConflictPair> ConflictIndex::candidatePairs(double window) const{
+    vector<ConflictPair> pairs;
+    for(auto &visits: stationVisits){
+        for(int first = 0; first < visits.size(); first++){
+            for(int second = first + 1; second < visits.size(); second++){
+                if(abs(visits[second].time - visits[first].time) > window){
+                    break;
+                }
+                if(visits[first].busIndex == visits[second].busIndex){
+                    continue;
+                }
+                if(visits[first].busIndex < visits[second].busIndex){
+                    pairs.push_back(ConflictPair{visits[first].busIndex, visits[first].stop,
+                                                 visits[second].busIndex, visits[second].stop});
+                }
+                else{
+                    pairs.push_back(ConflictPair{visits[second].busIndex, visits[second].stop,
+                                                 visits[first].busIndex, visits[first].stop});
+                }
+            }
+        }
+    }
+    sort(pairs.begin(), pairs.end(), [](const ConflictPair &a, const ConflictPair &b){
+        if(a.busIndex != b.busIndex){
+            return a.busIndex < b.busIndex;
+        }
+        if(a.otherBusIndex != b.otherBusIndex){
+            return a.otherBusIndex < b.otherBusIndex;
+        }
+        if(a.stop != b.stop){
+            return a.stop < b.stop;
+        }
+        return a.otherStop < b.otherStop;
+    });
+    return pairs;
+}
+
+int ConflictIndex::numberVisits() const{
+    int visits = 0;
+    for(auto &station: stationVisits){
+        visits += station.size();
+    }
+    return visits;
+}
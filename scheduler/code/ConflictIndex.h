@@ -0,0 +1,35 @@
+#ifndef SCHEDULER_CONFLICT_INDEX_H
+#define SCHEDULER_CONFLICT_INDEX_H
+#include "vector"
+#include "map"
+
+using namespace std;
+
+/// a scheduled visit of bus (busIndex) to a station at its stop (stop)
+struct StationVisit{
+    double time;
+    int busIndex;
+    int stop;
+};
+
+/// two visits of different buses to the same station which could overlap when charging (constraints 3.10-3.15)
+struct ConflictPair{
+    int busIndex;
+    int stop;
+    int otherBusIndex;
+    int otherStop;
+};
+
+/// per-station index of scheduled arrivals sorted by time, used to find buses which may share a charger.
+class ConflictIndex{
+public:
+    /// the stops of bus index n are stopStart[n] to stopStart[n + 1] - 1 of stations and times
+    void build(const vector<int> &stopStart, const vector<int> &stations, const vector<double> &times);
+    vector<ConflictPair> candidatePairs(double window) const;
+    int numberVisits() const;
+
+private:
+    vector<vector<StationVisit>> stationVisits;
+};
+
+#endif //SCHEDULER_CONFLICT_INDEX_H
@@ -0,0 +1,229 @@
+#include "CplexBackend.h"
+#include "iostream"
+#include "fstream"
+#include "cmath"
+
+ILOSTLBEGIN
+using namespace std;
+
+/// CPLEX uses IloInfinity rather than IEEE infinity for unbounded columns and rows
+static IloNum cplexBound(double value){
+    if(isinf(value)){
+        return value > 0 ? IloInfinity : -IloInfinity;
+    }
+    return value;
+}
+
+CplexBackend::CplexBackend(): model(env), columns(env), rows(env){}
+
+CplexBackend::~CplexBackend(){
+    env.end();
+}
+
+string CplexBackend::name() const{
+    return "cplex";
+}
+
+void CplexBackend::loadModel(const ModelIR &ir){
+    try{
+        objective = IloMinimize(env);
+        model.add(objective);
+        addColumnsAndRows(ir);
+    }
+    catch (IloException &e) {
+        cerr << "Concert exception caught:" << e << endl;
+    }
+}
+
+void CplexBackend::updateModel(const ModelIR &ir, const ModelChanges &changes){
+    try{
+        for(int c: changes.columns){
+            if(c < columns.getSize()){
+                columns[c].setBounds(cplexBound(ir.columnLower[c]), cplexBound(ir.columnUpper[c]));
+            }
+        }
+        for(int r: changes.rows){
+            if(r < rows.getSize()){
+                rows[r].setBounds(cplexBound(ir.rowLower[r]), cplexBound(ir.rowUpper[r]));
+                /// the range of an indicator row is only read when the IloIfThen is extracted, so it is replaced
+                if(ir.isIndicatorRow(r)){
+                    model.remove(indicators[r]);
+                    indicators[r].end();
+                    addIndicator(ir, r);
+                }
+            }
+        }
+        addColumnsAndRows(ir);
+    }
+    catch (IloException &e) {
+        cerr << "Concert exception caught:" << e << endl;
+    }
+}
+
+/// add the columns and rows of the ModelIR which are not part of the CPLEX model yet
+void CplexBackend::addColumnsAndRows(const ModelIR &ir){
+    int firstColumn = columns.getSize();
+    int firstRow = rows.getSize();
+
+    IloNumVarArray newColumns(env);
+    IloNumArray newObjective(env);
+    for(int c = firstColumn; c < ir.numberColumns(); c++){
+        newColumns.add(IloNumVar(env, cplexBound(ir.columnLower[c]), cplexBound(ir.columnUpper[c]),
+                                 ir.columnType[c] == INTEGER ? ILOINT : ILOFLOAT, ir.columnNames[c].c_str()));
+        newObjective.add(ir.objective[c]);
+    }
+    columns.add(newColumns);
+    objective.setLinearCoefs(newColumns, newObjective);
+
+    IloNumArray rowLower(env, ir.numberRows() - firstRow);
+    IloNumArray rowUpper(env, ir.numberRows() - firstRow);
+    for(int r = firstRow; r < ir.numberRows(); r++){
+        rowLower[r - firstRow] = cplexBound(ir.rowLower[r]);
+        rowUpper[r - firstRow] = cplexBound(ir.rowUpper[r]);
+    }
+    IloRangeArray newRows(env, rowLower, rowUpper);
+
+    /// the coefficients of each row are set in one call, reusing the same arrays for every row
+    IloNumVarArray rowColumns(env);
+    IloNumArray rowValues(env);
+    for(int r = firstRow; r < ir.numberRows(); r++){
+        rowColumns.clear();
+        rowValues.clear();
+        for(int p = ir.rowStart[r]; p < ir.rowStart[r + 1]; p++){
+            rowColumns.add(columns[ir.rowIndex[p]]);
+            rowValues.add(ir.rowValue[p]);
+        }
+        newRows[r - firstRow].setLinearCoefs(rowColumns, rowValues);
+        if(!ir.rowNames[r].empty()){
+            newRows[r - firstRow].setName(ir.rowNames[r].c_str());
+        }
+    }
+    rows.add(newRows);
+    model.add(newColumns);
+
+    /// indicator rows are added through an IloIfThen instead of as a range
+    IloRangeArray linearRows(env);
+    indicators.resize(ir.numberRows());
+    for(int r = firstRow; r < ir.numberRows(); r++){
+        if(ir.isIndicatorRow(r)){
+            addIndicator(ir, r);
+        }
+        else{
+            linearRows.add(newRows[r - firstRow]);
+        }
+    }
+    model.add(linearRows);
+
+    rowColumns.end();
+    rowValues.end();
+    newObjective.end();
+    rowLower.end();
+    rowUpper.end();
+    linearRows.end();
+}
+
+/// the range of the row only has to hold while the indicator column has its value
+void CplexBackend::addIndicator(const ModelIR &ir, int row){
+    IloConstraint active = columns[ir.rowIndicator[row]] == (IloNum) ir.rowIndicatorValue[row];
+    indicators[row] = IloIfThen(env, active, rows[row]);
+    model.add(indicators[row]);
+}
+
+bool CplexBackend::supportsIndicatorRows() const{
+    return true;
+}
+
+void CplexBackend::setMIPStart(const vector<double> &values){
+    startValues = values;
+}
+
+SolverResult CplexBackend::solve(const SolverSettings &settings){
+    SolverResult result;
+    try{
+        /// the model is only extracted for the first solve, afterwards CPLEX is notified of every change
+        if(cplex.getImpl() == 0){
+            cplex = IloCplex(model);
+        }
+
+        /// use a warming solution if one is available.
+        ifstream f(settings.warmingSolutionFile.c_str());
+        if(f.good()){
+            cout << "Previous solution file found. Using solution warming" << endl;
+            cplex.readSolution(settings.warmingSolutionFile.c_str());
+        }
+        else{
+            cout << "No previous solution file found" << endl;
+        }
+        f.close();
+
+        /// hand over the starting solution from the heuristic or the previous solve, CPLEX repairs it if it is not
+        /// feasible
+        if(cplex.getNMIPStarts() > 0){
+            cplex.deleteMIPStarts(0, cplex.getNMIPStarts());
+        }
+        if(!startValues.empty()){
+            IloNumArray start(env, startValues.size());
+            for(int c = 0; c < startValues.size(); c++){
+                start[c] = startValues[c];
+            }
+            cplex.addMIPStart(columns, start, IloCplex::MIPStartRepair, "start");
+            start.end();
+        }
+
+        /// set some parameters for CPLEX.
+        cplex.setParam(IloCplex::Param::MIP::Display, 3);
+        if(settings.exactIntegrality){
+            cplex.setParam(IloCplex::Param::MIP::Tolerances::Integrality, 0.0);
+        }
+
+        /// set some conditions for ending search early
+        if(settings.maxSolutions > 0){
+            cplex.setParam(IloCplex::Param::MIP::Limits::Solutions, settings.maxSolutions);
+        }
+        if(settings.timeout > 0){
+            cplex.setParam(IloCplex::Param::TimeLimit, settings.timeout);
+        }
+        if(settings.threads > 0){
+            cplex.setParam(IloCplex::Param::Threads, settings.threads);
+        }
+
+        /// save the infromation about the search process into a logFile
+        ofstream myFile;
+        if(!settings.logFile.empty()){
+            myFile.open(settings.logFile);
+            cplex.setOut(myFile);
+        }
+
+        /// begin the search process
+        if (!cplex.solve()) {
+            cout << cplex.getCplexStatus() << endl;
+            env.error() << "ERROR FAILED TO SOLVE" << endl;
+        } else {
+            IloNumArray values(env);
+            cplex.getValues(values, columns);
+            result.values.resize(values.getSize());
+            for(int c = 0; c < values.getSize(); c++){
+                result.values[c] = values[c];
+            }
+            values.end();
+
+            result.solved = true;
+            result.objectiveValue = cplex.getObjValue();
+            result.relativeGap = cplex.getMIPRelativeGap();
+
+            /// write the solution into a LP file. This LP file can then be loaded to be used as a warming solution laer.
+            if(!settings.solutionFile.empty()){
+                cplex.writeSolution(settings.solutionFile.c_str());
+            }
+        }
+        result.status = to_string(cplex.getStatus());
+        if(!settings.logFile.empty()){
+            cplex.setOut(env.out());
+            myFile.close();
+        }
+    }
+    catch (IloException &e) {
+        cerr << "Concert exception caught:" << e << endl;
+    }
+    return result;
+}
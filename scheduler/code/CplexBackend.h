@@ -0,0 +1,39 @@
+#ifndef SCHEDULER_CPLEX_BACKEND_H
+#define SCHEDULER_CPLEX_BACKEND_H
+#include <ilcplex/ilocplex.h>
+#include "SolverBackend.h"
+
+using namespace std;
+
+/// loads a ModelIR into CPLEX in bulk, creating all columns and ranges before they are added to the model. Later
+/// changes to the ModelIR are applied to the loaded model, so it can be solved again without being rebuilt
+class CplexBackend: public SolverBackend{
+public:
+    CplexBackend();
+    ~CplexBackend() override;
+    string name() const override;
+    void loadModel(const ModelIR &model) override;
+    void updateModel(const ModelIR &model, const ModelChanges &changes) override;
+    void setMIPStart(const vector<double> &values) override;
+    bool supportsIndicatorRows() const override;
+    SolverResult solve(const SolverSettings &settings) override;
+
+private:
+    void addColumnsAndRows(const ModelIR &ir);
+    void addIndicator(const ModelIR &ir, int row);
+
+    IloEnv env;
+    IloModel model;
+    IloNumVarArray columns;
+    IloRangeArray rows;
+    IloObjective objective;
+
+    /// the IloIfThen which holds the range of each indicator row, empty handles for the other rows
+    vector<IloConstraint> indicators;
+
+    /// kept between solves, so a changed model is solved without extracting it again
+    IloCplex cplex;
+    vector<double> startValues;
+};
+
+#endif //SCHEDULER_CPLEX_BACKEND_H
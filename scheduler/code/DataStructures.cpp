@@ -1,6 +1,167 @@
 #include "DataStructures.h"
+#include "algorithm"
 
 
-struct CleanEnergyWindow;
-struct Arguments;
-struct primitiveVariables;
+/// the leg constants use the same rules as constraints 3.6 and 3.7
+void ModelParameters::setLegs(double busEnergyCost, double busSpeed){
+    TripCost tripCost{distances, busEnergyCost};
+    TripTime tripTime{distances, busSpeed};
+    legCost = vector<double>(totalStops(), 0.0);
+    legTime = vector<double>(totalStops(), 0.0);
+    for(int n = 0; n < numberBuses(); n++){
+        for(int s = stopStart[n] + 1; s < stopStart[n + 1]; s++){
+            legCost[s] = tripCost(stations[s], stations[s - 1]);
+            legTime[s] = min(scheduledTimes[s] - scheduledTimes[s - 1], tripTime(stations[s], stations[s - 1]));
+        }
+    }
+}
+
+ModelParameters ModelParameters::singleBus(int n) const{
+    int first = stopStart[n];
+    int end = stopStart[n + 1];
+    ModelParameters bus;
+    bus.chargingStops = chargingStops;
+    bus.cleanEnergyWindows = cleanEnergyWindows;
+    bus.numberStations = numberStations;
+    bus.distances = distances;
+    bus.busKeys = {busKeys[n]};
+    bus.stopStart = {0, end - first};
+    bus.stations.assign(stations.begin() + first, stations.begin() + end);
+    bus.scheduledTimes.assign(scheduledTimes.begin() + first, scheduledTimes.begin() + end);
+    bus.rests.assign(rests.begin() + first, rests.begin() + end);
+    if(legCost.size() == totalStops()){
+        bus.legCost.assign(legCost.begin() + first, legCost.begin() + end);
+        bus.legTime.assign(legTime.begin() + first, legTime.begin() + end);
+    }
+    return bus;
+}
+
+map<int, int> primitiveVariables::busIndices() const{
+    map<int, int> indices;
+    for(int n = 0; n < buses.size(); n++){
+        indices[buses[n]] = n;
+    }
+    return indices;
+}
+
+/// appends the values of every bus in the order of buses, a field which is not part of the nested solution stays empty
+template <class T>
+static void flattenField(const vector<int> &buses, const vector<int> &stopStart, const map<int, vector<T>> &nested,
+                         vector<T> &flat){
+    if(nested.empty()){
+        return;
+    }
+    flat = vector<T>(stopStart.back(), T());
+    for(int n = 0; n < buses.size(); n++){
+        auto values = nested.find(buses[n]);
+        if(values != nested.end()){
+            copy_n(values->second.begin(), min((int) values->second.size(), stopStart[n + 1] - stopStart[n]),
+                   flat.begin() + stopStart[n]);
+        }
+    }
+}
+
+primitiveVariables flattenVariables(const nestedVariables &nested){
+    primitiveVariables flat;
+    flat.buses = nested.buses;
+    if(flat.buses.empty()){
+        for(auto &bus: nested.busSequences){
+            flat.buses.push_back(bus.first);
+        }
+    }
+    for(int b: flat.buses){
+        auto sequence = nested.busSequences.find(b);
+        flat.stopStart.push_back(flat.stopStart.back() +
+                                 (sequence == nested.busSequences.end() ? 0 : sequence->second.size()));
+    }
+    flat.chargingStations = nested.chargingStations;
+    flattenField(flat.buses, flat.stopStart, nested.busSequences, flat.busSequences);
+    flattenField(flat.buses, flat.stopStart, nested.nonRenewable, flat.nonRenewable);
+    flattenField(flat.buses, flat.stopStart, nested.arrivalTime, flat.arrivalTime);
+    flattenField(flat.buses, flat.stopStart, nested.scheduledTime, flat.scheduledTime);
+    flattenField(flat.buses, flat.stopStart, nested.deviationTime, flat.deviationTime);
+    flattenField(flat.buses, flat.stopStart, nested.capacity, flat.capacity);
+    flattenField(flat.buses, flat.stopStart, nested.chargeTime, flat.chargeTime);
+    flattenField(flat.buses, flat.stopStart, nested.chargeAmount, flat.chargeAmount);
+    flattenField(flat.buses, flat.stopStart, nested.charge, flat.charge);
+    flattenField(flat.buses, flat.stopStart, nested.ases, flat.ases);
+    flattenField(flat.buses, flat.stopStart, nested.discounts, flat.discounts);
+    flat.powerExcess = nested.powerExcess;
+
+    flat.cleanEnergy = flattenCleanEnergy(nested, flat);
+    return flat;
+}
+
+/// only the stops which used a CEW are kept
+vector<CleanEnergyUse> flattenCleanEnergy(const nestedVariables &nested, const primitiveVariables &flat){
+    vector<CleanEnergyUse> cleanEnergy;
+    int numberWindows = max(nested.windowEnergyUsed.size(), nested.powerExcess.size());
+    for(int n = 0; n < flat.buses.size(); n++){
+        int b = flat.buses[n];
+        auto chargeTimes = nested.cleanChargeTime.find(b);
+        auto charges = nested.cleanWindowCharge.find(b);
+        for(int i = 0; i < flat.numberStops(n); i++){
+            for(int k = 0; k < numberWindows; k++){
+                CleanEnergyUse use{k, n, i, 0.0, 0.0, 0};
+                if(k < nested.windowEnergyUsed.size()){
+                    auto energy = nested.windowEnergyUsed[k].find(b);
+                    if(energy != nested.windowEnergyUsed[k].end() && i < energy->second.size()){
+                        use.energy = energy->second[i];
+                    }
+                }
+                if(chargeTimes != nested.cleanChargeTime.end() && i < chargeTimes->second.size() &&
+                   k < chargeTimes->second[i].size()){
+                    use.chargeTime = chargeTimes->second[i][k];
+                }
+                if(charges != nested.cleanWindowCharge.end() && i < charges->second.size() &&
+                   k < charges->second[i].size()){
+                    use.charge = charges->second[i][k];
+                }
+                if(use.energy != 0.0 || use.chargeTime != 0.0 || use.charge != 0){
+                    cleanEnergy.push_back(use);
+                }
+            }
+        }
+    }
+    return cleanEnergy;
+}
+
+vector<string> differentFields(const primitiveVariables &a, const primitiveVariables &b){
+    vector<string> fields;
+    auto compare = [&](bool same, string field){
+        if(!same){
+            fields.push_back(field);
+        }
+    };
+    compare(a.buses == b.buses, "buses");
+    compare(a.stopStart == b.stopStart, "stopStart");
+    compare(a.chargingStations == b.chargingStations, "chargingStations");
+    compare(a.busSequences == b.busSequences, "busSequences");
+    compare(a.nonRenewable == b.nonRenewable, "nonRenewable");
+    compare(a.arrivalTime == b.arrivalTime, "arrivalTime");
+    compare(a.scheduledTime == b.scheduledTime, "scheduledTime");
+    compare(a.deviationTime == b.deviationTime, "deviationTime");
+    compare(a.capacity == b.capacity, "capacity");
+    compare(a.chargeTime == b.chargeTime, "chargeTime");
+    compare(a.chargeAmount == b.chargeAmount, "chargeAmount");
+    compare(a.charge == b.charge, "charge");
+    bool sameWindows = a.powerExcess.size() == b.powerExcess.size();
+    for(int k = 0; sameWindows && k < a.powerExcess.size(); k++){
+        sameWindows = a.powerExcess[k].startTime == b.powerExcess[k].startTime &&
+                      a.powerExcess[k].endTime == b.powerExcess[k].endTime &&
+                      a.powerExcess[k].availableEnergy == b.powerExcess[k].availableEnergy;
+    }
+    compare(sameWindows, "powerExcess");
+    bool sameCleanEnergy = a.cleanEnergy.size() == b.cleanEnergy.size();
+    for(int e = 0; sameCleanEnergy && e < a.cleanEnergy.size(); e++){
+        const CleanEnergyUse &useA = a.cleanEnergy[e];
+        const CleanEnergyUse &useB = b.cleanEnergy[e];
+        sameCleanEnergy = useA.window == useB.window && useA.bus == useB.bus && useA.stop == useB.stop &&
+                          useA.energy == useB.energy && useA.chargeTime == useB.chargeTime &&
+                          useA.charge == useB.charge;
+    }
+    compare(sameCleanEnergy, "cleanEnergy");
+    compare(a.ases == b.ases, "ases");
+    compare(a.discounts == b.discounts, "discounts");
+    return fields;
+}
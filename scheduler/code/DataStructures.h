@@ -4,6 +4,9 @@
 #include "vector"
 #include "string"
 #include "map"
+#include "DistanceMatrix.h"
+#include <boost/serialization/version.hpp>
+#include <boost/serialization/split_free.hpp>
 
 
 using namespace std;
@@ -13,19 +16,86 @@ struct CleanEnergyWindow{
     double availableEnergy;
 };
 
+/// The values of every stop are stored in one array for all buses. The stops of the bus with index n, its position in
+/// busKeys, are stopStart[n] to stopStart[n + 1] - 1.
 struct ModelParameters{
     vector<int> chargingStops;
     vector<CleanEnergyWindow> cleanEnergyWindows;
     vector<vector<string>> stationData;
     int numberStations;
-    vector<vector<double>> distances;
+    shared_ptr<const DistanceMatrix> distances;
     vector<int> busKeys;
-    map<int, vector<int>> busSequencesRaw;
-    map<int, vector<double>> busTimeRaw;
-    map<int, vector<int>> rests;
+    vector<int> stopStart = {0};
+
+    /// the station, the scheduled arrival time and whether the driver rests, for each stop
+    vector<int> stations;
+    vector<double> scheduledTimes;
+    vector<int> rests;
+
+    /// D_ij and T_ij of the leg which ends at each stop, T_ij is replaced by the scheduled time between the stops if
+    /// that is shorter (see constraint 3.7). Both are 0 for the first stop of a bus, they are filled by setLegs
+    vector<double> legCost;
+    vector<double> legTime;
+
+    int numberBuses() const{
+        return busKeys.size();
+    }
+    int numberStops(int n) const{
+        return stopStart[n + 1] - stopStart[n];
+    }
+    int totalStops() const{
+        return stopStart.back();
+    }
+    void setLegs(double busEnergyCost, double busSpeed);
+
+    /// the parameters of bus n alone, with the stations and CEW of the location and the legs if they are set
+    ModelParameters singleBus(int n) const;
+};
+
+/// the clean energy used at one stop from one CEW, only stops which charge during a CEW have an entry
+struct CleanEnergyUse{
+    /// k, the index of the bus and the stop of that bus
+    int window;
+    int bus;
+    int stop;
+
+    /// ce_kbi, wt_bik and kt_bik
+    double energy;
+    double chargeTime;
+    int charge;
 };
 
+/// A schedule, with the same layout as ModelParameters: the values of the stops of the bus with index n, the bus
+/// buses[n], are stopStart[n] to stopStart[n + 1] - 1 of each per stop array
 struct primitiveVariables{
+    vector<int> buses;
+    vector<int> stopStart = {0};
+    vector<int> chargingStations;
+    vector<int> busSequences;
+    vector<double> nonRenewable;
+    vector<double> arrivalTime;
+    vector<double> scheduledTime;
+    vector<double> deviationTime;
+    vector<double> capacity;
+    vector<double> chargeTime;
+    vector<double> chargeAmount;
+    vector<int> charge;
+    vector<CleanEnergyWindow> powerExcess;
+    vector<CleanEnergyUse> cleanEnergy;
+
+    /// only used by SPM, empty otherwise
+    vector<int> ases;
+    vector<double> discounts;
+
+    int numberStops(int n) const{
+        return stopStart[n + 1] - stopStart[n];
+    }
+    /// the bus index of each bus of the schedule
+    map<int, int> busIndices() const;
+};
+
+/// the layout of primitiveVariables before the flat layout, keyed by bus. Only used to read older solution files
+struct nestedVariables{
     vector<int> buses;
     vector<int> chargingStations;
     map<int, vector<int>> busSequences;
@@ -47,11 +117,38 @@ struct primitiveVariables{
     map<int, vector<vector<int>>> cleanWindowCharge;
 };
 
+primitiveVariables flattenVariables(const nestedVariables &nested);
+/// the CEW entries of the nested CEW fields, flat has to hold the buses and stops of nested
+vector<CleanEnergyUse> flattenCleanEnergy(const nestedVariables &nested, const primitiveVariables &flat);
+
+/// the names of the fields of two solutions which differ, empty if every field is the same
+vector<string> differentFields(const primitiveVariables &a, const primitiveVariables &b);
+
 namespace boost{
     namespace serialization{
         template<class Archive>
-        void serialize(Archive & ar, primitiveVariables & vars, const unsigned int version){
+        void serialize(Archive & ar, CleanEnergyWindow & window, const unsigned int version){
+            ar & window.startTime;
+            ar & window.endTime;
+            ar & window.availableEnergy;
+        }
+
+        template<class Archive>
+        void serialize(Archive & ar, CleanEnergyUse & use, const unsigned int version){
+            ar & use.window;
+            ar & use.bus;
+            ar & use.stop;
+            ar & use.energy;
+            ar & use.chargeTime;
+            ar & use.charge;
+        }
+
+        /// the fields of the flat layout, Variables is const when saving. Version 2 archives also hold T_ij and D_ij,
+        /// which are derived from the distance file and are skipped
+        template<class Archive, class Variables>
+        void serializeFlat(Archive & ar, Variables & vars, const unsigned int version){
             ar & vars.buses;
+            ar & vars.stopStart;
             ar & vars.chargingStations;
             ar & vars.busSequences;
             ar & vars.nonRenewable;
@@ -62,7 +159,57 @@ namespace boost{
             ar & vars.chargeTime;
             ar & vars.chargeAmount;
             ar & vars.charge;
+            if(version == 2){
+                vector<vector<double>> tripTime;
+                vector<vector<double>> tripCost;
+                ar & tripTime;
+                ar & tripCost;
+            }
+            ar & vars.powerExcess;
+            ar & vars.cleanEnergy;
+            ar & vars.ases;
+            ar & vars.discounts;
+        }
+
+        template<class Archive>
+        void save(Archive & ar, const primitiveVariables & vars, const unsigned int version){
+            serializeFlat(ar, vars, version);
+        }
+
+        /// version 0 and 1 archives hold the nested layout. Version 0 only holds the fields up to charge, they are
+        /// still read with the remaining fields empty
+        template<class Archive>
+        void load(Archive & ar, primitiveVariables & vars, const unsigned int version){
+            if(version >= 2){
+                serializeFlat(ar, vars, version);
+                return;
+            }
+            nestedVariables nested;
+            ar & nested.buses;
+            ar & nested.chargingStations;
+            ar & nested.busSequences;
+            ar & nested.nonRenewable;
+            ar & nested.arrivalTime;
+            ar & nested.scheduledTime;
+            ar & nested.deviationTime;
+            ar & nested.capacity;
+            ar & nested.chargeTime;
+            ar & nested.chargeAmount;
+            ar & nested.charge;
+            if(version > 0){
+                ar & nested.tripTime;
+                ar & nested.tripCost;
+                ar & nested.powerExcess;
+                ar & nested.windowEnergyUsed;
+                ar & nested.ases;
+                ar & nested.discounts;
+                ar & nested.cleanChargeTime;
+                ar & nested.cleanWindowCharge;
+            }
+            vars = flattenVariables(nested);
         }
     }
 }
+BOOST_SERIALIZATION_SPLIT_FREE(primitiveVariables)
+BOOST_CLASS_VERSION(primitiveVariables, 3)
 #endif DATASTRUCTURES_H
@@ -0,0 +1,86 @@
+#ifndef SCHEDULER_DISTANCE_MATRIX_H
+#define SCHEDULER_DISTANCE_MATRIX_H
+#include "vector"
+#include "memory"
+#include "cstdint"
+#include "algorithm"
+
+using namespace std;
+
+/// Symmetric size x size matrix with a zero diagonal. Only the entries above the diagonal are stored, row after row, so
+/// the matrix takes size * (size - 1) / 2 values in one allocation.
+template <class T>
+class SymmetricMatrix{
+public:
+    /// a row of the matrix, read as if the matrix was stored row-major
+    class Row{
+    public:
+        Row(const SymmetricMatrix &matrix, int i): matrix(matrix), i(i){}
+        T operator[](int j) const{
+            return matrix(i, j);
+        }
+        int size() const{
+            return matrix.size();
+        }
+    private:
+        const SymmetricMatrix &matrix;
+        int i;
+    };
+
+    explicit SymmetricMatrix(int size = 0): numberRows(size), values((uint64_t) size * max(size - 1, 0) / 2, T()){}
+
+    int size() const{
+        return numberRows;
+    }
+    T operator()(int i, int j) const{
+        if(i == j){
+            return T();
+        }
+        return i < j ? values[index(i, j)] : values[index(j, i)];
+    }
+    /// sets both (i, j) and (j, i), i and j have to differ
+    void set(int i, int j, T value){
+        values[i < j ? index(i, j) : index(j, i)] = value;
+    }
+    Row row(int i) const{
+        return Row(*this, i);
+    }
+    uint64_t bytes() const{
+        return values.size() * sizeof(T);
+    }
+
+private:
+    /// the position of (i, j) for i < j, rows 0 to i - 1 hold size - 1 to size - i entries
+    uint64_t index(int i, int j) const{
+        return (uint64_t) i * (2 * (uint64_t) numberRows - i - 1) / 2 + (j - i - 1);
+    }
+
+    int numberRows;
+    vector<T> values;
+};
+
+/// the distances (in km) between the stations. The distance file holds them with float precision, so float is kept.
+/// Parsed once per location and shared read-only by every run
+typedef SymmetricMatrix<float> DistanceMatrix;
+
+/// D_ij, the energy (in kWh) needed for a trip between stations i and j, derived from the shared distances
+struct TripCost{
+    shared_ptr<const DistanceMatrix> distances;
+    double busEnergyCost = 0.0;
+
+    double operator()(int i, int j) const{
+        return (*distances)(i, j) * busEnergyCost;
+    }
+};
+
+/// T_ij, the time (in hour decimal) needed for a trip between stations i and j, derived from the shared distances
+struct TripTime{
+    shared_ptr<const DistanceMatrix> distances;
+    double busSpeed = 1.0;
+
+    double operator()(int i, int j) const{
+        return ((60 / busSpeed) * (*distances)(i, j)) / 60;
+    }
+};
+
+#endif //SCHEDULER_DISTANCE_MATRIX_H
@@ -0,0 +1,309 @@
+#include "GreedyScheduler.h"
+#include "algorithm"
+#include "cmath"
+#include "numeric"
+
+using namespace std;
+
+GreedyScheduler::GreedyScheduler(const RunConfig &config){
+    maxChargeTime = config.maxChargeTime;
+    minChargeTime = config.minChargeTime;
+    chargeRate = config.chargeRate;
+    deviationTime = config.deviationTime;
+    maxBatteryCapacity = config.maxBatteryCapacity;
+    minBatteryCapacity = config.minBatteryCapacity;
+    startingCapacity = config.startingCapacity;
+    busEnergyCost = config.busEnergyCost;
+    busSpeed = config.busSpeed;
+    horizonEndTime = config.horizonEndTime;
+    spm = config.method == "SPM";
+    discountFactor = spm ? config.discountFactor : 0.0;
+}
+
+/// build a schedule for every bus. When recalculating, the stops which were reached before horizonStartTime keep the
+/// values of the previous schedule.
+primitiveVariables GreedyScheduler::buildSchedule(ModelParameters &parameters, const vector<CleanEnergyWindow> &cews,
+                                                  primitiveVariables *previousSchedule, double horizonStartTime){
+    primitiveVariables schedule;
+    windows = cews;
+    windowRemaining.clear();
+    for(auto &window: windows){
+        windowRemaining.push_back(window.availableEnergy);
+    }
+    windowIndex.build(windows, deviationTime, maxChargeTime);
+    chargingStops = parameters.chargingStops;
+    chargerBusy = vector<vector<pair<double, double>>>(parameters.numberStations);
+    totalNonRenewable = 0.0;
+    numberInfeasible = 0;
+
+    /// the leg constants are shared with the model, see ModelParameters::setLegs
+    parameters.setLegs(busEnergyCost, busSpeed);
+    int numberStops = parameters.totalStops();
+
+    schedule.buses = parameters.busKeys;
+    schedule.stopStart = parameters.stopStart;
+    schedule.chargingStations = vector<int>(parameters.numberStations);
+    for(int i = 0; i < chargingStops.size() && i < parameters.numberStations; i++){
+        schedule.chargingStations[i] = chargingStops[i];
+    }
+    schedule.powerExcess = windows;
+    schedule.busSequences = parameters.stations;
+    schedule.scheduledTime = parameters.scheduledTimes;
+    schedule.arrivalTime = vector<double>(numberStops);
+    schedule.deviationTime = vector<double>(numberStops);
+    schedule.capacity = vector<double>(numberStops);
+    schedule.chargeTime = vector<double>(numberStops, 0.0);
+    schedule.chargeAmount = vector<double>(numberStops, 0.0);
+    schedule.nonRenewable = vector<double>(numberStops, 0.0);
+    schedule.charge = vector<int>(numberStops, 0);
+    if(spm){
+        schedule.ases = vector<int>(numberStops, 0);
+        schedule.discounts = vector<double>(numberStops, 0.0);
+    }
+
+    /// the previous schedule may hold the buses in another order
+    vector<int> previousIndices(parameters.numberBuses(), -1);
+    if(previousSchedule != nullptr){
+        map<int, int> busIndices = previousSchedule->busIndices();
+        for(int n = 0; n < parameters.numberBuses(); n++){
+            auto previous = busIndices.find(parameters.busKeys[n]);
+            if(previous != busIndices.end()){
+                previousIndices[n] = previous->second;
+            }
+        }
+    }
+
+    /// the buses whose stops were all reached keep their charges, so they are placed before the other buses choose.
+    /// Otherwise buses which leave first get the first choice of chargers and clean energy
+    vector<char> reachedBus(parameters.numberBuses(), 0);
+    for(int n = 0; n < parameters.numberBuses(); n++){
+        int previous = previousIndices[n];
+        if(previous >= 0 && previousSchedule->numberStops(previous) >= parameters.numberStops(n)){
+            int last = previousSchedule->stopStart[previous] + parameters.numberStops(n) - 1;
+            reachedBus[n] = previousSchedule->arrivalTime[last] <= horizonStartTime;
+        }
+    }
+    vector<int> busOrder(parameters.numberBuses());
+    iota(busOrder.begin(), busOrder.end(), 0);
+    stable_sort(busOrder.begin(), busOrder.end(), [&parameters, &reachedBus](int a, int b){
+        if(reachedBus[a] != reachedBus[b]){
+            return reachedBus[a] > reachedBus[b];
+        }
+        return parameters.scheduledTimes[parameters.stopStart[a]] < parameters.scheduledTimes[parameters.stopStart[b]];
+    });
+    for(int n: busOrder){
+        scheduleBus(n, parameters, schedule, previousSchedule, previousIndices[n], horizonStartTime);
+    }
+    return schedule;
+}
+
+void GreedyScheduler::scheduleBus(int n, const ModelParameters &parameters, primitiveVariables &schedule,
+                                  primitiveVariables *previousSchedule, int previousIndex, double horizonStartTime){
+    int first = parameters.stopStart[n];
+    int numStops = parameters.numberStops(n);
+    const int *sequence = parameters.stations.data() + first;
+    const double *scheduledTimes = parameters.scheduledTimes.data() + first;
+    const int *rests = parameters.rests.data() + first;
+    const double *legCosts = parameters.legCost.data() + first;
+    const double *legTimes = parameters.legTime.data() + first;
+
+    vector<double> allowedDeviation(numStops, deviationTime);
+    allowedDeviation[0] = 0.0;
+    for(int i = 1; i < numStops; i++){
+        if(rests[i - 1] == 1 && sequence[i] == sequence[i - 1]){
+            allowedDeviation[i] = 0.0;
+        }
+    }
+    double travelEnergy = accumulate(legCosts, legCosts + numStops, 0.0);
+    double energyNeeded = travelEnergy + minBatteryCapacity - startingCapacity;
+
+    /// the stops of this bus in the previous schedule, used up to the stops the bus had then
+    bool usePrevious = previousSchedule != nullptr && previousIndex >= 0;
+    int previousFirst = usePrevious ? previousSchedule->stopStart[previousIndex] : 0;
+    int previousStops = usePrevious ? previousSchedule->numberStops(previousIndex) : 0;
+
+    double *arrival = schedule.arrivalTime.data() + first;
+    double *deviation = schedule.deviationTime.data() + first;
+    double *capacity = schedule.capacity.data() + first;
+    double *chargeTime = schedule.chargeTime.data() + first;
+    double *chargeAmount = schedule.chargeAmount.data() + first;
+    double *nonRenewable = schedule.nonRenewable.data() + first;
+    int *charge = schedule.charge.data() + first;
+
+    double time = scheduledTimes[0];
+    double batteryCapacity = startingCapacity;
+    double charged = 0.0;
+    bool busFeasible = true;
+    vector<int> reachable;
+    for(int i = 0; i < numStops; i++){
+        int station = sequence[i];
+        bool hasCharger = station < chargingStops.size() && chargingStops[station] == 1;
+        double stopChargeTime = 0.0;
+        double stopChargeAmount = 0.0;
+        int previous = previousFirst + i;
+        bool reached = i < previousStops && previousSchedule->arrivalTime[previous] <= horizonStartTime;
+
+        if(reached){
+            /// this stop was already reached, keep the previous decisions
+            time = previousSchedule->arrivalTime[previous];
+            batteryCapacity = previousSchedule->capacity[previous];
+            stopChargeTime = previousSchedule->chargeTime[previous];
+            stopChargeAmount = previousSchedule->chargeAmount[previous];
+        }
+        else if(hasCharger && energyNeeded - charged > 0 && i < numStops - 1){
+            /// energy required to reach the next charger, or the end of the route, above the minimum capacity
+            double energyToNextCharger = 0.0;
+            for(int j = i + 1; j < numStops; j++){
+                energyToNextCharger += legCosts[j];
+                if(sequence[j] < chargingStops.size() && chargingStops[sequence[j]] == 1){
+                    break;
+                }
+            }
+            double requiredAmount = energyToNextCharger + minBatteryCapacity - batteryCapacity;
+            double wantedAmount = max(0.0, requiredAmount);
+
+            /// clean energy is preferred, so charge whenever a CEW can supply it
+            windowIndex.reachableWindows(scheduledTimes[i], reachable);
+            double cleanAmount = cleanEnergyAvailable(reachable, time, time + maxChargeTime);
+            wantedAmount = max(wantedAmount, min(cleanAmount, energyNeeded - charged));
+            wantedAmount = min(wantedAmount, min(maxBatteryCapacity - batteryCapacity, maxChargeTime * chargeRate));
+
+            if(wantedAmount > 0){
+                double duration = max(minChargeTime, wantedAmount / chargeRate);
+                /// the charge starts at arrival, so a busy charger is resolved by arriving later within the deviation
+                vector<double> candidateStarts{time};
+                for(auto &busy: chargerBusy[station]){
+                    if(busy.second > time){
+                        candidateStarts.push_back(busy.second);
+                    }
+                }
+                sort(candidateStarts.begin(), candidateStarts.end());
+                bool placed = false;
+                while(!placed && duration >= minChargeTime){
+                    for(double start: candidateStarts){
+                        if(start - scheduledTimes[i] > allowedDeviation[i] + 1e-9){
+                            break;
+                        }
+                        if(chargerFree(station, start, start + duration) &&
+                           downstreamFeasible(scheduledTimes, legTimes, allowedDeviation.data(), numStops, i,
+                                              start + duration)){
+                            time = start;
+                            placed = true;
+                            break;
+                        }
+                    }
+                    if(!placed){
+                        duration -= minChargeTime;
+                    }
+                }
+                if(placed){
+                    stopChargeTime = duration;
+                    stopChargeAmount = min(wantedAmount, duration * chargeRate);
+                }
+                if(!placed && requiredAmount > 0){
+                    busFeasible = false;
+                }
+            }
+        }
+
+        arrival[i] = time;
+        deviation[i] = abs(time - scheduledTimes[i]);
+        capacity[i] = batteryCapacity;
+        chargeTime[i] = stopChargeTime;
+        chargeAmount[i] = stopChargeAmount;
+        charge[i] = stopChargeTime > 0 ? 1 : 0;
+
+        /// the clean energy is taken from the windows in order, matching constraints 3.16-3.23
+        double cleanEnergy = 0.0;
+        if(charge[i] == 1){
+            chargerBusy[station].push_back({time, time + stopChargeTime});
+            windowIndex.reachableWindows(scheduledTimes[i], reachable);
+            for(int k: reachable){
+                double overlap = min(time + stopChargeTime, windows[k].endTime) - max(time, windows[k].startTime);
+                if(overlap <= 0){
+                    continue;
+                }
+                double energy = max(0.0, min(overlap * chargeRate,
+                                             min(windowRemaining[k], stopChargeAmount - cleanEnergy)));
+                schedule.cleanEnergy.push_back({k, n, i, energy, overlap, 1});
+                windowRemaining[k] -= energy;
+                cleanEnergy += energy;
+            }
+        }
+
+        /// ase_bi has to be 1 for arrivals before the end of the checkpoint, only later charges are discounted
+        int ase = time < horizonEndTime ? 1 : 0;
+        double discount = 0.0;
+        if(spm && ase == 0){
+            discount = min(discountFactor * stopChargeAmount, stopChargeAmount - cleanEnergy);
+        }
+        if(spm){
+            schedule.ases[first + i] = ase;
+            schedule.discounts[first + i] = discount;
+        }
+        nonRenewable[i] = max(0.0, stopChargeAmount - cleanEnergy - discount);
+        if(reached){
+            nonRenewable[i] = max(nonRenewable[i], previousSchedule->nonRenewable[previous]);
+        }
+        totalNonRenewable += nonRenewable[i];
+        charged += stopChargeAmount;
+
+        if(i < numStops - 1){
+            batteryCapacity = batteryCapacity + stopChargeAmount - legCosts[i + 1];
+            time = max(scheduledTimes[i + 1], time + stopChargeTime + legTimes[i + 1]);
+            if(batteryCapacity < minBatteryCapacity || time - scheduledTimes[i + 1] > allowedDeviation[i + 1] + 1e-9){
+                busFeasible = false;
+            }
+        }
+    }
+    if(!busFeasible){
+        numberInfeasible++;
+    }
+}
+
+bool GreedyScheduler::chargerFree(int station, double start, double end) const{
+    for(auto &busy: chargerBusy[station]){
+        if(start < busy.second - 1e-9 && busy.first < end - 1e-9){
+            return false;
+        }
+    }
+    return true;
+}
+
+/// a charge delays the following stops until the slack in the timetable absorbs it, every delayed arrival has to stay
+/// within the allowed deviation
+bool GreedyScheduler::downstreamFeasible(const double *scheduledTimes, const double *legTimes,
+                                         const double *allowedDeviation, int numStops, int stop,
+                                         double departure) const{
+    double time = departure;
+    for(int j = stop + 1; j < numStops; j++){
+        time = time + legTimes[j];
+        if(time <= scheduledTimes[j]){
+            return true;
+        }
+        if(time - scheduledTimes[j] > allowedDeviation[j] + 1e-9){
+            return false;
+        }
+    }
+    return true;
+}
+
+/// the clean energy which could still be used by a charge between start and end from the reachable CEW
+double GreedyScheduler::cleanEnergyAvailable(const vector<int> &reachable, double start, double end) const{
+    double energy = 0.0;
+    for(int k: reachable){
+        double overlap = min(end, windows[k].endTime) - max(start, windows[k].startTime);
+        if(overlap > 0){
+            energy += min(overlap * chargeRate, windowRemaining[k]);
+        }
+    }
+    return energy;
+}
+
+double GreedyScheduler::objectiveValue() const{
+    return totalNonRenewable;
+}
+
+int GreedyScheduler::infeasibleBuses() const{
+    return numberInfeasible;
+}
@@ -0,0 +1,54 @@
+#ifndef SCHEDULER_GREEDY_SCHEDULER_H
+#define SCHEDULER_GREEDY_SCHEDULER_H
+#include "vector"
+#include "map"
+#include "string"
+#include "DataStructures.h"
+#include "RunConfig.h"
+#include "WindowIndex.h"
+
+using namespace std;
+
+/// Constructive heuristic which builds a feasible schedule without a solver. Buses are walked stop by stop in order of
+/// their first departure, charging at installed stations when the next charger cannot be reached otherwise or when
+/// clean energy is available. Charges that would overlap on a charger are delayed within the allowed deviation.
+class GreedyScheduler{
+public:
+    explicit GreedyScheduler(const RunConfig &config);
+    primitiveVariables buildSchedule(ModelParameters &parameters, const vector<CleanEnergyWindow> &windows,
+                                     primitiveVariables *previousSchedule = nullptr, double horizonStartTime = 0.0);
+    double objectiveValue() const;
+    int infeasibleBuses() const;
+
+private:
+    void scheduleBus(int n, const ModelParameters &parameters, primitiveVariables &schedule,
+                     primitiveVariables *previousSchedule, int previousIndex, double horizonStartTime);
+    bool chargerFree(int station, double start, double end) const;
+    bool downstreamFeasible(const double *scheduledTimes, const double *legTimes, const double *allowedDeviation,
+                            int numStops, int stop, double departure) const;
+    double cleanEnergyAvailable(const vector<int> &reachable, double start, double end) const;
+
+    double maxChargeTime;
+    double minChargeTime;
+    double chargeRate;
+    double deviationTime;
+    double maxBatteryCapacity;
+    double minBatteryCapacity;
+    double startingCapacity;
+    double busEnergyCost;
+    double busSpeed;
+    double discountFactor;
+    double horizonEndTime;
+    bool spm;
+
+    vector<CleanEnergyWindow> windows;
+    /// the CEW each stop can reach, the same ones which have columns in the model
+    WindowIndex windowIndex;
+    vector<double> windowRemaining;
+    vector<int> chargingStops;
+    vector<vector<pair<double, double>>> chargerBusy;
+    double totalNonRenewable = 0.0;
+    int numberInfeasible = 0;
+};
+
+#endif //SCHEDULER_GREEDY_SCHEDULER_H
@@ -0,0 +1,113 @@
+#include "HighsBackend.h"
+#include "iostream"
+#include "fstream"
+
+using namespace std;
+
+string HighsBackend::name() const{
+    return "highs";
+}
+
+void HighsBackend::loadModel(const ModelIR &model){
+    vector<HighsInt> integrality(model.numberColumns());
+    for(int c = 0; c < model.numberColumns(); c++){
+        integrality[c] = (HighsInt) (model.columnType[c] == INTEGER ? HighsVarType::kInteger : HighsVarType::kContinuous);
+    }
+    highs.passModel(model.numberColumns(), model.numberRows(), model.numberNonzeros(),
+                    (HighsInt) MatrixFormat::kRowwise, (HighsInt) ObjSense::kMinimize, 0.0,
+                    model.objective.data(), model.columnLower.data(), model.columnUpper.data(),
+                    model.rowLower.data(), model.rowUpper.data(), model.rowStart.data(), model.rowIndex.data(),
+                    model.rowValue.data(), integrality.data());
+}
+
+void HighsBackend::updateModel(const ModelIR &model, const ModelChanges &changes){
+    HighsInt loadedColumns = highs.getNumCol();
+    HighsInt loadedRows = highs.getNumRow();
+    for(int c: changes.columns){
+        if(c < loadedColumns){
+            highs.changeColBounds(c, model.columnLower[c], model.columnUpper[c]);
+        }
+    }
+    for(int r: changes.rows){
+        if(r < loadedRows){
+            highs.changeRowBounds(r, model.rowLower[r], model.rowUpper[r]);
+        }
+    }
+
+    /// new columns are added without coefficients, the coefficients are added with the new rows
+    HighsInt newColumns = model.numberColumns() - loadedColumns;
+    if(newColumns > 0){
+        highs.addCols(newColumns, model.objective.data() + loadedColumns, model.columnLower.data() + loadedColumns,
+                      model.columnUpper.data() + loadedColumns, 0, nullptr, nullptr, nullptr);
+        for(int c = loadedColumns; c < model.numberColumns(); c++){
+            if(model.columnType[c] == INTEGER){
+                highs.changeColIntegrality(c, HighsVarType::kInteger);
+            }
+        }
+    }
+    HighsInt newRows = model.numberRows() - loadedRows;
+    if(newRows > 0){
+        int firstNonzero = model.rowStart[loadedRows];
+        vector<HighsInt> starts(newRows);
+        for(int r = 0; r < newRows; r++){
+            starts[r] = model.rowStart[loadedRows + r] - firstNonzero;
+        }
+        highs.addRows(newRows, model.rowLower.data() + loadedRows, model.rowUpper.data() + loadedRows,
+                      model.numberNonzeros() - firstNonzero, starts.data(), model.rowIndex.data() + firstNonzero,
+                      model.rowValue.data() + firstNonzero);
+    }
+}
+
+void HighsBackend::setMIPStart(const vector<double> &values){
+    HighsSolution start;
+    start.col_value = values;
+    start.value_valid = true;
+    highs.setSolution(start);
+}
+
+SolverResult HighsBackend::solve(const SolverSettings &settings){
+    SolverResult result;
+
+    /// use a warming solution if one is available.
+    ifstream f(settings.warmingSolutionFile.c_str());
+    if(f.good()){
+        cout << "Previous solution file found. Using solution warming" << endl;
+        highs.readSolution(settings.warmingSolutionFile);
+    }
+    else{
+        cout << "No previous solution file found" << endl;
+    }
+    f.close();
+
+    if(settings.maxSolutions > 0){
+        highs.setOptionValue("mip_max_improving_sols", settings.maxSolutions);
+    }
+    if(settings.timeout > 0){
+        highs.setOptionValue("time_limit", (double) settings.timeout);
+    }
+    if(settings.threads > 0){
+        highs.setOptionValue("threads", settings.threads);
+    }
+    if(!settings.logFile.empty()){
+        highs.setOptionValue("log_file", settings.logFile);
+        highs.setOptionValue("log_to_console", false);
+    }
+
+    highs.run();
+    HighsModelStatus status = highs.getModelStatus();
+    result.status = highs.modelStatusToString(status);
+    if(highs.getInfo().primal_solution_status == kSolutionStatusFeasible){
+        result.solved = true;
+        result.values = highs.getSolution().col_value;
+        result.objectiveValue = highs.getInfo().objective_function_value;
+        result.relativeGap = highs.getInfo().mip_gap;
+        if(!settings.solutionFile.empty()){
+            highs.writeSolution(settings.solutionFile);
+        }
+    }
+    else{
+        cout << result.status << endl;
+        cerr << "ERROR FAILED TO SOLVE" << endl;
+    }
+    return result;
+}
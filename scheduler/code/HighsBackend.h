@@ -0,0 +1,21 @@
+#ifndef SCHEDULER_HIGHS_BACKEND_H
+#define SCHEDULER_HIGHS_BACKEND_H
+#include "Highs.h"
+#include "SolverBackend.h"
+
+using namespace std;
+
+/// optional open-source backend, the ModelIR arrays are passed to HiGHS without any conversion
+class HighsBackend: public SolverBackend{
+public:
+    string name() const override;
+    void loadModel(const ModelIR &model) override;
+    void updateModel(const ModelIR &model, const ModelChanges &changes) override;
+    void setMIPStart(const vector<double> &values) override;
+    SolverResult solve(const SolverSettings &settings) override;
+
+private:
+    Highs highs;
+};
+
+#endif //SCHEDULER_HIGHS_BACKEND_H
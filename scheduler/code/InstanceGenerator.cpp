@@ -0,0 +1,152 @@
+#include "InstanceGenerator.h"
+#include "Output.h"
+#include "algorithm"
+#include "cmath"
+#include "cstdio"
+#include "filesystem"
+#include "fstream"
+#include "numeric"
+#include "random"
+#include "sstream"
+
+using namespace std;
+
+/// the roads between two stations are this much longer than the straight line
+static const double DETOUR = 1.3;
+static const double BUS_SPEED = 35.0;
+
+InstanceGenerator::InstanceGenerator(const InstanceSpec &spec): spec(spec){}
+
+map<string, string> InstanceGenerator::write(string folder) const{
+    filesystem::create_directories(folder);
+    mt19937 generator(spec.seed);
+    uniform_real_distribution<double> coordinate(0.0, 5.0);
+    int numberStations = max(2, spec.numberStations);
+
+    vector<double> x(numberStations), y(numberStations);
+    for(int i = 0; i < numberStations; i++){
+        x[i] = coordinate(generator);
+        y[i] = coordinate(generator);
+    }
+    auto distance = [&](int i, int j){
+        return DETOUR * hypot(x[i] - x[j], y[i] - y[j]);
+    };
+
+    /// the chargers are at random stations
+    vector<int> stationOrder(numberStations);
+    iota(stationOrder.begin(), stationOrder.end(), 0);
+    shuffle(stationOrder.begin(), stationOrder.end(), generator);
+    int numberChargers = clamp((int) lround(spec.chargerDensity * numberStations), 1, numberStations);
+    vector<int> chargingStops(numberStations, 0);
+    vector<int> chargers(stationOrder.begin(), stationOrder.begin() + numberChargers);
+    for(int station: chargers){
+        chargingStops[station] = 1;
+    }
+
+    ofstream stations(folder + "/stations.csv");
+    stations << "name,x,y\n";
+    for(int i = 0; i < numberStations; i++){
+        stations << "Station" << i << "," << x[i] << "," << y[i] << "\n";
+    }
+    stations.close();
+
+    /// Parser only reads the distance of each pair once
+    ofstream distances(folder + "/distances.csv");
+    distances << "from,to,distance\n";
+    char line[64];
+    for(int i = 0; i < numberStations; i++){
+        for(int j = i + 1; j < numberStations; j++){
+            int length = snprintf(line, sizeof(line), "%d,%d,%.3f\n", i, j, distance(i, j));
+            distances.write(line, length);
+        }
+    }
+    distances.close();
+
+    Output().writeChargingStationsFile(chargingStops, folder + "/charging_stations.txt");
+
+    /// each route is a loop through random stations with at least two chargers, in nearest neighbour order. The
+    /// missing chargers are random too, so the routes do not all share the same ones
+    int routeLength = min(numberStations, 12);
+    int numberRoutes = max(1, spec.numberBuses / 5);
+    vector<vector<int>> routes(numberRoutes);
+    for(auto &route: routes){
+        shuffle(stationOrder.begin(), stationOrder.end(), generator);
+        route.assign(stationOrder.begin(), stationOrder.begin() + routeLength);
+        shuffle(chargers.begin(), chargers.end(), generator);
+        int routeChargers = count_if(route.begin(), route.end(), [&](int s){ return chargingStops[s] == 1; });
+        for(int c = 0; routeChargers < min(2, numberChargers) && c < numberChargers; c++){
+            if(find(route.begin(), route.end(), chargers[c]) != route.end()){
+                continue;
+            }
+            /// a charger only replaces a station without one, so the chargers of the route are kept
+            auto slot = find_if(route.begin(), route.end(), [&](int s){ return chargingStops[s] == 0; });
+            if(slot == route.end()){
+                break;
+            }
+            *slot = chargers[c];
+            routeChargers++;
+        }
+        for(int i = 1; i < routeLength; i++){
+            auto nearest = min_element(route.begin() + i, route.end(), [&](int a, int b){
+                return distance(route[i - 1], a) < distance(route[i - 1], b);
+            });
+            iter_swap(route.begin() + i, nearest);
+        }
+    }
+
+    /// the buses of a route start between 5 and 7, every day ends before midnight
+    uniform_int_distribution<int> startDistribution(0, 24);
+    double fleetEnergy = 0.0;
+    ofstream buses(folder + "/buses.json");
+    buses << "[";
+    for(int r = 0; r < numberRoutes; r++){
+        buses << (r == 0 ? "" : ", ") << "{\"route\": " << r << ", \"buses\": [";
+        const vector<int> &route = routes[r];
+        for(int b = r; b < spec.numberBuses; b += numberRoutes){
+            buses << (b == r ? "" : ", ") << "{\"bus\": " << b << ", \"path\": [";
+            int minutes = 5 * 60 + 5 * startDistribution(generator);
+            for(int i = 0; i < spec.stopsPerBus && minutes < 24 * 60 - 1; i++){
+                int station = route[i % routeLength];
+                int next = route[(i + 1) % routeLength];
+                bool rest = i % routeLength == routeLength - 1;
+                char time[6];
+                snprintf(time, sizeof(time), "%02d:%02d", minutes / 60, minutes % 60);
+                buses << (i == 0 ? "" : ", ") << "{\"time\": \"" << time << "\", \"station_id\": " << station
+                      << (rest ? ", \"rest\": 1}" : "}");
+                minutes += (int) ceil(distance(station, next) / BUS_SPEED * 60) + 3 + (rest ? 10 : 0);
+                fleetEnergy += distance(station, next);
+            }
+            buses << "]}";
+        }
+        buses << "]}";
+    }
+    buses << "]";
+    buses.close();
+
+    /// the CEW hold a tenth of the energy the fleet needs, the boundaries of consecutive windows are written the
+    /// same way so they touch
+    normal_distribution<double> noise(0.0, 0.3);
+    int numberWindows = max(1, spec.numberWindows);
+    vector<double> sun(numberWindows);
+    for(int k = 0; k < numberWindows; k++){
+        sun[k] = sin(M_PI * (k + 0.5) / numberWindows);
+    }
+    double sunTotal = accumulate(sun.begin(), sun.end(), 0.0);
+    ostringstream cew;
+    for(int k = 0; k < numberWindows; k++){
+        double energy = max(0.0, fleetEnergy / 10.0 * sun[k] / sunTotal * (1.0 + noise(generator)));
+        cew << 6.0 + 12.0 * k / numberWindows << "-" << 6.0 + 12.0 * (k + 1) / numberWindows << "=" << energy << ",";
+    }
+    ofstream(folder + "/cew.txt") << cew.str() << "\n";
+
+    return {{"busDataFile", folder + "/buses.json"}, {"stationDataFile", folder + "/stations.csv"},
+            {"stationDistanceFile", folder + "/distances.csv"},
+            {"chargingStationsFile", folder + "/charging_stations.txt"}, {"CEW", cew.str()},
+            {"location", "synthetic"}, {"method", "MPM"}, {"discountFactor", "0.01"}, {"busEnergyCost", "1.0"},
+            {"busSpeed", to_string((int) BUS_SPEED)}, {"chargeRate", "600"}, {"bigM", "25"},
+            {"maxBatteryCapacity", "120"}, {"minBatteryCapacity", "12"}, {"startingCapacity", "50"},
+            {"maxChargeTime", "0.16"}, {"minChargeTime", "0.0166"}, {"deviationTime", "0.0833"},
+            {"horizonStartTime", "0"}, {"horizonEndTime", "24"}, {"powerRatio", "1.0"}, {"maxSolutions", "0"},
+            {"timeout", "60"}, {"modelFile", ""}, {"logFile", folder + "/logFile.txt"},
+            {"LPFile", folder + "/solution.lp"}, {"solutionSaveFile", folder + "/scheduleDetails"}};
+}
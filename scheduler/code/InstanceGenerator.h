@@ -0,0 +1,40 @@
+#ifndef SCHEDULER_INSTANCE_GENERATOR_H
+#define SCHEDULER_INSTANCE_GENERATOR_H
+#include "string"
+#include "map"
+#include "vector"
+
+using namespace std;
+
+/// the size of a synthetic instance
+struct InstanceSpec{
+    int numberStations = 200;
+    int numberBuses = 100;
+    int stopsPerBus = 40;
+
+    /// the share of the stations with a charger, every route passes at least two chargers
+    double chargerDensity = 0.1;
+
+    /// the CEW split the daylight from 6 to 18 into numberWindows windows of the same length
+    int numberWindows = 48;
+    unsigned int seed = 42;
+};
+
+/// Writes synthetic instances in the formats Parser reads, so instances of any size can be solved and benchmarked
+/// without the datasets of the locations. The stations lie in a square of 5 km, the distances are the straight
+/// distances with a detour factor, and the buses of a route drive its loop of stations from a start between 5 and 7
+/// with a rest at the end of each loop. The scheduled legs leave a few minutes for charging. The CEW follow the sun
+/// with noise. The same spec and seed always give the same files.
+class InstanceGenerator{
+public:
+    explicit InstanceGenerator(const InstanceSpec &spec);
+
+    /// writes buses.json, stations.csv, distances.csv, charging_stations.txt and cew.txt to folder, which is created
+    /// if it does not exist, and returns the arguments of a run of the instance
+    map<string, string> write(string folder) const;
+
+private:
+    InstanceSpec spec;
+};
+
+#endif //SCHEDULER_INSTANCE_GENERATOR_H
@@ -0,0 +1,717 @@
+#include "LagrangianDecomposition.h"
+#include "Utils.h"
+#include "cmath"
+#include "chrono"
+#include "thread"
+#include "numeric"
+#include "algorithm"
+#include "ConflictIndex.h"
+#include "GreedyScheduler.h"
+
+using namespace std;
+
+/// the decomposition stops once the best schedule is within this share of the lower bound
+static const double GAP_TOLERANCE = 1e-4;
+
+/// the step size is halved after this many iterations without a better lower bound
+static const int STALLED_ITERATIONS = 5;
+
+/// a kWh of clean energy replaces at most a kWh of non-clean energy, no bus uses a CEW with a higher price
+static const double MAX_WINDOW_PRICE = 1.0;
+
+MIPSubproblemSolver::MIPSubproblemSolver(const ModelParameters &parameters, const RunConfig &config,
+                                         const vector<CleanEnergyWindow> &windows):
+        parameters(parameters), config(config), windows(windows){
+    backendName = config.backend.empty() ? defaultSolverBackend() : config.backend;
+
+    /// the models of the buses are not written to disk
+    this->config.modelFile = "";
+    for(int n = 0; n < parameters.numberBuses(); n++){
+        buses.emplace_back(new BusModel());
+    }
+}
+
+string MIPSubproblemSolver::name() const{
+    return backendName;
+}
+
+/// the model of bus n alone, its CEW are a subset of the CEW of the fleet. Returns why the bus can not be solved, empty
+/// if it can
+string MIPSubproblemSolver::prepareBus(int n){
+    BusModel &bus = *buses[n];
+    if(!bus.problem){
+        ModelParameters busParameters = parameters.singleBus(n);
+        busParameters.cleanEnergyWindows = windows;
+        bus.problem.reset(new SchedulingProblem(busParameters, config, bus.log));
+        bus.problem->build();
+        int k = 0;
+        for(auto &window: bus.problem->cleanEnergyWindows()){
+            while(k < windows.size() &&
+                  (windows[k].startTime != window.startTime || windows[k].endTime != window.endTime)){
+                k++;
+            }
+            bus.fleetWindow.push_back(k++);
+        }
+        if(backendName != "mps"){
+            bus.backend = createSolverBackend(backendName, config.modelFile);
+        }
+    }
+    if(!bus.backend){
+        return "Solver backend " + backendName + " can not solve the subproblems in this build";
+    }
+    if(bus.problem->model.hasIndicatorRows() && !bus.backend->supportsIndicatorRows()){
+        return "Solver backend " + backendName + " does not support indicator rows, use --formulation bigM";
+    }
+    return "";
+}
+
+/// values holds the start, and the values of the solution once the problem is solved
+BusPlan MIPSubproblemSolver::solveModel(BusModel &bus, SchedulingProblem &problem, vector<double> &values){
+    BusPlan plan;
+    bus.backend->loadModel(problem.model);
+    if(!values.empty()){
+        bus.backend->setMIPStart(values);
+    }
+
+    /// the buses are solved in parallel, so each solve only uses one thread
+    SolverSettings settings;
+    settings.threads = 1;
+    settings.exactIntegrality = !problem.model.hasIndicatorRows();
+    SolverResult result = bus.backend->solve(settings);
+    plan.status = result.status;
+    if(!result.solved){
+        return plan;
+    }
+    plan.solved = true;
+    plan.objectiveValue = result.objectiveValue;
+    plan.objectiveBound = result.objectiveValue - result.relativeGap * fabs(result.objectiveValue);
+    values = result.values;
+    plan.schedule = problem.solutionToPrimitive(result.values);
+    for(auto &use: plan.schedule.cleanEnergy){
+        use.window = bus.fleetWindow[use.window];
+    }
+    plan.schedule.powerExcess = windows;
+    return plan;
+}
+
+/// only the objective changes between the iterations, so the previous plan is a feasible start
+BusPlan MIPSubproblemSolver::solve(int n, const CouplingPrices &prices){
+    BusPlan plan;
+    plan.status = prepareBus(n);
+    if(!plan.status.empty()){
+        return plan;
+    }
+    BusModel &bus = *buses[n];
+    vector<double> windowPrices;
+    for(int k: bus.fleetWindow){
+        windowPrices.push_back(prices.window[k]);
+    }
+    vector<double> chargeTimePrices(prices.chargeTime.begin() + parameters.stopStart[n],
+                                    prices.chargeTime.begin() + parameters.stopStart[n + 1]);
+    bus.problem->priceCouplingRows(windowPrices, chargeTimePrices);
+    return solveModel(bus, *bus.problem, bus.startValues);
+}
+
+/// the restrictions are added to a copy of the model of the bus
+BusPlan MIPSubproblemSolver::solveRestricted(int n, const BusRestrictions &restrictions){
+    BusPlan plan;
+    plan.status = prepareBus(n);
+    if(!plan.status.empty()){
+        return plan;
+    }
+    BusModel &bus = *buses[n];
+    SchedulingProblem restricted = *bus.problem;
+    int numberStops = parameters.numberStops(n);
+    vector<double> windowEnergy;
+    vector<int> busWindow(windows.size(), -1);
+    for(int k = 0; k < bus.fleetWindow.size(); k++){
+        windowEnergy.push_back(restrictions.windowEnergy[bus.fleetWindow[k]]);
+        busWindow[bus.fleetWindow[k]] = k;
+    }
+    restricted.priceCouplingRows(vector<double>(windowEnergy.size(), 0.0), vector<double>(numberStops, 0.0));
+    restricted.limitCleanEnergy(windowEnergy);
+    for(int i = 0; i < numberStops; i++){
+        for(auto &busy: restrictions.busyCharges[i]){
+            restricted.addChargerBusy(i, busy.first, busy.second);
+        }
+    }
+
+    primitiveVariables start = restrictions.start;
+    start.cleanEnergy.clear();
+    for(auto use: restrictions.start.cleanEnergy){
+        if(busWindow[use.window] >= 0){
+            use.window = busWindow[use.window];
+            start.cleanEnergy.push_back(use);
+        }
+    }
+    vector<double> values = restricted.primitiveToColumns(start);
+    return solveModel(bus, restricted, values);
+}
+
+DPSubproblemSolver::DPSubproblemSolver(const ModelParameters &parameters, const RunConfig &config,
+                                       const vector<CleanEnergyWindow> &windows):
+        planner(parameters, config, windows), stopStart(parameters.stopStart){
+}
+
+string DPSubproblemSolver::name() const{
+    return "dp";
+}
+
+BusPlan DPSubproblemSolver::busPlan(int n, const PlanQuery &query) const{
+    BusPlan plan;
+    ChargePlan charges = planner.plan(n, query);
+    plan.solved = charges.feasible;
+    plan.status = charges.feasible ? "Optimal on the grid" : "No schedule on the grid, use a smaller --dpTimeStep";
+    plan.objectiveValue = charges.objectiveValue;
+    /// the grid restricts the schedules of the bus, so the cheapest plan on it can cost more than the cheapest schedule
+    plan.objectiveBound = charges.objectiveValue;
+    plan.boundValid = false;
+    plan.schedule = move(charges.schedule);
+    return plan;
+}
+
+BusPlan DPSubproblemSolver::solve(int n, const CouplingPrices &prices){
+    PlanQuery query;
+    query.windowPrices = prices.window;
+    query.chargeTimePrices.assign(prices.chargeTime.begin() + stopStart[n],
+                                  prices.chargeTime.begin() + stopStart[n + 1]);
+    return busPlan(n, query);
+}
+
+BusPlan DPSubproblemSolver::solveRestricted(int n, const BusRestrictions &restrictions){
+    PlanQuery query;
+    query.windowEnergy = restrictions.windowEnergy;
+    query.busyCharges = restrictions.busyCharges;
+    return busPlan(n, query);
+}
+
+LagrangianDecomposition::LagrangianDecomposition(const ModelParameters &parameters, const RunConfig &config,
+                                                 ostream &out): parameters(parameters), config(config), out(out){
+    this->parameters.setLegs(config.busEnergyCost, config.busSpeed);
+    windows = SchedulingProblem::usedWindows(this->parameters, this->parameters.cleanEnergyWindows);
+    vector<int> chargingStation(this->parameters.numberStations);
+    for(int i = 0; i < this->parameters.chargingStops.size() && i < chargingStation.size(); i++){
+        chargingStation[i] = this->parameters.chargingStops[i];
+    }
+    segments.build(this->parameters, chargingStation, config.deviationTime, config.maxChargeTime,
+                   config.compressStops);
+    findChargerPairs();
+    if(config.subproblemSolver == "dp"){
+        subproblemSolver.reset(new DPSubproblemSolver(this->parameters, config, windows));
+    }
+    else{
+        subproblemSolver.reset(new MIPSubproblemSolver(this->parameters, config, windows));
+    }
+}
+
+void LagrangianDecomposition::setSubproblemSolver(unique_ptr<BusSubproblemSolver> solver){
+    subproblemSolver = move(solver);
+}
+
+/// the pairs of the model (ConflictIndex) at a charging station whose charges can not both take their longest charge
+/// between the earliest arrival and the latest departure of the two stops, the pair row of all others always holds
+void LagrangianDecomposition::findChargerPairs(){
+    ConflictIndex conflictIndex;
+    conflictIndex.build(parameters.stopStart, parameters.stations, parameters.scheduledTimes);
+    chargerPairs.clear();
+    for(auto &pair: conflictIndex.candidatePairs((config.maxChargeTime + config.deviationTime) * 2)){
+        int i = parameters.stopStart[pair.busIndex] + pair.stop;
+        int j = parameters.stopStart[pair.otherBusIndex] + pair.otherStop;
+        if(!segments.isKept(i) || !segments.isKept(j) || segments.chargeLimit[i] == 0.0 ||
+           segments.chargeLimit[j] == 0.0){
+            continue;
+        }
+        double limit = max(segments.departureUpper[i], segments.departureUpper[j]) -
+                       min(segments.arrivalLower[i], segments.arrivalLower[j]);
+        if(limit < segments.chargeLimit[i] + segments.chargeLimit[j]){
+            chargerPairs.push_back({i, j, pair.busIndex, pair.otherBusIndex, limit});
+        }
+    }
+}
+
+/// solve the subproblem of every bus. Returns false if a subproblem could not be solved
+bool LagrangianDecomposition::solveSubproblems(const CouplingPrices &prices, vector<BusPlan> &plans){
+    parallelFor(plans.size(), threads, [&](int n){
+        plans[n] = subproblemSolver->solve(n, prices);
+    });
+    for(int n = 0; n < plans.size(); n++){
+        if(!plans[n].solved){
+            lastStatus = "Subproblem of bus " + to_string(parameters.busKeys[n]) + " was not solved: " +
+                         plans[n].status;
+            return false;
+        }
+    }
+    return true;
+}
+
+/// the greedy heuristic can leave buses below the minimum battery capacity or outside their deviation
+bool LagrangianDecomposition::busFeasible(const primitiveVariables &schedule, int n) const{
+    for(int s = schedule.stopStart[n]; s < schedule.stopStart[n + 1]; s++){
+        if(fabs(schedule.arrivalTime[s] - schedule.scheduledTime[s]) > segments.allowedDeviation[s] + 1e-6){
+            return false;
+        }
+        if(s > schedule.stopStart[n] && segments.isKept(s) && schedule.capacity[s] < config.minBatteryCapacity - 1e-6){
+            return false;
+        }
+    }
+    return true;
+}
+
+/// the charges of a schedule at each station
+static void addCharges(const primitiveVariables &schedule, int n, const vector<int> &stations,
+                       vector<vector<ChargeInterval>> &stationCharges, int busIndex){
+    for(int s = schedule.stopStart[n]; s < schedule.stopStart[n + 1]; s++){
+        if(schedule.charge[s] == 1 && schedule.chargeTime[s] > 0.0){
+            stationCharges[stations[s - schedule.stopStart[n]]].push_back({schedule.arrivalTime[s],
+                                                                           schedule.arrivalTime[s] +
+                                                                           schedule.chargeTime[s], busIndex});
+        }
+    }
+}
+
+/// whether the charges of bus n of a schedule do not overlap with a charge of another bus
+static bool chargersFree(const primitiveVariables &schedule, int n, const vector<int> &stations,
+                         const vector<vector<ChargeInterval>> &stationCharges, int busIndex){
+    for(int s = schedule.stopStart[n]; s < schedule.stopStart[n + 1]; s++){
+        if(schedule.charge[s] != 1 || schedule.chargeTime[s] <= 0.0){
+            continue;
+        }
+        double start = schedule.arrivalTime[s];
+        double end = start + schedule.chargeTime[s];
+        for(auto &busy: stationCharges[stations[s - schedule.stopStart[n]]]){
+            if(busy.busIndex != busIndex && start < busy.end - 1e-9 && busy.start < end - 1e-9){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// the plans which use the most clean energy are taken first, as long as they do not overlap on a charger with the
+/// plans taken before. The greedy heuristic schedules the other buses around them, the clean energy of the taken
+/// plans is cut to what is left of each CEW
+void LagrangianDecomposition::combinePlans(const vector<BusPlan> &plans){
+    int numberBuses = parameters.numberBuses();
+    vector<double> cleanEnergy(numberBuses, 0.0);
+    for(int n = 0; n < numberBuses; n++){
+        for(auto &use: plans[n].schedule.cleanEnergy){
+            cleanEnergy[n] += use.energy;
+        }
+    }
+    vector<int> order(numberBuses);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&cleanEnergy](int a, int b){
+        return cleanEnergy[a] > cleanEnergy[b];
+    });
+
+    /// the taken plans form the previous schedule of the greedy heuristic, all of their stops count as reached
+    primitiveVariables taken;
+    vector<vector<ChargeInterval>> stationCharges(parameters.numberStations);
+    for(int n: order){
+        const primitiveVariables &plan = plans[n].schedule;
+        const vector<int> busStations(parameters.stations.begin() + parameters.stopStart[n],
+                                      parameters.stations.begin() + parameters.stopStart[n + 1]);
+        if(!chargersFree(plan, 0, busStations, stationCharges, n)){
+            continue;
+        }
+        addCharges(plan, 0, busStations, stationCharges, n);
+        taken.buses.push_back(parameters.busKeys[n]);
+        taken.stopStart.push_back(taken.stopStart.back() + plan.numberStops(0));
+        taken.arrivalTime.insert(taken.arrivalTime.end(), plan.arrivalTime.begin(), plan.arrivalTime.end());
+        taken.capacity.insert(taken.capacity.end(), plan.capacity.begin(), plan.capacity.end());
+        taken.chargeTime.insert(taken.chargeTime.end(), plan.chargeTime.begin(), plan.chargeTime.end());
+        taken.chargeAmount.insert(taken.chargeAmount.end(), plan.chargeAmount.begin(), plan.chargeAmount.end());
+        taken.nonRenewable.insert(taken.nonRenewable.end(), plan.nonRenewable.begin(), plan.nonRenewable.end());
+    }
+    GreedyScheduler heuristic(config);
+    primitiveVariables candidate = heuristic.buildSchedule(parameters, windows, &taken, INFINITE_BOUND);
+    for(int n = 0; n < numberBuses; n++){
+        if(!busFeasible(candidate, n)){
+            return;
+        }
+    }
+    double candidateNonRenewable = accumulate(candidate.nonRenewable.begin(), candidate.nonRenewable.end(), 0.0);
+    if(candidateNonRenewable < bestUpperBound - 1e-9){
+        incumbent = candidate;
+        incumbentFeasible = vector<char>(numberBuses, 1);
+        bestUpperBound = candidateNonRenewable;
+    }
+}
+
+/// the clean energy each bus of a schedule uses from each CEW, and its charges at each station
+static void scheduleUsage(const primitiveVariables &schedule, const vector<int> &stations, int numberWindows,
+                          vector<double> &windowUsed, vector<vector<double>> &busWindowUsed,
+                          vector<vector<ChargeInterval>> &stationCharges){
+    int numberBuses = schedule.buses.size();
+    windowUsed = vector<double>(numberWindows, 0.0);
+    busWindowUsed = vector<vector<double>>(numberBuses, vector<double>(numberWindows, 0.0));
+    for(auto &use: schedule.cleanEnergy){
+        windowUsed[use.window] += use.energy;
+        busWindowUsed[use.bus][use.window] += use.energy;
+    }
+    for(auto &charges: stationCharges){
+        charges.clear();
+    }
+    for(int n = 0; n < numberBuses; n++){
+        const vector<int> busStations(stations.begin() + schedule.stopStart[n],
+                                      stations.begin() + schedule.stopStart[n + 1]);
+        addCharges(schedule, n, busStations, stationCharges, n);
+    }
+}
+
+/// the plans of the buses in order replace their schedule in the incumbent if they improve it and keep it feasible. A
+/// plan may not overlap with a charge of another bus, its clean energy is cut to what the other buses leave of each
+/// CEW and the cut energy is counted as non-clean energy. Returns the buses whose plan was not used
+vector<int> LagrangianDecomposition::applyPlans(const vector<BusPlan> &plans, const vector<int> &order){
+    int numberWindows = windows.size();
+    vector<double> windowUsed;
+    vector<vector<double>> busWindowUsed;
+    vector<vector<ChargeInterval>> stationCharges(parameters.numberStations);
+    scheduleUsage(incumbent, parameters.stations, numberWindows, windowUsed, busWindowUsed, stationCharges);
+    vector<int> unused;
+    for(int n: order){
+        if(!plans[n].solved){
+            unused.push_back(n);
+            continue;
+        }
+        primitiveVariables candidate = plans[n].schedule;
+        int first = parameters.stopStart[n];
+        const vector<int> busStations(parameters.stations.begin() + first,
+                                      parameters.stations.begin() + parameters.stopStart[n + 1]);
+        if(!chargersFree(candidate, 0, busStations, stationCharges, n)){
+            unused.push_back(n);
+            continue;
+        }
+
+        /// the clean energy the other buses leave of each CEW
+        vector<double> available(numberWindows);
+        for(int k = 0; k < numberWindows; k++){
+            available[k] = windows[k].availableEnergy - windowUsed[k] + busWindowUsed[n][k];
+        }
+        for(auto &use: candidate.cleanEnergy){
+            double energy = min(use.energy, max(0.0, available[use.window]));
+            candidate.nonRenewable[use.stop] += use.energy - energy;
+            use.energy = energy;
+            available[use.window] -= energy;
+        }
+        double candidateNonRenewable = accumulate(candidate.nonRenewable.begin(), candidate.nonRenewable.end(), 0.0);
+        double busNonRenewable = accumulate(incumbent.nonRenewable.begin() + first,
+                                            incumbent.nonRenewable.begin() + parameters.stopStart[n + 1], 0.0);
+        if(incumbentFeasible[n] && candidateNonRenewable >= busNonRenewable - 1e-9){
+            unused.push_back(n);
+            continue;
+        }
+
+        /// the plan replaces the schedule of bus n
+        for(int i = 0; i < candidate.numberStops(0); i++){
+            incumbent.arrivalTime[first + i] = candidate.arrivalTime[i];
+            incumbent.deviationTime[first + i] = candidate.deviationTime[i];
+            incumbent.capacity[first + i] = candidate.capacity[i];
+            incumbent.chargeTime[first + i] = candidate.chargeTime[i];
+            incumbent.chargeAmount[first + i] = candidate.chargeAmount[i];
+            incumbent.charge[first + i] = candidate.charge[i];
+            incumbent.nonRenewable[first + i] = candidate.nonRenewable[i];
+            if(!incumbent.ases.empty() && !candidate.ases.empty()){
+                incumbent.ases[first + i] = candidate.ases[i];
+                incumbent.discounts[first + i] = candidate.discounts[i];
+            }
+        }
+        incumbent.cleanEnergy.erase(remove_if(incumbent.cleanEnergy.begin(), incumbent.cleanEnergy.end(),
+                                              [n](const CleanEnergyUse &use){ return use.bus == n; }),
+                                    incumbent.cleanEnergy.end());
+        for(int k = 0; k < numberWindows; k++){
+            windowUsed[k] -= busWindowUsed[n][k];
+            busWindowUsed[n][k] = 0.0;
+        }
+        for(auto use: candidate.cleanEnergy){
+            use.bus = n;
+            incumbent.cleanEnergy.push_back(use);
+            windowUsed[use.window] += use.energy;
+            busWindowUsed[n][use.window] += use.energy;
+        }
+        for(auto &charges: stationCharges){
+            charges.erase(remove_if(charges.begin(), charges.end(),
+                                    [n](const ChargeInterval &charge){ return charge.busIndex == n; }),
+                          charges.end());
+        }
+        addCharges(incumbent, n, busStations, stationCharges, n);
+        incumbentFeasible[n] = 1;
+    }
+    if(count(incumbentFeasible.begin(), incumbentFeasible.end(), 0) == 0){
+        bestUpperBound = accumulate(incumbent.nonRenewable.begin(), incumbent.nonRenewable.end(), 0.0);
+    }
+    return unused;
+}
+
+/// the clean energy and the chargers the other buses of the incumbent leave to each of the buses
+vector<BusRestrictions> LagrangianDecomposition::restrictions(const vector<int> &buses) const{
+    int numberWindows = windows.size();
+    vector<double> windowUsed;
+    vector<vector<double>> busWindowUsed;
+    vector<vector<ChargeInterval>> stationCharges(parameters.numberStations);
+    scheduleUsage(incumbent, parameters.stations, numberWindows, windowUsed, busWindowUsed, stationCharges);
+    vector<BusRestrictions> busRestrictions(buses.size());
+    for(int r = 0; r < buses.size(); r++){
+        busRestrictions[r] = restrictions(buses[r], windowUsed, busWindowUsed, stationCharges);
+    }
+    return busRestrictions;
+}
+
+BusRestrictions LagrangianDecomposition::restrictions(int n, const vector<double> &windowUsed,
+                                                      const vector<vector<double>> &busWindowUsed,
+                                                      const vector<vector<ChargeInterval>> &stationCharges) const{
+    int numberWindows = windows.size();
+    BusRestrictions restrictions;
+    for(int k = 0; k < numberWindows; k++){
+        restrictions.windowEnergy.push_back(windows[k].availableEnergy - windowUsed[k] + busWindowUsed[n][k]);
+    }
+    int first = parameters.stopStart[n];
+    int end = parameters.stopStart[n + 1];
+    restrictions.busyCharges.resize(end - first);
+    for(int s = first; s < end; s++){
+        if(!segments.isKept(s) || segments.chargeLimit[s] == 0.0){
+            continue;
+        }
+        for(auto &busy: stationCharges[parameters.stations[s]]){
+            if(busy.busIndex != n && busy.end > segments.arrivalLower[s] && busy.start < segments.departureUpper[s]){
+                restrictions.busyCharges[s - first].push_back({busy.start, busy.end});
+            }
+        }
+    }
+
+    /// the schedule of bus n alone
+    primitiveVariables &start = restrictions.start;
+    start.buses = {parameters.busKeys[n]};
+    start.stopStart = {0, end - first};
+    auto slice = [first, end](const auto &values){
+        return vector<typename decay_t<decltype(values)>::value_type>(values.begin() + first, values.begin() + end);
+    };
+    start.busSequences = slice(incumbent.busSequences);
+    start.scheduledTime = slice(incumbent.scheduledTime);
+    start.arrivalTime = slice(incumbent.arrivalTime);
+    start.deviationTime = slice(incumbent.deviationTime);
+    start.capacity = slice(incumbent.capacity);
+    start.chargeTime = slice(incumbent.chargeTime);
+    start.chargeAmount = slice(incumbent.chargeAmount);
+    start.charge = slice(incumbent.charge);
+    start.nonRenewable = slice(incumbent.nonRenewable);
+    if(!incumbent.ases.empty()){
+        start.ases = slice(incumbent.ases);
+        start.discounts = slice(incumbent.discounts);
+    }
+    for(auto use: incumbent.cleanEnergy){
+        if(use.bus == n){
+            use.bus = 0;
+            start.cleanEnergy.push_back(use);
+        }
+    }
+    return restrictions;
+}
+
+/// the plans which save the most non-clean energy replace the schedules of the incumbent first. The buses whose plan
+/// could not be used are solved again with what the other buses of the incumbent leave them, which always keeps the
+/// incumbent feasible
+void LagrangianDecomposition::exchangePlans(const vector<BusPlan> &plans){
+    int numberBuses = parameters.numberBuses();
+    vector<int> order;
+    vector<double> saving(numberBuses);
+    for(int n = 0; n < numberBuses; n++){
+        double busNonRenewable = accumulate(incumbent.nonRenewable.begin() + parameters.stopStart[n],
+                                            incumbent.nonRenewable.begin() + parameters.stopStart[n + 1], 0.0);
+        double planNonRenewable = accumulate(plans[n].schedule.nonRenewable.begin(),
+                                             plans[n].schedule.nonRenewable.end(), 0.0);
+        saving[n] = incumbentFeasible[n] ? busNonRenewable - planNonRenewable : INFINITE_BOUND;
+        if(saving[n] > 1e-9){
+            order.push_back(n);
+        }
+    }
+    stable_sort(order.begin(), order.end(), [&saving](int a, int b){
+        return saving[a] > saving[b];
+    });
+    vector<int> unused = applyPlans(plans, order);
+    if(unused.empty()){
+        return;
+    }
+
+    vector<BusRestrictions> busRestrictions = restrictions(unused);
+    vector<BusPlan> restrictedPlans(numberBuses);
+    parallelFor(unused.size(), threads, [&](int u){
+        restrictedPlans[unused[u]] = subproblemSolver->solveRestricted(unused[u], busRestrictions[u]);
+    });
+    applyPlans(restrictedPlans, unused);
+}
+
+primitiveVariables LagrangianDecomposition::run(){
+    auto startTime = chrono::steady_clock::now();
+    int numberBuses = parameters.numberBuses();
+    int numberWindows = windows.size();
+    threads = config.threads > 0 ? config.threads : max(1, (int) thread::hardware_concurrency());
+    out << "Lagrangian decomposition: " << numberBuses << " buses, " << numberWindows << " CEW, "
+        << chargerPairs.size() << " charger pairs, " << threads << " threads, subproblems solved by "
+        << subproblemSolver->name() << endl;
+
+    /// the greedy schedule is the first incumbent, its infeasible buses have to be replaced by a plan
+    GreedyScheduler heuristic(config);
+    incumbent = heuristic.buildSchedule(parameters, windows);
+    incumbentFeasible = vector<char>(numberBuses);
+    for(int n = 0; n < numberBuses; n++){
+        incumbentFeasible[n] = busFeasible(incumbent, n);
+    }
+    bestLowerBound = -INFINITE_BOUND;
+    boundValid = true;
+    bestUpperBound = count(incumbentFeasible.begin(), incumbentFeasible.end(), 0) == 0 ?
+                     accumulate(incumbent.nonRenewable.begin(), incumbent.nonRenewable.end(), 0.0) : INFINITE_BOUND;
+    numberIterations = 0;
+    lastStatus = "Iteration limit";
+
+    CouplingPrices prices;
+    prices.window = vector<double>(numberWindows, 0.0);
+    prices.chargeTime = vector<double>(parameters.totalStops(), 0.0);
+    vector<double> pairPrices(chargerPairs.size(), 0.0);
+    vector<double> windowGradient(numberWindows);
+    vector<double> pairGradient(chargerPairs.size());
+    vector<BusPlan> plans(numberBuses);
+    double stepScale = 2.0;
+    int stalled = 0;
+
+    for(int iteration = 0; iteration < config.decompositionIterations; iteration++){
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+        if(config.timeout > 0 && elapsed >= config.timeout){
+            lastStatus = "Time limit";
+            break;
+        }
+        if(!solveSubproblems(prices, plans)){
+            break;
+        }
+        numberIterations++;
+
+        /// the bound of the relaxation, and the violation of each relaxed row by the plans as the subgradient. A row
+        /// whose multiplier is 0 and which holds does not move its multiplier
+        double bound = 0.0;
+        bool planBoundsValid = true;
+        for(auto &plan: plans){
+            bound += plan.objectiveBound;
+            planBoundsValid = planBoundsValid && plan.boundValid;
+        }
+        if(boundValid && !planBoundsValid){
+            out << "The bounds of the " << subproblemSolver->name() << " subproblems are estimates, the bound is only "
+                << "used for the steps and not for the gap" << endl;
+            boundValid = false;
+        }
+        fill(windowGradient.begin(), windowGradient.end(), 0.0);
+        for(int n = 0; n < numberBuses; n++){
+            for(auto &use: plans[n].schedule.cleanEnergy){
+                windowGradient[use.window] += use.energy;
+            }
+        }
+        double norm = 0.0;
+        for(int k = 0; k < numberWindows; k++){
+            bound -= prices.window[k] * windows[k].availableEnergy;
+            windowGradient[k] -= windows[k].availableEnergy;
+            if(prices.window[k] == 0.0 && windowGradient[k] < 0.0){
+                windowGradient[k] = 0.0;
+            }
+            norm += windowGradient[k] * windowGradient[k];
+        }
+        for(int p = 0; p < chargerPairs.size(); p++){
+            const ChargerPair &pair = chargerPairs[p];
+            bound -= pairPrices[p] * pair.limit;
+            const primitiveVariables &plan = plans[pair.busIndex].schedule;
+            const primitiveVariables &otherPlan = plans[pair.otherBusIndex].schedule;
+            pairGradient[p] = plan.chargeTime[pair.stop - parameters.stopStart[pair.busIndex]] +
+                              otherPlan.chargeTime[pair.otherStop - parameters.stopStart[pair.otherBusIndex]] -
+                              pair.limit;
+            if(pairPrices[p] == 0.0 && pairGradient[p] < 0.0){
+                pairGradient[p] = 0.0;
+            }
+            norm += pairGradient[p] * pairGradient[p];
+        }
+
+        combinePlans(plans);
+        exchangePlans(plans);
+        if(bound > bestLowerBound + 1e-9){
+            bestLowerBound = bound;
+            stalled = 0;
+        }
+        else if(++stalled >= STALLED_ITERATIONS){
+            stepScale /= 2.0;
+            stalled = 0;
+        }
+        out << "Iteration " << iteration << "\tBound: " << bound << "\tBest bound: " << bestLowerBound
+            << "\tBest schedule: " << bestUpperBound << "\tTime (s): "
+            << chrono::duration<double>(chrono::steady_clock::now() - startTime).count() << endl;
+
+        if(boundValid && bestUpperBound != INFINITE_BOUND &&
+           bestLowerBound > bestUpperBound + GAP_TOLERANCE * max(1.0, bestUpperBound)){
+            out << "Warning: the bound " << bestLowerBound << " is above the best schedule " << bestUpperBound
+                << ", it is not a lower bound and is not used for the gap" << endl;
+            boundValid = false;
+        }
+
+        /// without a violated row the plans are optimal for the relaxation, the bound can not be improved
+        if(boundValid && relativeGap() <= GAP_TOLERANCE){
+            lastStatus = "Optimal within tolerance";
+            break;
+        }
+        if(norm == 0.0){
+            lastStatus = "Relaxation solved";
+            break;
+        }
+
+        /// Polyak step towards the best schedule, or slightly above the bound while there is none
+        double target = bestUpperBound != INFINITE_BOUND ? bestUpperBound : bound + max(1.0, 0.05 * fabs(bound));
+        double step = stepScale * (target - bound) / norm;
+        for(int k = 0; k < numberWindows; k++){
+            prices.window[k] = min(MAX_WINDOW_PRICE, max(0.0, prices.window[k] + step * windowGradient[k]));
+        }
+        fill(prices.chargeTime.begin(), prices.chargeTime.end(), 0.0);
+        for(int p = 0; p < chargerPairs.size(); p++){
+            pairPrices[p] = max(0.0, pairPrices[p] + step * pairGradient[p]);
+            prices.chargeTime[chargerPairs[p].stop] += pairPrices[p];
+            prices.chargeTime[chargerPairs[p].otherStop] += pairPrices[p];
+        }
+    }
+
+    out << "Lagrangian decomposition: " << lastStatus << "\tIterations: " << numberIterations << "\tLower bound: "
+        << lowerBound() << "\tBest schedule: " << bestUpperBound << "\tGap: " << relativeGap();
+    if(!boundValid){
+        out << "\tBound estimate: " << bestLowerBound;
+    }
+    out << endl;
+    if(bestUpperBound == INFINITE_BOUND){
+        lastStatus += ", no feasible schedule found";
+        return primitiveVariables();
+    }
+    return incumbent;
+}
+
+double LagrangianDecomposition::lowerBound() const{
+    return boundValid ? bestLowerBound : 0.0;
+}
+
+double LagrangianDecomposition::upperBound() const{
+    return bestUpperBound;
+}
+
+/// the objective can not be negative, so 0 is a lower bound before the first iteration and without a valid bound
+double LagrangianDecomposition::relativeGap() const{
+    if(bestUpperBound == INFINITE_BOUND){
+        return INFINITE_BOUND;
+    }
+    if(bestUpperBound <= 1e-9){
+        return 0.0;
+    }
+    return max(0.0, (bestUpperBound - max(lowerBound(), 0.0)) / bestUpperBound);
+}
+
+const string &LagrangianDecomposition::status() const{
+    return lastStatus;
+}
+
+int LagrangianDecomposition::iterations() const{
+    return numberIterations;
+}
+
+const vector<CleanEnergyWindow> &LagrangianDecomposition::cleanEnergyWindows() const{
+    return windows;
+}
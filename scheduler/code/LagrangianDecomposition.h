@@ -0,0 +1,193 @@
+#ifndef SCHEDULER_LAGRANGIAN_DECOMPOSITION_H
+#define SCHEDULER_LAGRANGIAN_DECOMPOSITION_H
+#include "vector"
+#include "string"
+#include "memory"
+#include "functional"
+#include "sstream"
+#include "iostream"
+#include "DataStructures.h"
+#include "RunConfig.h"
+#include "SolverBackend.h"
+#include "SchedulingProblem.h"
+#include "BusChargePlanner.h"
+
+using namespace std;
+
+/// a charge of a schedule, start and end of the charge time at a station
+struct ChargeInterval{
+    double start;
+    double end;
+    int busIndex;
+};
+
+/// the multipliers of the coupling rows which are relaxed, see LagrangianDecomposition
+struct CouplingPrices{
+    /// \lambda_k the price of a kWh of clean energy used from CEW k
+    vector<double> window;
+
+    /// the price of an hour of charge time at each stop, the sum of the multipliers of the charger pairs of the stop
+    vector<double> chargeTime;
+};
+
+/// the schedule of one bus which is optimal for the prices
+struct BusPlan{
+    bool solved = false;
+    string status;
+
+    /// the priced objective of the plan, and a lower bound on the priced objective of every schedule of the bus.
+    /// boundValid is false if objectiveBound is only an estimate, like the value of a plan on the grid of the DP
+    double objectiveValue = 0.0;
+    double objectiveBound = 0.0;
+    bool boundValid = true;
+
+    /// the schedule of the bus alone (bus index 0), the window of each CleanEnergyUse is the index of the CEW in the
+    /// CEW of the whole fleet
+    primitiveVariables schedule;
+};
+
+/// what the other buses of a schedule leave to a bus, used to repair a schedule one bus at a time
+struct BusRestrictions{
+    /// the clean energy the bus may use from each CEW of the fleet
+    vector<double> windowEnergy;
+
+    /// for each stop of the bus, start and end of the charges of other buses at its charger
+    vector<vector<pair<double, double>>> busyCharges;
+
+    /// the schedule of the bus alone, with the windows of the fleet, which is used as the start
+    primitiveVariables start;
+};
+
+/// solves the subproblem of a single bus: the model of the bus with the coupling rows replaced by their prices. A bus
+/// is only solved by one thread at a time, so implementations only have to keep the state of each bus apart
+class BusSubproblemSolver{
+public:
+    virtual ~BusSubproblemSolver() = default;
+    virtual string name() const = 0;
+
+    /// n is the bus index in the parameters of the fleet
+    virtual BusPlan solve(int n, const CouplingPrices &prices) = 0;
+
+    /// the schedule of bus n with the least non-clean energy which keeps to the restrictions, without prices
+    virtual BusPlan solveRestricted(int n, const BusRestrictions &restrictions) = 0;
+};
+
+/// the subproblems as the SchedulingProblem of a single bus, solved by the configured solver backend. The model of a
+/// bus is built when it is solved first, later solves only change the objective and start from the previous plan
+class MIPSubproblemSolver: public BusSubproblemSolver{
+public:
+    /// parameters holds the whole fleet and windows its CEW (SchedulingProblem::usedWindows)
+    MIPSubproblemSolver(const ModelParameters &parameters, const RunConfig &config,
+                        const vector<CleanEnergyWindow> &windows);
+    string name() const override;
+    BusPlan solve(int n, const CouplingPrices &prices) override;
+    BusPlan solveRestricted(int n, const BusRestrictions &restrictions) override;
+
+private:
+    struct BusModel{
+        unique_ptr<SchedulingProblem> problem;
+        unique_ptr<SolverBackend> backend;
+
+        /// the CEW of the fleet for each CEW of the bus, and the values of the previous plan
+        vector<int> fleetWindow;
+        vector<double> startValues;
+        stringstream log;
+    };
+    string prepareBus(int n);
+    BusPlan solveModel(BusModel &bus, SchedulingProblem &problem, vector<double> &values);
+
+    const ModelParameters &parameters;
+    RunConfig config;
+    vector<CleanEnergyWindow> windows;
+    string backendName;
+    vector<unique_ptr<BusModel>> buses;
+};
+
+/// the subproblems solved by BusChargePlanner, without a solver backend. Its plans are the optimum on its grid, so the
+/// lower bound of the decomposition holds for the schedules on that grid
+class DPSubproblemSolver: public BusSubproblemSolver{
+public:
+    DPSubproblemSolver(const ModelParameters &parameters, const RunConfig &config,
+                       const vector<CleanEnergyWindow> &windows);
+    string name() const override;
+    BusPlan solve(int n, const CouplingPrices &prices) override;
+    BusPlan solveRestricted(int n, const BusRestrictions &restrictions) override;
+
+private:
+    BusPlan busPlan(int n, const PlanQuery &query) const;
+
+    BusChargePlanner planner;
+    vector<int> stopStart;
+};
+
+/// Solves a horizon without the model of the whole fleet. The buses are only coupled by the CEW capacity (3.27) and
+/// by the chargers they share (3.10-3.15). The capacity rows are relaxed with a multiplier per CEW. The non-overlap
+/// rows are replaced by the weaker pair rows ct_bi + ct_dj <= L, with L the time from the earliest arrival to the
+/// latest departure of the two stops, which are relaxed with a multiplier per pair. What remains are the subproblems
+/// of the single buses, which are solved in parallel. The sum of their bounds minus the priced right hand sides is a
+/// lower bound on the objective, the multipliers are improved with subgradient steps. The plans of each iteration are
+/// repaired into feasible schedules of the fleet, see combinePlans and exchangePlans, the best one is kept.
+class LagrangianDecomposition{
+public:
+    LagrangianDecomposition(const ModelParameters &parameters, const RunConfig &config, ostream &out = cout);
+
+    /// replace the solver of the subproblems, which is chosen by --subproblemSolver
+    void setSubproblemSolver(unique_ptr<BusSubproblemSolver> solver);
+
+    /// returns the best schedule found, which has no buses if no feasible schedule was found
+    primitiveVariables run();
+
+    /// the best lower bound, 0 if the bounds of the iterations are not valid (see boundValid)
+    double lowerBound() const;
+    double upperBound() const;
+
+    /// the gap of the best schedule to lowerBound, which is never negative
+    double relativeGap() const;
+    const string &status() const;
+    int iterations() const;
+
+    /// the CEW of the fleet, the windows of the schedules refer to them
+    const vector<CleanEnergyWindow> &cleanEnergyWindows() const;
+
+private:
+    /// the pair row of two stops of different buses at the same charger
+    struct ChargerPair{
+        int stop;
+        int otherStop;
+        int busIndex;
+        int otherBusIndex;
+        double limit;
+    };
+    void findChargerPairs();
+    bool solveSubproblems(const CouplingPrices &prices, vector<BusPlan> &plans);
+    bool busFeasible(const primitiveVariables &schedule, int n) const;
+    void combinePlans(const vector<BusPlan> &plans);
+    void exchangePlans(const vector<BusPlan> &plans);
+    vector<int> applyPlans(const vector<BusPlan> &plans, const vector<int> &order);
+    vector<BusRestrictions> restrictions(const vector<int> &buses) const;
+    BusRestrictions restrictions(int n, const vector<double> &windowUsed, const vector<vector<double>> &busWindowUsed,
+                                 const vector<vector<ChargeInterval>> &stationCharges) const;
+
+    ModelParameters parameters;
+    RunConfig config;
+    ostream &out;
+    vector<CleanEnergyWindow> windows;
+    StopSegments segments;
+    vector<ChargerPair> chargerPairs;
+    unique_ptr<BusSubproblemSolver> subproblemSolver;
+    int threads = 1;
+
+    /// the best feasible schedule, and whether each of its buses is feasible
+    primitiveVariables incumbent;
+    vector<char> incumbentFeasible;
+
+    /// the best bound of the iterations, which is only a lower bound while boundValid. A bound above the best
+    /// schedule shows that the subproblems were not solved to optimality, it is then only used for the steps
+    double bestLowerBound = 0.0;
+    double bestUpperBound = INFINITE_BOUND;
+    bool boundValid = true;
+    int numberIterations = 0;
+    string lastStatus;
+};
+
+#endif //SCHEDULER_LAGRANGIAN_DECOMPOSITION_H
@@ -0,0 +1,129 @@
+#include "MappedCSV.h"
+#include "algorithm"
+#include "charconv"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+MappedCSV::~MappedCSV(){
+    close();
+}
+
+void MappedCSV::close(){
+    if(data != nullptr){
+        munmap((void *) data, size);
+    }
+    data = nullptr;
+    size = 0;
+    chunks.clear();
+    rows = 0;
+}
+
+bool MappedCSV::open(string fileName, string &error, uint64_t chunkBytes){
+    close();
+    error.clear();
+    int descriptor = ::open(fileName.c_str(), O_RDONLY);
+    if(descriptor < 0){
+        error = fileName + " can not be opened";
+        return false;
+    }
+    struct stat status;
+    if(fstat(descriptor, &status) != 0){
+        ::close(descriptor);
+        error = fileName + " can not be read";
+        return false;
+    }
+    size = status.st_size;
+    if(size == 0){
+        ::close(descriptor);
+        return true;
+    }
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if(mapping == MAP_FAILED){
+        size = 0;
+        error = fileName + " can not be mapped";
+        return false;
+    }
+    data = static_cast<const char *>(mapping);
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    /// the rows start after the header, the chunks end after a line break so no line is split
+    const char *headerEnd = static_cast<const char *>(memchr(data, '\n', size));
+    uint64_t begin = headerEnd == nullptr ? size : headerEnd - data + 1;
+    while(begin < size){
+        uint64_t end = min(size, begin + max(chunkBytes, (uint64_t) 1));
+        const char *lineEnd = end == size ? nullptr : static_cast<const char *>(memchr(data + end - 1, '\n',
+                                                                                         size - end + 1));
+        end = lineEnd == nullptr ? size : lineEnd - data + 1;
+        long chunkRows = count(data + begin, data + end, '\n') + (data[end - 1] == '\n' ? 0 : 1);
+        chunks.push_back({begin, end, rows});
+        rows += chunkRows;
+        begin = end;
+    }
+    return true;
+}
+
+long MappedCSV::numberRows() const{
+    return rows;
+}
+
+int MappedCSV::threadCount(int threads, int numberChunks){
+    if(threads <= 0){
+        threads = max(1, (int) thread::hardware_concurrency());
+    }
+    return max(1, min(threads, numberChunks));
+}
+
+/// spaces and carriage returns around a field
+static string_view trim(string_view field){
+    while(!field.empty() && (field.front() == ' ' || field.front() == '\r')){
+        field.remove_prefix(1);
+    }
+    while(!field.empty() && (field.back() == ' ' || field.back() == '\r')){
+        field.remove_suffix(1);
+    }
+    return field;
+}
+
+void MappedCSV::splitFields(string_view line, vector<string_view> &fields){
+    fields.clear();
+    if(!line.empty() && line.back() == '\r'){
+        line.remove_suffix(1);
+    }
+    while(!line.empty()){
+        size_t comma = line.find(',');
+        fields.push_back(trim(line.substr(0, comma)));
+        if(comma == string_view::npos){
+            break;
+        }
+        line.remove_prefix(comma + 1);
+    }
+}
+
+bool MappedCSV::toInt(string_view field, int &value){
+    if(!field.empty() && field.front() == '+'){
+        field.remove_prefix(1);
+    }
+    from_chars_result result = from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == errc() && result.ptr != field.data();
+}
+
+bool MappedCSV::toFloat(string_view field, float &value){
+    if(!field.empty() && field.front() == '+'){
+        field.remove_prefix(1);
+    }
+    from_chars_result result = from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == errc() && result.ptr != field.data();
+}
+
+bool MappedCSV::toDouble(string_view field, double &value){
+    if(!field.empty() && field.front() == '+'){
+        field.remove_prefix(1);
+    }
+    from_chars_result result = from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == errc() && result.ptr != field.data();
+}
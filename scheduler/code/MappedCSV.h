@@ -0,0 +1,111 @@
+#ifndef SCHEDULER_MAPPED_CSV_H
+#define SCHEDULER_MAPPED_CSV_H
+#include "string"
+#include "string_view"
+#include "vector"
+#include "cstdint"
+#include "cstring"
+#include "atomic"
+#include "thread"
+
+using namespace std;
+
+/// a range of whole lines of the file, parsed by one thread
+struct CSVChunk{
+    uint64_t begin;
+    uint64_t end;
+    /// the index of the first row of the chunk
+    long firstRow;
+};
+
+/// CSV file which is read through a memory mapping. The rows after the header are split into chunks of whole lines,
+/// which are tokenized in place and handed to a function with the index of the row, so the values can be converted
+/// into preallocated columns by several threads. Fields are split by "," and trimmed of spaces and "\r"; a trailing
+/// empty field is dropped, as getline did for FileReader::readCSV.
+class MappedCSV{
+public:
+    MappedCSV() = default;
+    ~MappedCSV();
+    MappedCSV(const MappedCSV &) = delete;
+    MappedCSV &operator=(const MappedCSV &) = delete;
+
+    /// maps the file and finds the chunks, error describes the problem if false is returned. Files smaller than
+    /// chunkBytes are a single chunk
+    bool open(string fileName, string &error, uint64_t chunkBytes = 1 << 22);
+    void close();
+
+    /// the number of rows after the header
+    long numberRows() const;
+
+    /// calls rowFunction(row, fields) for every row, the chunks are divided between the given number of threads (all
+    /// cores if 0). rowFunction returns false to stop at a row it can not read, that row is given by failedRow
+    template <class RowFunction>
+    bool forEachRow(RowFunction rowFunction, int threads, long &failedRow) const;
+
+    /// the conversions used for the columns, false if the field is not a number
+    static bool toInt(string_view field, int &value);
+    static bool toFloat(string_view field, float &value);
+    static bool toDouble(string_view field, double &value);
+
+private:
+    static void splitFields(string_view line, vector<string_view> &fields);
+    template <class RowFunction>
+    long parseChunk(const CSVChunk &chunk, RowFunction &rowFunction) const;
+    static int threadCount(int threads, int numberChunks);
+
+    const char *data = nullptr;
+    uint64_t size = 0;
+    vector<CSVChunk> chunks;
+    long rows = 0;
+};
+
+/// the rows of one chunk, the row which could not be read or -1
+template <class RowFunction>
+long MappedCSV::parseChunk(const CSVChunk &chunk, RowFunction &rowFunction) const{
+    vector<string_view> fields;
+    long row = chunk.firstRow;
+    uint64_t position = chunk.begin;
+    while(position < chunk.end){
+        const char *lineEnd = static_cast<const char *>(memchr(data + position, '\n', chunk.end - position));
+        uint64_t end = lineEnd == nullptr ? chunk.end : lineEnd - data;
+        splitFields(string_view(data + position, end - position), fields);
+        if(!rowFunction(row, fields)){
+            return row;
+        }
+        row++;
+        position = end + 1;
+    }
+    return -1;
+}
+
+/// rowFunction is shared by the threads, it may only write to the parts of its output which belong to the row
+template <class RowFunction>
+bool MappedCSV::forEachRow(RowFunction rowFunction, int threads, long &failedRow) const{
+    vector<long> failed(chunks.size(), -1);
+    atomic<int> nextChunk(0);
+    auto parseChunks = [&](){
+        for(int c = nextChunk++; c < chunks.size(); c = nextChunk++){
+            failed[c] = parseChunk(chunks[c], rowFunction);
+        }
+    };
+    vector<thread> workers;
+    for(int t = 1; t < threadCount(threads, chunks.size()); t++){
+        workers.emplace_back(parseChunks);
+    }
+    parseChunks();
+    for(auto &worker: workers){
+        worker.join();
+    }
+
+    /// the first row which failed in file order
+    failedRow = -1;
+    for(long row: failed){
+        if(row >= 0){
+            failedRow = row;
+            break;
+        }
+    }
+    return failedRow < 0;
+}
+
+#endif //SCHEDULER_MAPPED_CSV_H
@@ -0,0 +1,106 @@
+#include "ModelIR.h"
+#include "cmath"
+
+using namespace std;
+
+int ModelIR::addColumn(double lower, double upper, char type, const string &name, double objectiveValue){
+    columnLower.push_back(lower);
+    columnUpper.push_back(upper);
+    columnType.push_back(type);
+    objective.push_back(objectiveValue);
+    columnNames.push_back(name);
+    return columnLower.size() - 1;
+}
+
+/// add the row terms <= rhs ('L'), terms >= rhs ('G') or terms == rhs ('E')
+int ModelIR::addRow(initializer_list<Term> terms, char sense, double rhs, const string &name){
+    for(auto &term: terms){
+        rowIndex.push_back(term.column);
+        rowValue.push_back(term.value);
+    }
+    finishRow(sense, rhs, name);
+    return rowLower.size() - 1;
+}
+
+int ModelIR::addRow(const vector<Term> &terms, char sense, double rhs, const string &name){
+    for(auto &term: terms){
+        rowIndex.push_back(term.column);
+        rowValue.push_back(term.value);
+    }
+    finishRow(sense, rhs, name);
+    return rowLower.size() - 1;
+}
+
+/// add the row terms <= rhs, terms >= rhs or terms == rhs which only has to hold while the binary column indicator
+/// has the given value
+int ModelIR::addIndicatorRow(int indicator, int value, const vector<Term> &terms, char sense, double rhs,
+                             const string &name){
+    int row = addRow(terms, sense, rhs, name);
+    rowIndicator[row] = indicator;
+    rowIndicatorValue[row] = value;
+    numberIndicatorRows++;
+    return row;
+}
+
+void ModelIR::finishRow(char sense, double rhs, const string &name){
+    rowStart.push_back(rowIndex.size());
+    rowLower.push_back(sense == 'L' ? -INFINITE_BOUND : rhs);
+    rowUpper.push_back(sense == 'G' ? INFINITE_BOUND : rhs);
+    rowNames.push_back(name);
+    rowIndicator.push_back(NO_COLUMN);
+    rowIndicatorValue.push_back(0);
+}
+
+int ModelIR::numberColumns() const{
+    return columnLower.size();
+}
+
+int ModelIR::numberRows() const{
+    return rowLower.size();
+}
+
+long ModelIR::numberNonzeros() const{
+    return rowIndex.size();
+}
+
+/// names are optional, unnamed columns and rows get a name based on their index
+string ModelIR::columnName(int column) const{
+    return columnNames[column].empty() ? "C" + to_string(column) : columnNames[column];
+}
+
+string ModelIR::rowName(int row) const{
+    return rowNames[row].empty() ? "R" + to_string(row) : rowNames[row];
+}
+
+bool ModelIR::isIndicatorRow(int row) const{
+    return rowIndicator[row] != NO_COLUMN;
+}
+
+bool ModelIR::hasIndicatorRows() const{
+    return numberIndicatorRows > 0;
+}
+
+/// the number of column bounds, integrality requirements and rows which the given values do not satisfy. Indicator
+/// rows are only counted if their indicator has its value
+int ModelIR::countViolations(const vector<double> &values, double tolerance) const{
+    int violations = 0;
+    for(int c = 0; c < numberColumns(); c++){
+        if(values[c] < columnLower[c] - tolerance || values[c] > columnUpper[c] + tolerance ||
+           (columnType[c] == INTEGER && abs(values[c] - round(values[c])) > tolerance)){
+            violations++;
+        }
+    }
+    for(int r = 0; r < numberRows(); r++){
+        if(isIndicatorRow(r) && round(values[rowIndicator[r]]) != rowIndicatorValue[r]){
+            continue;
+        }
+        double activity = 0.0;
+        for(int p = rowStart[r]; p < rowStart[r + 1]; p++){
+            activity += rowValue[p] * values[rowIndex[p]];
+        }
+        if(activity < rowLower[r] - tolerance || activity > rowUpper[r] + tolerance){
+            violations++;
+        }
+    }
+    return violations;
+}
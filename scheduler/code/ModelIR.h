@@ -0,0 +1,81 @@
+#ifndef SCHEDULER_MODEL_IR_H
+#define SCHEDULER_MODEL_IR_H
+#include "vector"
+#include "string"
+#include "limits"
+#include "initializer_list"
+
+using namespace std;
+
+/// column types, using the MPS/CPLEX convention
+const char CONTINUOUS = 'C';
+const char INTEGER = 'I';
+
+/// used for unbounded columns and one sided rows
+const double INFINITE_BOUND = numeric_limits<double>::infinity();
+
+/// index used for variables which are not part of the model
+const int NO_COLUMN = -1;
+
+/// index used for rows which are not part of the model
+const int NO_ROW = -1;
+
+/// a coefficient of a column in a row
+struct Term{
+    int column;
+    double value;
+};
+
+/// the columns and rows whose bounds were changed after the model was loaded into a solver
+struct ModelChanges{
+    vector<int> columns;
+    vector<int> rows;
+};
+
+/// Solver independent representation of the MIP model. Columns and rows are stored in flat arrays and the
+/// constraint matrix is stored row-wise (CSR), so the model can be built, inspected and written without a solver.
+struct ModelIR{
+    /// column bounds, types, objective coefficients and names
+    vector<double> columnLower;
+    vector<double> columnUpper;
+    vector<char> columnType;
+    vector<double> objective;
+    vector<string> columnNames;
+
+    /// row bounds, a row lower <= a x <= upper. One sided rows use INFINITE_BOUND
+    vector<double> rowLower;
+    vector<double> rowUpper;
+    vector<string> rowNames;
+
+    /// the nonzeros of row r are rowIndex/rowValue[rowStart[r]] to rowIndex/rowValue[rowStart[r+1]]
+    vector<int> rowStart{0};
+    vector<int> rowIndex;
+    vector<double> rowValue;
+
+    /// an indicator row only has to hold while the binary column rowIndicator[r] has the value rowIndicatorValue[r].
+    /// NO_COLUMN for the other rows
+    vector<int> rowIndicator;
+    vector<char> rowIndicatorValue;
+
+    int addColumn(double lower, double upper, char type, const string &name, double objectiveValue = 0.0);
+    int addRow(initializer_list<Term> terms, char sense, double rhs, const string &name = "");
+    int addRow(const vector<Term> &terms, char sense, double rhs, const string &name = "");
+    int addIndicatorRow(int indicator, int value, const vector<Term> &terms, char sense, double rhs,
+                        const string &name = "");
+
+    int numberColumns() const;
+    int numberRows() const;
+    long numberNonzeros() const;
+    string columnName(int column) const;
+    string rowName(int row) const;
+    bool isIndicatorRow(int row) const;
+    bool hasIndicatorRows() const;
+    int countViolations(const vector<double> &values, double tolerance) const;
+
+private:
+    void finishRow(char sense, double rhs, const string &name);
+
+    int numberIndicatorRows = 0;
+};
+
+#endif //SCHEDULER_MODEL_IR_H
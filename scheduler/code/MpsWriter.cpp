@@ -0,0 +1,181 @@
+#include "MpsWriter.h"
+#include "iostream"
+#include "cstdarg"
+#include "cmath"
+
+using namespace std;
+
+/// size of the output buffer which is flushed to disk once full
+const size_t MPS_BUFFER_SIZE = 1 << 20;
+
+void MpsWriter::write(const ModelIR &model, const string &fileName){
+    FILE *file = fopen(fileName.c_str(), "w");
+    if(file == nullptr){
+        cout << "Could not open " << fileName << " for writing" << endl;
+        return;
+    }
+    buffer.clear();
+    buffer.reserve(MPS_BUFFER_SIZE + 1024);
+
+    /// rows which are switched off (free on both sides) are left out, several readers do not accept more than one N
+    /// row
+    vector<char> freeRow(model.numberRows());
+    for(int r = 0; r < model.numberRows(); r++){
+        freeRow[r] = isinf(model.rowLower[r]) && isinf(model.rowUpper[r]);
+    }
+
+    /// the matrix is stored by row, MPS lists the nonzeros by column
+    int numberColumns = model.numberColumns();
+    vector<long> columnStart(numberColumns + 1, 0);
+    for(int r = 0; r < model.numberRows(); r++){
+        for(int p = model.rowStart[r]; p < model.rowStart[r + 1] && !freeRow[r]; p++){
+            columnStart[model.rowIndex[p] + 1]++;
+        }
+    }
+    for(int c = 0; c < numberColumns; c++){
+        columnStart[c + 1] += columnStart[c];
+    }
+    vector<int> columnRow(columnStart[numberColumns]);
+    vector<double> columnValue(columnStart[numberColumns]);
+    vector<long> nextEntry(columnStart.begin(), columnStart.end() - 1);
+    for(int r = 0; r < model.numberRows(); r++){
+        for(int p = model.rowStart[r]; p < model.rowStart[r + 1] && !freeRow[r]; p++){
+            long entry = nextEntry[model.rowIndex[p]]++;
+            columnRow[entry] = r;
+            columnValue[entry] = model.rowValue[p];
+        }
+    }
+
+    /// FREE keeps readers which guess the format of each line, such as CBC, from reading a line as fixed format
+    writeLine(file, "NAME scheduler FREE\n");
+    writeLine(file, "ROWS\n");
+    writeLine(file, " N obj\n");
+    for(int r = 0; r < model.numberRows(); r++){
+        if(freeRow[r]){
+            continue;
+        }
+        char sense = 'E';
+        if(model.rowLower[r] != model.rowUpper[r]){
+            sense = isinf(model.rowLower[r]) ? 'L' : 'G';
+        }
+        writeLine(file, " %c %s\n", sense, model.rowName(r).c_str());
+    }
+
+    writeLine(file, "COLUMNS\n");
+    bool integerSection = false;
+    for(int c = 0; c < numberColumns; c++){
+        if((model.columnType[c] == INTEGER) != integerSection){
+            integerSection = !integerSection;
+            writeLine(file, " MARKER 'MARKER' %s\n", integerSection ? "'INTORG'" : "'INTEND'");
+        }
+        string name = model.columnName(c);
+        if(model.objective[c] != 0.0 || columnStart[c] == columnStart[c + 1]){
+            writeLine(file, " %s obj %.17g\n", name.c_str(), model.objective[c]);
+        }
+        for(long p = columnStart[c]; p < columnStart[c + 1]; p++){
+            writeLine(file, " %s %s %.17g\n", name.c_str(), model.rowName(columnRow[p]).c_str(), columnValue[p]);
+        }
+    }
+    if(integerSection){
+        writeLine(file, " MARKER 'MARKER' 'INTEND'\n");
+    }
+
+    writeLine(file, "RHS\n");
+    for(int r = 0; r < model.numberRows(); r++){
+        double rhs = isinf(model.rowLower[r]) ? model.rowUpper[r] : model.rowLower[r];
+        if(rhs != 0.0 && !isinf(rhs)){
+            writeLine(file, " rhs %s %.17g\n", model.rowName(r).c_str(), rhs);
+        }
+    }
+
+    /// rows bounded on both sides are written as G rows with a range
+    bool rangesWritten = false;
+    for(int r = 0; r < model.numberRows(); r++){
+        if(!isinf(model.rowLower[r]) && !isinf(model.rowUpper[r]) && model.rowLower[r] != model.rowUpper[r]){
+            if(!rangesWritten){
+                writeLine(file, "RANGES\n");
+                rangesWritten = true;
+            }
+            writeLine(file, " rng %s %.17g\n", model.rowName(r).c_str(), model.rowUpper[r] - model.rowLower[r]);
+        }
+    }
+
+    writeLine(file, "BOUNDS\n");
+    for(int c = 0; c < numberColumns; c++){
+        string name = model.columnName(c);
+        double lower = model.columnLower[c];
+        double upper = model.columnUpper[c];
+        if(lower == upper){
+            writeLine(file, " FX bnd %s %.17g\n", name.c_str(), lower);
+            continue;
+        }
+        if(isinf(lower)){
+            writeLine(file, " MI bnd %s\n", name.c_str());
+        }
+        else if(lower != 0.0 || upper < 0.0){
+            writeLine(file, " LO bnd %s %.17g\n", name.c_str(), lower);
+        }
+        if(!isinf(upper)){
+            writeLine(file, " UP bnd %s %.17g\n", name.c_str(), upper);
+        }
+    }
+    /// the CPLEX extension for indicator rows, a switched off row is not written
+    if(model.hasIndicatorRows()){
+        writeLine(file, "INDICATORS\n");
+        for(int r = 0; r < model.numberRows(); r++){
+            if(model.isIndicatorRow(r) && !freeRow[r]){
+                writeLine(file, " IF %s %s %d\n", model.rowName(r).c_str(),
+                          model.columnName(model.rowIndicator[r]).c_str(), model.rowIndicatorValue[r]);
+            }
+        }
+    }
+    writeLine(file, "ENDATA\n");
+
+    fwrite(buffer.data(), 1, buffer.size(), file);
+    fclose(file);
+}
+
+/// format a line into the buffer and flush the buffer to the file once it is full
+void MpsWriter::writeLine(FILE *file, const char *format, ...){
+    char line[512];
+    va_list arguments;
+    va_start(arguments, format);
+    int length = vsnprintf(line, sizeof(line), format, arguments);
+    va_end(arguments);
+    if(length >= (int) sizeof(line)){
+        string longLine(length + 1, '\0');
+        va_start(arguments, format);
+        vsnprintf(&longLine[0], longLine.size(), format, arguments);
+        va_end(arguments);
+        buffer.append(longLine.data(), length);
+    }
+    else{
+        buffer.append(line, length);
+    }
+    if(buffer.size() >= MPS_BUFFER_SIZE){
+        fwrite(buffer.data(), 1, buffer.size(), file);
+        buffer.clear();
+    }
+}
+
+MpsBackend::MpsBackend(const string &fileName): fileName(fileName){}
+
+string MpsBackend::name() const{
+    return "mps";
+}
+
+void MpsBackend::loadModel(const ModelIR &model){
+    MpsWriter writer;
+    writer.write(model, fileName);
+}
+
+bool MpsBackend::supportsIndicatorRows() const{
+    return true;
+}
+
+/// the model is only written to disk, so there is never a solution
+SolverResult MpsBackend::solve(const SolverSettings &settings){
+    SolverResult result;
+    result.status = "Model written to " + fileName;
+    return result;
+}
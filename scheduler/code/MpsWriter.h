@@ -0,0 +1,33 @@
+#ifndef SCHEDULER_MPS_WRITER_H
+#define SCHEDULER_MPS_WRITER_H
+#include "string"
+#include "cstdio"
+#include "ModelIR.h"
+#include "SolverBackend.h"
+
+using namespace std;
+
+/// writes a ModelIR as a free format MPS file, streaming through a large buffer instead of building the file in memory
+class MpsWriter{
+public:
+    void write(const ModelIR &model, const string &fileName);
+
+private:
+    void writeLine(FILE *file, const char *format, ...);
+    string buffer;
+};
+
+/// backend which only streams the model to disk, used on machines without a solver or to hand the model to another tool
+class MpsBackend: public SolverBackend{
+public:
+    explicit MpsBackend(const string &fileName);
+    string name() const override;
+    void loadModel(const ModelIR &model) override;
+    bool supportsIndicatorRows() const override;
+    SolverResult solve(const SolverSettings &settings) override;
+
+private:
+    string fileName;
+};
+
+#endif //SCHEDULER_MPS_WRITER_H
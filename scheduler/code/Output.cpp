@@ -1,7 +1,15 @@
 #include "Output.h"
+#include "SolutionArchive.h"
+#include "RunMetrics.h"
 #include "iostream"
 #include <numeric>
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <sstream>
+#include <charconv>
+#include <memory>
+#include <cstdio>
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/serialization/vector.hpp>
@@ -9,92 +17,455 @@
 
 using namespace std;
 
-void Output::printResults(primitiveVariables variables, vector<vector<string>> stationData, long elapsedTime,
-                                  double startingTime, double endingTime, double solutionValue, string status,
-                                  double optimalGap, string method) {
+Output::Output(ostream &out): out(out){}
 
-    cout << "Start time:" << startingTime << "\tEnd time:" << endingTime << endl;
+/// the totals of a schedule, computed once for the report and the result files
+struct ScheduleTotals{
+    vector<double> busEnergy;
+    vector<double> busNonRenewable;
+    vector<int> busCharges;
+    /// the clean energy used by each bus from each CEW, numberWindows values for each bus
+    vector<double> busWindowUsed;
+    vector<double> windowUsed;
+    double totalEnergy = 0.0;
+    double nonRenewable = 0.0;
+    int totalCharges = 0;
+    double horizonEnergy = 0.0;
+    double horizonNonRenewable = 0.0;
+    int horizonCharges = 0;
+};
 
-    string chargingLocations = "Charging station installation locations:\n";
-    for (int i = 0; i < variables.chargingStations.size(); i++) {
-        if (variables.chargingStations[i] == 1) {
-            chargingLocations += "\t" + stationData[i][0] + "\n";
+static ScheduleTotals scheduleTotals(const primitiveVariables &variables, const RunOutcome &outcome){
+    ScheduleTotals totals;
+    int numberBuses = variables.buses.size();
+    int numberWindows = variables.powerExcess.size();
+    totals.busEnergy = vector<double>(numberBuses, 0.0);
+    totals.busNonRenewable = vector<double>(numberBuses, 0.0);
+    totals.busCharges = vector<int>(numberBuses, 0);
+    for(int busIndex = 0; busIndex < numberBuses; busIndex++){
+        for(int s = variables.stopStart[busIndex]; s < variables.stopStart[busIndex + 1]; s++){
+            totals.busEnergy[busIndex] += variables.chargeAmount[s];
+            totals.busNonRenewable[busIndex] += variables.nonRenewable[s];
+            totals.busCharges[busIndex] += variables.charge[s];
+            if(variables.arrivalTime[s] >= outcome.startTime && variables.arrivalTime[s] <= outcome.endTime){
+                totals.horizonEnergy += variables.chargeAmount[s];
+                totals.horizonNonRenewable += variables.nonRenewable[s];
+                totals.horizonCharges += variables.charge[s];
+            }
         }
+        totals.totalEnergy += totals.busEnergy[busIndex];
+        totals.nonRenewable += totals.busNonRenewable[busIndex];
+        totals.totalCharges += totals.busCharges[busIndex];
     }
-    cout << chargingLocations << endl;
-    double totalEnergyUsed = 0.0;
-    double nonRenewableEnergy = 0.0;
-    double horizonEnergy = 0.0;
-    double horizonNonClean = 0.0;
-    int horizonCharge = 0;
-    int totalCharges = 0;
-    double totalChargeAmount = 0.0;
-    for (int busIndex = 0; busIndex < variables.buses.size(); busIndex++) {
-
-        int b = variables.buses[busIndex];
-        cout << "Bus " << b << ":" << endl;
-        totalEnergyUsed += accumulate(variables.chargeAmount[b].begin(), variables.chargeAmount[b].end(), 0.0);
-        nonRenewableEnergy += accumulate(variables.nonRenewable[b].begin(), variables.nonRenewable[b].end(), 0.0);
-        totalCharges += accumulate(variables.charge[b].begin(), variables.charge[b].end(), 0);
-        totalChargeAmount += accumulate(variables.chargeAmount[b].begin(), variables.chargeAmount[b].end(), 0.0);
-        printLoop("non-clean energy used", variables.nonRenewable[b]);
-        printLoop("Bus stops", variables.busSequences[b]);
-        printLoop("Scheduled arrival time in hour decimal", variables.scheduledTime[b]);
-        printLoop("Actual arrival time in hour decimal", variables.arrivalTime[b]);
-        printLoop("Charge time in hour decimal",  variables.chargeTime[b]);
-        printLoop("Battery capacity (kWh)",  variables.capacity[b]);
-        printLoop("Charge amount (kWh)",  variables.chargeAmount[b]);
-        printLoop("Charge",  variables.charge[b]);
-        if(method == "SPM"){
-            printLoop("Ase", variables.ases[b]);
-            printLoop("Discount (kWh)", variables.discounts[b]);
-        }
-        cout << "\tTotal energy gained for bus:"<< accumulate(variables.chargeAmount[b].begin(), variables.chargeAmount[b].end(), 0.0) << endl;
-        for (int i = 0; i < variables.nonRenewable[b].size(); i++) {
-            if (variables.arrivalTime[b][i] >= startingTime && variables.arrivalTime[b][i] <= endingTime) {
-                horizonEnergy += variables.chargeAmount[b][i];
-                horizonNonClean += variables.nonRenewable[b][i];
-                horizonCharge += variables.charge[b][i];
+    totals.busWindowUsed = vector<double>(numberBuses * numberWindows, 0.0);
+    totals.windowUsed = vector<double>(numberWindows, 0.0);
+    for(auto &use: variables.cleanEnergy){
+        if(use.window < numberWindows){
+            totals.busWindowUsed[use.bus * numberWindows + use.window] += use.energy;
+            totals.windowUsed[use.window] += use.energy;
+        }
+    }
+    return totals;
+}
+
+void Output::reportResults(const primitiveVariables &variables, const vector<vector<string>> &stationData,
+                           const RunOutcome &outcome, const RunConfig &config){
+    if(config.report != "none"){
+        printResults(variables, stationData, outcome, config.report == "summary");
+    }
+    if(!config.resultFile.empty()){
+        string resultFile = config.resultFile;
+        if(resultFile.find("{horizon}") != string::npos){
+            ostringstream horizon;
+            horizon << outcome.startTime;
+            resultFile.replace(resultFile.find("{horizon}"), 9, horizon.str());
+        }
+        writeResults(variables, stationData, outcome, resultFile, config.resultFormat,
+                     config.resultDetail == "summary");
+    }
+}
+
+void Output::printResults(const primitiveVariables &variables, const vector<vector<string>> &stationData,
+                          const RunOutcome &outcome, bool summaryOnly){
+    PhaseTimer timer("output.report");
+    ScheduleTotals totals = scheduleTotals(variables, outcome);
+    out << "Start time:" << outcome.startTime << "\tEnd time:" << outcome.endTime << "\n";
+
+    out << "Charging station installation locations:\n";
+    for(int i = 0; i < variables.chargingStations.size(); i++){
+        if(variables.chargingStations[i] == 1){
+            out << "\t" << stationData[i][0] << "\n";
+        }
+    }
+    out << "\n";
+    bool spm = outcome.method == "SPM" && !variables.ases.empty();
+    for(int busIndex = 0; !summaryOnly && busIndex < variables.buses.size(); busIndex++){
+        int first = variables.stopStart[busIndex];
+        int numStops = variables.numberStops(busIndex);
+        out << "Bus " << variables.buses[busIndex] << ":\n";
+        printLoop("non-clean energy used", variables.nonRenewable.data() + first, numStops);
+        printLoop("Bus stops", variables.busSequences.data() + first, numStops);
+        printLoop("Scheduled arrival time in hour decimal", variables.scheduledTime.data() + first, numStops);
+        printLoop("Actual arrival time in hour decimal", variables.arrivalTime.data() + first, numStops);
+        printLoop("Charge time in hour decimal",  variables.chargeTime.data() + first, numStops);
+        printLoop("Battery capacity (kWh)",  variables.capacity.data() + first, numStops);
+        printLoop("Charge amount (kWh)",  variables.chargeAmount.data() + first, numStops);
+        printLoop("Charge",  variables.charge.data() + first, numStops);
+        if(spm){
+            printLoop("Ase", variables.ases.data() + first, numStops);
+            printLoop("Discount (kWh)", variables.discounts.data() + first, numStops);
+        }
+        out << "\tTotal energy gained for bus:" << totals.busEnergy[busIndex] << "\n\n\n";
+    }
+
+    /// the clean energy used by each bus from each CEW
+    int numberWindows = variables.powerExcess.size();
+    if(!summaryOnly){
+        out << "--CEW information--\n";
+    }
+    for(int k = 0; !summaryOnly && k < numberWindows; k++){
+        out << "CEW:" << k << "\n";
+        out << "\tCEW Start time: " << variables.powerExcess[k].startTime << "\n";
+        out << "\tCEW End time: " << variables.powerExcess[k].endTime << "\n";
+        for(int busIndex = 0; busIndex < variables.buses.size(); busIndex++){
+            double busUsed = totals.busWindowUsed[busIndex * numberWindows + k];
+            if(busUsed != 0.0){
+                out << "\t\tBus:" << variables.buses[busIndex] << " used " << busUsed << " from CEW " << k << "\n";
             }
         }
-        cout << endl << endl;
+        out << "\tCEW Total clean energy used during window: " << totals.windowUsed[k] << "\n";
+        out << "\tCEW Total clean energy available: " << variables.powerExcess[k].availableEnergy << "\n\n";
+    }
+    out << "Horizon energy used: " << totals.horizonEnergy << "\n";
+    out << "Horizon non-clean energy used: " << totals.horizonNonRenewable << "\n";
+    out << "Horizon charges: " << totals.horizonCharges << "\n";
+    out << "Total energy used: " << totals.totalEnergy << "\n";
+    out << "Total charges: " << totals.totalCharges << "\n";
+    out << "Solution value:" << outcome.solutionValue << "\n";
+    out << "Solution status:" << outcome.status << "\n";
+    out << "Elapsed Time: " << outcome.elapsedTime << "\n";
+    out << "Gap:" << outcome.gap * 100 << "\n";
+    out << "Total non-clean used: " << totals.nonRenewable << endl;
+}
 
+/// Collects the lines of a result file in one buffer which is written to the file in large blocks. Numbers are
+/// written by to_chars, in the shortest form which reads back to the same value
+class ResultBuffer{
+public:
+    explicit ResultBuffer(string resultFile): file(resultFile, ios::binary){
+        buffer.reserve(blockSize + 4096);
     }
-    cout << "--CEW information--"<< endl;
-    for (int k = 0; k < variables.powerExcess.size(); k++) {
-        cout << "CEW:" << k << endl;
-        cout << "\tCEW Start time: " << variables.powerExcess[k].startTime << endl;
-        cout << "\tCEW End time: " << variables.powerExcess[k].endTime << endl;
 
-        double windowCleanEnergyUsed = 0.0;
-        for (int busIndex = 0; busIndex < variables.buses.size(); busIndex++) {
-            int b = variables.buses[busIndex];
-            double busCleanEnergyUsed = accumulate(variables.windowEnergyUsed[k][b].begin(), variables.windowEnergyUsed[k][b].end(), 0.0);
-            windowCleanEnergyUsed += busCleanEnergyUsed;
-            if(busCleanEnergyUsed!=0.0){
-                cout << "\t\tBus:" << b  << " used " << busCleanEnergyUsed << " from CEW " << k << endl;
+    ~ResultBuffer(){
+        flush();
+    }
+
+    ResultBuffer &operator<<(const string &text){
+        buffer += text;
+        return *this;
+    }
+
+    ResultBuffer &operator<<(const char *text){
+        buffer += text;
+        return *this;
+    }
+
+    ResultBuffer &operator<<(char character){
+        buffer += character;
+        return *this;
+    }
+
+    ResultBuffer &operator<<(double value){
+        char digits[32];
+        buffer.append(digits, to_chars(digits, digits + sizeof(digits), value).ptr);
+        return *this;
+    }
+
+    ResultBuffer &operator<<(int value){
+        char digits[16];
+        buffer.append(digits, to_chars(digits, digits + sizeof(digits), value).ptr);
+        return *this;
+    }
+
+    /// a string value: quoted and escaped in JSON, quoted if it holds a separator or a quote in CSV
+    void quoted(const string &text, bool json){
+        if(!json && text.find_first_of(",\"\n") == string::npos){
+            buffer += text;
+            return;
+        }
+        buffer += '"';
+        for(char character: text){
+            if(character == '"'){
+                buffer += json ? "\\\"" : "\"\"";
+            }
+            else if(json && character == '\\'){
+                buffer += "\\\\";
+            }
+            else if(json && (unsigned char) character < 0x20){
+                char escape[8];
+                snprintf(escape, sizeof(escape), "\\u%04x", character);
+                buffer += escape;
+            }
+            else{
+                buffer += character;
             }
         }
+        buffer += '"';
+    }
 
+    /// ends a line, the buffer is written to the file once it holds a block
+    void endLine(){
+        buffer += '\n';
+        if(buffer.size() >= blockSize){
+            flush();
+        }
+    }
 
-        cout << "\tCEW Total clean energy used during window: " << windowCleanEnergyUsed << endl;
-        cout << "\tCEW Total clean energy available: " << variables.powerExcess[k].availableEnergy << endl << endl;
+    void flush(){
+        file.write(buffer.data(), buffer.size());
+        buffer.clear();
     }
-    cout << "Horizon energy used: " << horizonEnergy << endl;
-    cout << "Horizon non-clean energy used: " << horizonNonClean << endl;
-    cout << "Horizon charges: " << horizonCharge << endl;
-    cout << "Total energy used: " << totalEnergyUsed << endl;
-    cout << "Total charges: " << totalCharges << endl;
-    cout << "Solution value:" << solutionValue << endl;
-    cout << "Solution status:" << status << endl;
-    cout << "Elapsed Time: " << elapsedTime << endl;
-    cout << "Gap:" << optimalGap * 100 << endl;
-    cout << "Total non-clean used: " << nonRenewableEnergy << endl;
 
+private:
+    static const size_t blockSize = 1 << 20;
+    ofstream file;
+    string buffer;
+};
 
+void Output::writeResults(const primitiveVariables &variables, const vector<vector<string>> &stationData,
+                          const RunOutcome &outcome, string resultFile, string format, bool summaryOnly){
+    PhaseTimer timer("output.results");
+    ScheduleTotals totals = scheduleTotals(variables, outcome);
+    bool json = format == "jsonl";
+    bool spm = outcome.method == "SPM" && !variables.ases.empty();
+    int numberWindows = variables.powerExcess.size();
+    vector<string> chargingStations;
+    for(int i = 0; i < variables.chargingStations.size(); i++){
+        if(variables.chargingStations[i] == 1){
+            chargingStations.push_back(stationData[i][0]);
+        }
+    }
+
+    /// a JSON Lines file holds every record, the csv files one kind of record each
+    unique_ptr<ResultBuffer> jsonLines = json ? make_unique<ResultBuffer>(resultFile) : nullptr;
+    auto open = [&](const string &name, const string &header) -> unique_ptr<ResultBuffer>{
+        if(json){
+            return nullptr;
+        }
+        auto csv = make_unique<ResultBuffer>(resultFile + "_" + name + ".csv");
+        *csv << header;
+        csv->endLine();
+        return csv;
+    };
+    auto field = [json](ResultBuffer &line, const char *name, bool first = false) -> ResultBuffer &{
+        if(json){
+            line << (first ? "{\"" : ",\"") << name << "\":";
+        }
+        else if(!first){
+            line << ',';
+        }
+        return line;
+    };
+    auto endRecord = [json](ResultBuffer &line){
+        if(json){
+            line << '}';
+        }
+        line.endLine();
+    };
+
+    unique_ptr<ResultBuffer> summaryFile = open("summary", "start,end,method,status,solution value,gap,"
+                                                           "elapsed time,energy,non-clean energy,charges,"
+                                                           "horizon energy,horizon non-clean energy,horizon charges,"
+                                                           "charging stations");
+    ResultBuffer &summary = json ? *jsonLines : *summaryFile;
+    if(json){
+        summary << "{\"type\":\"summary\"";
+    }
+    field(summary, "start", !json) << outcome.startTime;
+    field(summary, "end") << outcome.endTime;
+    field(summary, "method").quoted(outcome.method, json);
+    field(summary, "status").quoted(outcome.status, json);
+    field(summary, "solutionValue") << outcome.solutionValue;
+    field(summary, "gap") << outcome.gap;
+    field(summary, "elapsedTime") << outcome.elapsedTime;
+    field(summary, "energy") << totals.totalEnergy;
+    field(summary, "nonClean") << totals.nonRenewable;
+    field(summary, "charges") << totals.totalCharges;
+    field(summary, "horizonEnergy") << totals.horizonEnergy;
+    field(summary, "horizonNonClean") << totals.horizonNonRenewable;
+    field(summary, "horizonCharges") << totals.horizonCharges;
+    field(summary, "chargingStations");
+    if(json){
+        summary << '[';
+        for(int i = 0; i < chargingStations.size(); i++){
+            summary << (i == 0 ? "" : ",");
+            summary.quoted(chargingStations[i], true);
+        }
+        summary << ']';
+    }
+    else{
+        string stations;
+        for(int i = 0; i < chargingStations.size(); i++){
+            stations += (i == 0 ? "" : ";") + chargingStations[i];
+        }
+        summary.quoted(stations, false);
+    }
+    endRecord(summary);
+    if(summaryOnly){
+        return;
+    }
+
+    unique_ptr<ResultBuffer> busFile = open("buses", "bus,stops,energy,non-clean energy,clean energy,charges");
+    ResultBuffer &buses = json ? *jsonLines : *busFile;
+    for(int busIndex = 0; busIndex < variables.buses.size(); busIndex++){
+        double clean = 0.0;
+        for(int k = 0; k < numberWindows; k++){
+            clean += totals.busWindowUsed[busIndex * numberWindows + k];
+        }
+        if(json){
+            buses << "{\"type\":\"bus\"";
+        }
+        field(buses, "bus", !json) << variables.buses[busIndex];
+        field(buses, "stops") << variables.numberStops(busIndex);
+        field(buses, "energy") << totals.busEnergy[busIndex];
+        field(buses, "nonClean") << totals.busNonRenewable[busIndex];
+        field(buses, "clean") << clean;
+        field(buses, "charges") << totals.busCharges[busIndex];
+        endRecord(buses);
+    }
+
+    unique_ptr<ResultBuffer> stopFile = open("stops", string("bus,stop,station,scheduled arrival,arrival,charge time,"
+                                                             "battery capacity,charge amount,charge,non-clean energy") +
+                                                      (spm ? ",ase,discount" : ""));
+    ResultBuffer &stops = json ? *jsonLines : *stopFile;
+    for(int busIndex = 0; busIndex < variables.buses.size(); busIndex++){
+        for(int s = variables.stopStart[busIndex]; s < variables.stopStart[busIndex + 1]; s++){
+            if(json){
+                stops << "{\"type\":\"stop\"";
+            }
+            field(stops, "bus", !json) << variables.buses[busIndex];
+            field(stops, "stop") << s - variables.stopStart[busIndex];
+            field(stops, "station") << variables.busSequences[s];
+            field(stops, "scheduledArrival") << variables.scheduledTime[s];
+            field(stops, "arrival") << variables.arrivalTime[s];
+            field(stops, "chargeTime") << variables.chargeTime[s];
+            field(stops, "batteryCapacity") << variables.capacity[s];
+            field(stops, "chargeAmount") << variables.chargeAmount[s];
+            field(stops, "charge") << variables.charge[s];
+            field(stops, "nonClean") << variables.nonRenewable[s];
+            if(spm){
+                field(stops, "ase") << variables.ases[s];
+                field(stops, "discount") << variables.discounts[s];
+            }
+            endRecord(stops);
+        }
+    }
+
+    unique_ptr<ResultBuffer> windowFile = open("windows", "window,start,end,available,used");
+    ResultBuffer &windows = json ? *jsonLines : *windowFile;
+    for(int k = 0; k < numberWindows; k++){
+        if(json){
+            windows << "{\"type\":\"window\"";
+        }
+        field(windows, "window", !json) << k;
+        field(windows, "start") << variables.powerExcess[k].startTime;
+        field(windows, "end") << variables.powerExcess[k].endTime;
+        field(windows, "available") << variables.powerExcess[k].availableEnergy;
+        field(windows, "used") << totals.windowUsed[k];
+        endRecord(windows);
+    }
+
+    unique_ptr<ResultBuffer> windowBusFile = open("windowBuses", "window,bus,used");
+    ResultBuffer &windowBuses = json ? *jsonLines : *windowBusFile;
+    for(int k = 0; k < numberWindows; k++){
+        for(int busIndex = 0; busIndex < variables.buses.size(); busIndex++){
+            double busUsed = totals.busWindowUsed[busIndex * numberWindows + k];
+            if(busUsed == 0.0){
+                continue;
+            }
+            if(json){
+                windowBuses << "{\"type\":\"windowBus\"";
+            }
+            field(windowBuses, "window", !json) << k;
+            field(windowBuses, "bus") << variables.buses[busIndex];
+            field(windowBuses, "used") << busUsed;
+            endRecord(windowBuses);
+        }
+    }
 }
 
+/// solutions are written as a binary archive, see SolutionArchive
 void Output::writeSolutionFile(primitiveVariables solutionVariables, string solutionFile) {
+    PhaseTimer timer("output.solution");
+    SolutionArchive::write(solutionVariables, solutionFile);
+}
+
+/// the charging stations in the format read by Parser::parseChargingStationsFile, ten stations to a line
+void Output::writeChargingStationsFile(const vector<int> &chargingStops, string chargingStationFile){
+    ofstream file(chargingStationFile);
+    file << "[";
+    for(int i = 0; i < chargingStops.size(); i++){
+        file << chargingStops[i];
+        if(i + 1 < chargingStops.size()){
+            file << ((i + 1) % 10 == 0 ? ",\n" : ", ");
+        }
+    }
+    file << "]";
+}
+
+/// the mean, the minimum, the 5th, 50th and 95th percentile and the maximum of the values of the scenarios
+static string distribution(vector<double> values){
+    if(values.empty()){
+        return ",,,,,";
+    }
+    string columns = to_string(accumulate(values.begin(), values.end(), 0.0) / values.size());
+    for(double quantile: {0.0, 0.05, 0.5, 0.95, 1.0}){
+        auto position = values.begin() + (long) round(quantile * (values.size() - 1));
+        nth_element(values.begin(), position, values.end());
+        columns += "," + to_string(*position);
+    }
+    return columns;
+}
+
+/// the distributions of a simulation as csv files: simulationFile_scenarios.csv holds the totals of each scenario,
+/// simulationFile_buses.csv, _windows.csv and _horizons.csv the distributions of the clean and non-clean energy
+void Output::writeSimulation(const SimulationResult &result, string simulationFile){
+    string header = "clean mean,clean min,clean p5,clean p50,clean p95,clean max";
+    string nonRenewableHeader = "non-clean mean,non-clean min,non-clean p5,non-clean p50,non-clean p95,non-clean max";
+
+    ofstream scenarios(simulationFile + "_scenarios.csv");
+    scenarios << "scenario,clean,non-clean\n";
+    for(int s = 0; s < result.scenarioNames.size(); s++){
+        scenarios << result.scenarioNames[s] << "," << result.totalClean[s] << "," << result.totalNonRenewable[s]
+                  << "\n";
+    }
+
+    ofstream buses(simulationFile + "_buses.csv");
+    buses << "bus," << header << "," << nonRenewableHeader << "\n";
+    for(int n = 0; n < result.buses.size(); n++){
+        buses << result.buses[n] << "," << distribution(result.busClean[n]) << ","
+              << distribution(result.busNonRenewable[n]) << "\n";
+    }
+
+    ofstream windows(simulationFile + "_windows.csv");
+    windows << "start,end," << header << "\n";
+    for(int k = 0; k < result.windows.size(); k++){
+        windows << result.windows[k].startTime << "," << result.windows[k].endTime << ","
+                << distribution(result.windowClean[k]) << "\n";
+    }
+
+    ofstream horizons(simulationFile + "_horizons.csv");
+    horizons << "start,end," << header << "," << nonRenewableHeader << "\n";
+    for(int h = 0; h < result.horizonClean.size(); h++){
+        horizons << result.horizons[h] << "," << result.horizons[h + 1] << "," << distribution(result.horizonClean[h])
+                 << "," << distribution(result.horizonNonRenewable[h]) << "\n";
+    }
+    horizons << "total,," << distribution(result.totalClean) << "," << distribution(result.totalNonRenewable)
+             << "\n";
+}
+
+/// the boost text archive used before the binary archive, kept to convert solutions for older tools
+void Output::writeTextSolutionFile(primitiveVariables solutionVariables, string solutionFile) {
     ofstream ofs(solutionFile);
     {
         boost::archive::text_oarchive oa(ofs);
@@ -104,24 +475,24 @@ void Output::writeSolutionFile(primitiveVariables solutionVariables, string solu
 }
 
 template <class T>
-void Output::printLoop(string variable, vector<T> values){
-    cout << "\t" << variable << ":\n\t\t[";
-    for(int i=0;i<values.size();i++){
-        cout << values[i];
+void Output::printLoop(string variable, const T *values, int size){
+    out << "\t" << variable << ":\n\t\t[";
+    for(int i=0;i<size;i++){
+        out << values[i];
 
-        if(i != values.size()-1){
-            cout << ", ";
+        if(i != size-1){
+            out << ", ";
         }
         else{
-            cout << "]";
+            out << "]";
         }
         i = i + 1;
         if(i%10==0){
-            cout << "\n\t\t";
+            out << "\n\t\t";
         }
         i = i - 1;
     }
-    cout << "\n" << endl;
+    out << "\n\n";
 }
 
 
@@ -1,14 +1,48 @@
 #include "DataStructures.h"
+#include "ScheduleSimulator.h"
+#include "RunConfig.h"
+#include "iostream"
+
+/// how a solve of a horizon ended, reported next to its schedule
+struct RunOutcome{
+    double startTime = 0.0;
+    double endTime = 24.0;
+    double solutionValue = 0.0;
+    string status;
+    double gap = 0.0;
+    double elapsedTime = 0.0;
+    string method = "MPM";
+};
 
 class Output{
 public:
+    /// results are printed to out, which is the standard output unless a run writes to its own result file
+    explicit Output(ostream &out = cout);
     void writeSolutionFile(primitiveVariables solutionVariables, string solutionFile);
-    void printResults(primitiveVariables variables, vector<vector<string>> stationData, long elapsedTime,
-                      double startingTime, double endingTime, double solutionValue, string status, double optimalGap,
-                      string method);
+    void writeTextSolutionFile(primitiveVariables solutionVariables, string solutionFile);
+    void writeChargingStationsFile(const vector<int> &chargingStops, string chargingStationFile);
+    void writeSimulation(const SimulationResult &result, string simulationFile);
+
+    /// the report of config.report on out and the result file of config.resultFile, in which {horizon} is replaced
+    /// by the start of the horizon
+    void reportResults(const primitiveVariables &variables, const vector<vector<string>> &stationData,
+                       const RunOutcome &outcome, const RunConfig &config);
+
+    /// the human-readable report, summaryOnly leaves out the buses and the CEW
+    void printResults(const primitiveVariables &variables, const vector<vector<string>> &stationData,
+                      const RunOutcome &outcome, bool summaryOnly = false);
+
+    /// the same values as printResults as JSON Lines (format jsonl), one object for the summary, each bus, each stop
+    /// and each CEW and the clean energy each bus used from it, told apart by "type". In format csv they are written
+    /// to resultFile_summary.csv, _buses.csv, _stops.csv, _windows.csv and _windowBuses.csv. summaryOnly only writes
+    /// the summary
+    void writeResults(const primitiveVariables &variables, const vector<vector<string>> &stationData,
+                      const RunOutcome &outcome, string resultFile, string format, bool summaryOnly = false);
 
 private:
+    ostream &out;
+
+    /// prints size values starting at values, a slice of one of the per stop arrays
     template <class T>
-    void printLoop(string variable, vector<T> values);
+    void printLoop(string variable, const T *values, int size);
 };
-
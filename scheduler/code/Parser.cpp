@@ -3,6 +3,12 @@
 #include "fstream"
 #include "Parser.h"
 #include "Utils.h"
+#include "SolutionArchive.h"
+#include "BusDataReader.h"
+#include "MappedCSV.h"
+#include "CEWStore.h"
+#include "RunMetrics.h"
+#include "charconv"
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/map.hpp>
@@ -12,7 +18,20 @@ using namespace std;
 
 /// load the names of the stops
 vector<vector<string>> Parser::parseStopsFile(string stopsFile){
-    return Parser::myFileReader.readCSV(stopsFile);
+    Parser::myFileReader.validatePath(stopsFile);
+    MappedCSV file;
+    string error;
+    if(!file.open(stopsFile, error)){
+        cout << error << endl;
+        exit(-1);
+    }
+    vector<vector<string>> stops(file.numberRows());
+    long failedRow;
+    file.forEachRow([&stops](long row, const vector<string_view> &fields){
+        stops[row].assign(fields.begin(), fields.end());
+        return true;
+    }, 1, failedRow);
+    return stops;
 }
 
 /// load the file containing information for X_i
@@ -38,8 +57,19 @@ vector<int> Parser::parseChargingStationsFile(string chargingStationFile){
 }
 
 /// load the values of a previous solution in using boost libraries
+/// binary archives are mapped and copied, older solutions are read from the boost text archive
 primitiveVariables Parser::parseSolutionFile(string solutionFile){
     Parser::myFileReader.validatePath(solutionFile);
+    if(SolutionArchive::isArchive(solutionFile)){
+        SolutionArchive archive;
+        string error;
+        if(!archive.open(solutionFile, error)){
+            cout << error << endl;
+            exit(-1);
+        }
+        return archive.load();
+    }
+
     primitiveVariables loadedVars;
     {
         ifstream ifs(solutionFile);
@@ -65,68 +95,190 @@ map<string, string> Parser::parseArguments(int argc, char *argv[]){
     return parsedArguments;
 }
 
-/// assigns values for D_ij
-vector<vector<double>> Parser::parseDistanceFile(string stationDistanceFile, int numStations){
-    vector<vector<double>> distances(numStations, vector<double>(numStations));
+/// assigns values for D_ij. The rows are converted into columns by several threads and then placed in file order, so
+/// a pair which is given twice keeps its last distance. The matrix is symmetric, the distance from i to j is taken from
+/// the row with from < to
+shared_ptr<const DistanceMatrix> Parser::parseDistanceFile(string stationDistanceFile, int numStations, int threads){
+    shared_ptr<DistanceMatrix> distances = make_shared<DistanceMatrix>(numStations);
 
-    for (auto &row: Parser::myFileReader.readCSV(stationDistanceFile)) {
-        distances[stoi(row[0])][stoi(row[1])] = stof(row[2]);
+    Parser::myFileReader.validatePath(stationDistanceFile);
+    MappedCSV file;
+    string error;
+    if(!file.open(stationDistanceFile, error)){
+        cout << error << endl;
+        exit(-1);
     }
-    for (int i = 0; i < numStations; i++) {
-        for (int j = 0; j <= i; j++) {
-            if (i == j) {
-                distances[i][j] = 0.0;
-            } else if (i > 0) {
-                distances[i][j] = distances[j][i];
-            }
+    long numberRows = file.numberRows();
+    vector<int> from(numberRows, -1);
+    vector<int> to(numberRows, -1);
+    vector<float> distance(numberRows);
+    long failedRow;
+    bool valid = file.forEachRow([&](long row, const vector<string_view> &fields){
+        /// empty lines are skipped
+        if(fields.empty()){
+            return true;
+        }
+        if(fields.size() < 3 || !MappedCSV::toInt(fields[0], from[row]) || !MappedCSV::toInt(fields[1], to[row]) ||
+           !MappedCSV::toFloat(fields[2], distance[row])){
+            return false;
+        }
+        return from[row] >= 0 && from[row] < numStations && to[row] >= 0 && to[row] < numStations;
+    }, threads, failedRow);
+    if(!valid){
+        /// the header is line 1
+        cout << stationDistanceFile << " line " << failedRow + 2 << " is not a distance between two stations" << endl;
+        exit(-1);
+    }
+    for(long row = 0; row < numberRows; row++){
+        if(from[row] >= 0 && from[row] < to[row]){
+            distances->set(from[row], to[row], distance[row]);
         }
     }
     return distances;
 
 }
 
-/// load bus route information
+/// load bus route information, the file is streamed into the per stop arrays by BusDataReader
 ModelParameters Parser::parseBusData(string busDataFile, ModelParameters parameters) {
-    map<string, pair<int, int>> busTimeTables;
-
-    json busData = Parser::myFileReader.readJson(busDataFile);
-
-    for (auto &busRoute: busData) {
-              json routeBuses = busRoute.at("buses");
-        for (auto &bus: routeBuses) {
-
-            vector<int> sequence;
-            vector<double> times;
-            vector<int> rest;
-
-            int busNum = bus.at("bus");
-            int sequenceCap = -1;
-            for (int i = 0; i < bus.at("path").size(); i++) {
-                if (times.size() == sequenceCap) {
-                    break;
-                }
-                json stop = bus.at("path")[i];
-                string time = stop.at("time");
-                double convertedTime = Parser::myUtils.convertTime(time);
-
-                if (convertedTime == 0) {
-                    convertedTime = 24.0;
-                }
-
-                times.push_back(convertedTime);
-                sequence.push_back(stop.at("station_id"));
-                if (stop.contains("rest")) {
-                    rest.push_back(1);
-                } else {
-                    rest.push_back(0);
-                }
-            }
-            parameters.busKeys.push_back(busNum);
-            parameters.busSequencesRaw[busNum] = sequence;
-            parameters.busTimeRaw[busNum] = times;
-            parameters.rests[busNum] = rest;
-        }
+    Parser::myFileReader.validatePath(busDataFile);
+    cout << busDataFile << endl;
+
+    BusDataReader reader(parameters);
+    string error;
+    if(!reader.read(busDataFile, error)){
+        cout << error << endl;
+        exit(-1);
     }
     return parameters;
 }
 
+
+/// load the data which only depends on the location (X_i, station names, D_ij and the bus routes), so it can be
+/// shared by every run for that location
+ModelParameters Parser::parseLocationData(map<string, string> arguments){
+    ModelParameters parameters;
+
+    /// load the value of X_i
+    if(!arguments["chargingStationsFile"].empty()){
+        PhaseTimer timer("parse.chargingStations");
+        parameters.chargingStops = parseChargingStationsFile(arguments["chargingStationsFile"]);
+    }
+
+    /// load station name
+    {
+        PhaseTimer timer("parse.stations");
+        parameters.stationData = parseStopsFile(arguments["stationDataFile"]);
+        parameters.numberStations = parameters.stationData.size();
+    }
+
+    /// load the distance between each station (D_ij)
+    {
+        PhaseTimer timer("parse.distances");
+        parameters.distances = parseDistanceFile(arguments["stationDistanceFile"], parameters.numberStations);
+    }
+
+    /// load bus route information (i.e., number of buses, their route etc)
+    PhaseTimer timer("parse.busData");
+    return parseBusData(arguments["busDataFile"], parameters);
+}
+
+/// splits the CEW given on the command line in a single pass, the start time and end time of a CEW are seperated by
+/// "-", the amount of excess clean energy is preceded by "=", and the CEW are separated by ",". error describes the
+/// first CEW which can not be read if false is returned
+bool Parser::splitCleanEnergyWindows(string_view windows, vector<CleanEnergyWindow> &cleanEnergyWindows,
+                                     string &error){
+    cleanEnergyWindows.clear();
+    size_t position = 0;
+    while(position < windows.size()){
+        size_t end = min(windows.find(',', position), windows.size());
+        string_view window = windows.substr(position, end - position);
+        position = end + 1;
+        while(!window.empty() && isspace((unsigned char) window.front())){
+            window.remove_prefix(1);
+        }
+        while(!window.empty() && isspace((unsigned char) window.back())){
+            window.remove_suffix(1);
+        }
+        if(window.empty()){
+            continue;
+        }
+
+        CleanEnergyWindow cleanEnergyWindow;
+        const char *last = window.data() + window.size();
+        from_chars_result result = from_chars(window.data(), last, cleanEnergyWindow.startTime);
+        bool valid = result.ec == errc() && result.ptr < last && *result.ptr == '-';
+        if(valid){
+            result = from_chars(result.ptr + 1, last, cleanEnergyWindow.endTime);
+            valid = result.ec == errc() && result.ptr < last && *result.ptr == '=';
+        }
+        if(valid){
+            result = from_chars(result.ptr + 1, last, cleanEnergyWindow.availableEnergy);
+            valid = result.ec == errc() && result.ptr == last;
+        }
+        if(!valid){
+            error = "CEW '" + string(window) + "' is not start-end=energy";
+            return false;
+        }
+        cleanEnergyWindows.push_back(cleanEnergyWindow);
+    }
+    return true;
+}
+
+/// the CEW with excess clean energy, with the share of the energy which is available to this location
+vector<CleanEnergyWindow> Parser::availableWindows(const vector<CleanEnergyWindow> &windows, double powerRatio,
+                                                   ostream &out){
+    vector<CleanEnergyWindow> cleanEnergyWindows;
+    for(auto &window: windows){
+        /// if there is no excess clean energy available for the current CEW then it is removed.
+        if(window.availableEnergy == 0){
+            out << "no energy " << window.startTime << " " << window.endTime << " " << window.availableEnergy << endl;
+            continue;
+        }
+        cleanEnergyWindows.push_back(CleanEnergyWindow{.startTime=window.startTime, .endTime=window.endTime,
+                                                       .availableEnergy=window.availableEnergy * powerRatio});
+    }
+    return cleanEnergyWindows;
+}
+
+/// parse the CEW given on the command line, see splitCleanEnergyWindows
+vector<CleanEnergyWindow> Parser::parseCleanEnergyWindows(string windows, double powerRatio, ostream &out){
+    PhaseTimer timer("parse.cew");
+    vector<CleanEnergyWindow> cleanEnergyWindows;
+    string error;
+    if(!splitCleanEnergyWindows(windows, cleanEnergyWindows, error)){
+        out << error << endl;
+        exit(-1);
+    }
+    return availableWindows(cleanEnergyWindows, powerRatio, out);
+}
+
+/// the CEW of key in a store compiled by cew_store
+vector<CleanEnergyWindow> Parser::parseCEWStore(string storeFile, string key, double powerRatio, ostream &out){
+    PhaseTimer timer("parse.cew");
+    CEWStore store;
+    string error;
+    if(!store.open(storeFile, error)){
+        out << error << endl;
+        exit(-1);
+    }
+    vector<CleanEnergyWindow> cleanEnergyWindows;
+    if(!store.windows(key, cleanEnergyWindows)){
+        out << storeFile << " has no CEW for " << key << endl;
+        exit(-1);
+    }
+    return availableWindows(cleanEnergyWindows, powerRatio, out);
+}
+
+/// the last line of a CEW file holds the windows in the same format as the command line argument
+string Parser::readCEWFile(string cewFile){
+    Parser::myFileReader.validatePath(cewFile);
+    ifstream file(cewFile);
+    string line;
+    string windows;
+    while(getline(file, line)){
+        if(!line.empty()){
+            windows = line;
+        }
+    }
+    return windows;
+}
@@ -1,6 +1,8 @@
 #include "DataStructures.h"
 #include "FileReader.h"
 #include "Utils.h"
+#include "iostream"
+#include "string_view"
 
 class Parser {
 public:
@@ -8,8 +10,17 @@ public:
     vector<int> parseChargingStationsFile(string chargingStationFile);
     primitiveVariables parseSolutionFile(string solutionFile);
     map<string, string> parseArguments(int argc, char *argv[]);
-    vector<vector<double>> parseDistanceFile(string stationDistanceFile, int numStations);
+    /// threads is the number of threads which convert the rows, all cores if 0
+    shared_ptr<const DistanceMatrix> parseDistanceFile(string stationDistanceFile, int numStations, int threads = 0);
     ModelParameters parseBusData(string busDataFile, ModelParameters parameters);
+    ModelParameters parseLocationData(map<string, string> arguments);
+    vector<CleanEnergyWindow> parseCleanEnergyWindows(string windows, double powerRatio, ostream &out);
+    vector<CleanEnergyWindow> parseCEWStore(string storeFile, string key, double powerRatio, ostream &out);
+    vector<CleanEnergyWindow> availableWindows(const vector<CleanEnergyWindow> &windows, double powerRatio,
+                                               ostream &out);
+    static bool splitCleanEnergyWindows(string_view windows, vector<CleanEnergyWindow> &cleanEnergyWindows,
+                                        string &error);
+    string readCEWFile(string cewFile);
 
 private:
     FileReader myFileReader;
@@ -0,0 +1,251 @@
+#include "PlacementSearch.h"
+#include "Utils.h"
+#include "BusChargePlanner.h"
+#include "algorithm"
+#include "chrono"
+#include "random"
+#include "thread"
+
+using namespace std;
+
+/// the number of iterations in which the stations of a move are not changed again
+static const int TABU_TENURE = 5;
+
+bool PlacementScore::operator<(const PlacementScore &other) const{
+    if(unplannedBuses != other.unplannedBuses){
+        return unplannedBuses < other.unplannedBuses;
+    }
+    return nonRenewable < other.nonRenewable - 1e-9;
+}
+
+PlacementSearch::PlacementSearch(const ModelParameters &parameters, const RunConfig &config, ostream &out):
+        parameters(parameters), config(config), out(out){
+    this->parameters.chargingStops.resize(parameters.numberStations, 0);
+    this->parameters.setLegs(config.busEnergyCost, config.busSpeed);
+    threads = config.threads > 0 ? config.threads : max(1, (int) thread::hardware_concurrency());
+
+    stationBuses = vector<vector<int>>(parameters.numberStations);
+    busStations = vector<vector<int>>(parameters.numberBuses());
+    knownScores = vector<unordered_map<string, PlacementScore>>(parameters.numberBuses());
+    busMutexes = vector<mutex>(parameters.numberBuses());
+    for(int n = 0; n < parameters.numberBuses(); n++){
+        vector<int> &stations = busStations[n];
+        stations.assign(parameters.stations.begin() + parameters.stopStart[n],
+                        parameters.stations.begin() + parameters.stopStart[n + 1]);
+        sort(stations.begin(), stations.end());
+        stations.erase(unique(stations.begin(), stations.end()), stations.end());
+        for(int station: stations){
+            stationBuses[station].push_back(n);
+        }
+    }
+    for(int station = 0; station < stationBuses.size(); station++){
+        if(!stationBuses[station].empty()){
+            visitedStations.push_back(station);
+        }
+    }
+    budget = config.placementBudget;
+    if(budget > visitedStations.size()){
+        out << "The buses stop at " << visitedStations.size() << " stations, the placements have a charger at each "
+            << "of them instead of " << budget << endl;
+        budget = visitedStations.size();
+    }
+
+    /// a station no bus stops at is closed, then the stations with the most buses are kept or opened
+    vector<int> &chargingStops = this->parameters.chargingStops;
+    vector<int> byBuses = visitedStations;
+    stable_sort(byBuses.begin(), byBuses.end(), [&](int a, int b){
+        if(chargingStops[a] != chargingStops[b]){
+            return chargingStops[a] > chargingStops[b];
+        }
+        return stationBuses[a].size() > stationBuses[b].size();
+    });
+    int open = 0;
+    for(int station = 0; station < chargingStops.size(); station++){
+        open += chargingStops[station] == 1 && !stationBuses[station].empty() ? 1 : 0;
+    }
+    fill(chargingStops.begin(), chargingStops.end(), 0);
+    for(int i = 0; i < budget; i++){
+        chargingStops[byBuses[i]] = 1;
+    }
+    if(open != budget){
+        out << "The placement of the charging stations file has " << open << " stations the buses stop at, the "
+            << "search starts from " << budget << " of the stations with the most buses" << endl;
+    }
+}
+
+/// the score of bus n alone with the given charging stations, the bus is only planned if it was not planned with the
+/// same chargers on its route before
+PlacementScore PlacementSearch::busScore(int n, const vector<int> &chargingStops) const{
+    string key(busStations[n].size(), '0');
+    for(int i = 0; i < key.size(); i++){
+        key[i] = chargingStops[busStations[n][i]] == 1 ? '1' : '0';
+    }
+    {
+        lock_guard<mutex> lock(busMutexes[n]);
+        auto known = knownScores[n].find(key);
+        if(known != knownScores[n].end()){
+            return known->second;
+        }
+    }
+    ModelParameters bus = parameters.singleBus(n);
+    bus.chargingStops = chargingStops;
+    BusChargePlanner planner(bus, config, parameters.cleanEnergyWindows);
+    ChargePlan plan = planner.plan(0);
+    PlacementScore score;
+    score.unplannedBuses = plan.feasible ? 0 : 1;
+    score.nonRenewable = plan.feasible ? plan.nonRenewable : 0.0;
+    lock_guard<mutex> lock(busMutexes[n]);
+    knownScores[n][key] = score;
+    return score;
+}
+
+PlacementScore PlacementSearch::evaluate(const vector<int> &chargingStops){
+    vector<PlacementScore> busScores(parameters.numberBuses());
+    parallelFor(busScores.size(), threads, [&](int n){
+        busScores[n] = busScore(n, chargingStops);
+    });
+    PlacementScore score;
+    for(auto &busScore: busScores){
+        score.unplannedBuses += busScore.unplannedBuses;
+        score.nonRenewable += busScore.nonRenewable;
+    }
+    evaluated++;
+    return score;
+}
+
+/// adds the placement to the best placements if it is one of the placementKeep best ones seen so far
+void PlacementSearch::keepBest(const vector<int> &chargingStops, const PlacementScore &score,
+                               vector<Placement> &best) const{
+    if(best.size() >= config.placementKeep && !(score < best.back().score)){
+        return;
+    }
+    for(auto &placement: best){
+        if(placement.chargingStops == chargingStops){
+            return;
+        }
+    }
+    auto position = upper_bound(best.begin(), best.end(), score, [](const PlacementScore &s, const Placement &p){
+        return s < p.score;
+    });
+    best.insert(position, {chargingStops, score});
+    if(best.size() > config.placementKeep){
+        best.pop_back();
+    }
+}
+
+vector<Placement> PlacementSearch::run(){
+    auto startTime = chrono::steady_clock::now();
+    vector<int> current = parameters.chargingStops;
+    vector<PlacementScore> busScores(parameters.numberBuses());
+    parallelFor(busScores.size(), threads, [&](int n){
+        busScores[n] = busScore(n, current);
+    });
+    PlacementScore currentScore;
+    for(auto &busScore: busScores){
+        currentScore.unplannedBuses += busScore.unplannedBuses;
+        currentScore.nonRenewable += busScore.nonRenewable;
+    }
+    evaluated++;
+    vector<Placement> best;
+    keepBest(current, currentScore, best);
+    out << "Placement search: " << budget << " of " << visitedStations.size() << " stations, start with "
+        << currentScore.unplannedBuses << " unplanned buses and " << currentScore.nonRenewable
+        << " non-clean energy" << endl;
+
+    /// a move closes an open station and opens a closed one, only the buses of the two stations are planned again
+    struct Move{
+        int close;
+        int open;
+        vector<int> buses;
+        vector<PlacementScore> busScores;
+        PlacementScore score;
+    };
+    mt19937 generator(42);
+    vector<int> tabuUntil(parameters.numberStations, 0);
+    vector<Move> moves(config.placementCandidates);
+    for(int iteration = 1; iteration <= config.placementIterations; iteration++){
+        vector<int> openStations, closedStations;
+        for(bool tabu: {true, false}){
+            openStations.clear();
+            closedStations.clear();
+            for(int station: visitedStations){
+                if(!tabu || tabuUntil[station] < iteration){
+                    (current[station] == 1 ? openStations : closedStations).push_back(station);
+                }
+            }
+            if(!openStations.empty() && !closedStations.empty()){
+                break;
+            }
+        }
+        if(openStations.empty() || closedStations.empty()){
+            break;
+        }
+
+        uniform_int_distribution<int> closeDistribution(0, openStations.size() - 1);
+        uniform_int_distribution<int> openDistribution(0, closedStations.size() - 1);
+        for(auto &move: moves){
+            move.close = openStations[closeDistribution(generator)];
+            move.open = closedStations[openDistribution(generator)];
+        }
+        parallelFor(moves.size(), threads, [&](int m){
+            Move &move = moves[m];
+            vector<int> chargingStops = current;
+            chargingStops[move.close] = 0;
+            chargingStops[move.open] = 1;
+            const vector<int> &closeBuses = stationBuses[move.close];
+            const vector<int> &openBuses = stationBuses[move.open];
+            move.buses.clear();
+            set_union(closeBuses.begin(), closeBuses.end(), openBuses.begin(), openBuses.end(),
+                      back_inserter(move.buses));
+            move.busScores.resize(move.buses.size());
+            move.score = currentScore;
+            for(int b = 0; b < move.buses.size(); b++){
+                int n = move.buses[b];
+                move.busScores[b] = busScore(n, chargingStops);
+                move.score.unplannedBuses += move.busScores[b].unplannedBuses - busScores[n].unplannedBuses;
+                move.score.nonRenewable += move.busScores[b].nonRenewable - busScores[n].nonRenewable;
+            }
+        });
+        evaluated += moves.size();
+
+        int bestMove = 0;
+        for(int m = 0; m < moves.size(); m++){
+            vector<int> chargingStops = current;
+            chargingStops[moves[m].close] = 0;
+            chargingStops[moves[m].open] = 1;
+            keepBest(chargingStops, moves[m].score, best);
+            if(moves[m].score < moves[bestMove].score){
+                bestMove = m;
+            }
+        }
+
+        /// the best move is taken even if it is worse than the current placement, so the search leaves local optima
+        Move &move = moves[bestMove];
+        current[move.close] = 0;
+        current[move.open] = 1;
+        for(int b = 0; b < move.buses.size(); b++){
+            busScores[move.buses[b]] = move.busScores[b];
+        }
+        currentScore = move.score;
+        tabuUntil[move.close] = iteration + TABU_TENURE;
+        tabuUntil[move.open] = iteration + TABU_TENURE;
+        if(iteration % 10 == 0){
+            out << "Iteration " << iteration << ": " << currentScore.unplannedBuses << " unplanned buses and "
+                << currentScore.nonRenewable << " non-clean energy, best " << best.front().score.unplannedBuses
+                << " and " << best.front().score.nonRenewable << endl;
+        }
+    }
+    elapsed = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    out << "Placements evaluated: " << evaluated << " in " << elapsed << " s, " << evaluated / max(elapsed, 1e-9)
+        << " per second" << endl;
+    return best;
+}
+
+long PlacementSearch::evaluatedPlacements() const{
+    return evaluated;
+}
+
+double PlacementSearch::elapsedTime() const{
+    return elapsed;
+}
+
@@ -0,0 +1,71 @@
+#ifndef SCHEDULER_PLACEMENT_SEARCH_H
+#define SCHEDULER_PLACEMENT_SEARCH_H
+#include "vector"
+#include "functional"
+#include "iostream"
+#include "mutex"
+#include "string"
+#include "unordered_map"
+#include "DataStructures.h"
+#include "RunConfig.h"
+
+using namespace std;
+
+/// how good a placement is: the buses without a plan first, then the non-clean energy of the planned buses
+struct PlacementScore{
+    int unplannedBuses = 0;
+    double nonRenewable = 0.0;
+
+    bool operator<(const PlacementScore &other) const;
+};
+
+/// the charging stations of a placement, in the layout of ModelParameters::chargingStops
+struct Placement{
+    vector<int> chargingStops;
+    PlacementScore score;
+};
+
+/// Searches the placements of a given number of charging stations. Each bus is planned alone by BusChargePlanner, so
+/// the buses do not share the chargers or the clean energy, and the score of a placement is the sum of the scores of
+/// its buses. A move closes one station and opens another, and only the buses which stop at one of the two are
+/// planned again, and a bus is only planned once for each set of chargers on its route. Each iteration evaluates a
+/// batch of random moves in parallel and takes the best one, even if it is worse, the stations of the last moves are
+/// not changed again for a few iterations (tabu search).
+class PlacementSearch{
+public:
+    /// the search starts from parameters.chargingStops with stations opened or closed to reach the budget
+    PlacementSearch(const ModelParameters &parameters, const RunConfig &config, ostream &out = cout);
+
+    /// the best placements found, best first
+    vector<Placement> run();
+    PlacementScore evaluate(const vector<int> &chargingStops);
+
+    long evaluatedPlacements() const;
+    double elapsedTime() const;
+
+private:
+    /// the score of bus n alone with the given charging stations
+    PlacementScore busScore(int n, const vector<int> &chargingStops) const;
+    void keepBest(const vector<int> &chargingStops, const PlacementScore &score, vector<Placement> &best) const;
+
+    ModelParameters parameters;
+    RunConfig config;
+    ostream &out;
+
+    /// the buses which stop at each station, the stations each bus stops at and the stations at which any bus stops
+    vector<vector<int>> stationBuses;
+    vector<vector<int>> busStations;
+    vector<int> visitedStations;
+
+    /// the score of each bus for the sets of chargers on its route it was planned with, the key has a character for
+    /// each station of busStations
+    mutable vector<unordered_map<string, PlacementScore>> knownScores;
+    mutable vector<mutex> busMutexes;
+
+    int budget;
+    int threads;
+    long evaluated = 0;
+    double elapsed = 0.0;
+};
+
+#endif //SCHEDULER_PLACEMENT_SEARCH_H
@@ -0,0 +1,58 @@
+#include "RollingHorizon.h"
+#include "chrono"
+#include "SchedulingProblem.h"
+#include "Solver.h"
+#include "Output.h"
+
+using namespace std;
+
+RollingHorizon::RollingHorizon(const ModelParameters &parameters, const RunConfig &config, ostream &out):
+        parameters(parameters), config(config), out(out){}
+
+primitiveVariables RollingHorizon::run(const vector<double> &checkpoints,
+                                       const vector<vector<CleanEnergyWindow>> &windows){
+    primitiveVariables schedule;
+    if(checkpoints.size() < 2){
+        return schedule;
+    }
+
+    RunConfig horizonConfig = config;
+    horizonConfig.recalculate = false;
+    horizonConfig.horizonStartTime = checkpoints[0];
+    horizonConfig.horizonEndTime = checkpoints[1];
+    ModelParameters horizonParameters = parameters;
+    horizonParameters.cleanEnergyWindows = windows[0];
+
+    SchedulingProblem problem(horizonParameters, horizonConfig, out);
+    Solver solver(horizonConfig, out);
+    Output printer(out);
+    for(int t = 0; t + 1 < checkpoints.size(); t++){
+        auto updateStartTime = chrono::steady_clock::now();
+        out << "Checkpoint: " << checkpoints[t] << " to " << checkpoints[t + 1] << endl;
+        if(t == 0){
+            problem.build();
+            double buildTime = chrono::duration<double, milli>(chrono::steady_clock::now() - updateStartTime).count();
+            out << "Build time (ms): " << buildTime << endl;
+            schedule = solver.solve(problem);
+        }
+        else{
+            ModelChanges changes = problem.advanceHorizon(schedule, checkpoints[t], checkpoints[t + 1], windows[t]);
+            primitiveVariables startSchedule = problem.restartSchedule(schedule);
+            double updateTime = chrono::duration<double, milli>(chrono::steady_clock::now() - updateStartTime).count();
+            out << "Update time (ms): " << updateTime << "\tChanged columns: " << changes.columns.size()
+                << "\tChanged rows: " << changes.rows.size() << "\tNumber of constraints: "
+                << problem.model.numberRows() << endl;
+            schedule = solver.resolve(problem, changes, startSchedule);
+        }
+
+        if(schedule.buses.empty()){
+            out << solver.result().status << endl;
+            return schedule;
+        }
+        printer.reportResults(schedule, parameters.stationData,
+                              {checkpoints[t], checkpoints[t + 1], solver.result().objectiveValue,
+                               solver.result().status, solver.result().relativeGap, solver.elapsedTime(),
+                               config.method}, config);
+    }
+    return schedule;
+}
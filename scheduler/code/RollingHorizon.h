@@ -0,0 +1,27 @@
+#ifndef SCHEDULER_ROLLING_HORIZON_H
+#define SCHEDULER_ROLLING_HORIZON_H
+#include "vector"
+#include "iostream"
+#include "DataStructures.h"
+#include "RunConfig.h"
+
+using namespace std;
+
+/// Solves the checkpoints of a day inside one process. The model is built and loaded into the solver once, at each
+/// following checkpoint only the stops which have been reached are fixed, the end of the horizon is moved and the CEW
+/// are replaced, and the search starts from the schedule of the previous checkpoint.
+class RollingHorizon{
+public:
+    RollingHorizon(const ModelParameters &parameters, const RunConfig &config, ostream &out = cout);
+
+    /// solve the horizons checkpoints[t] to checkpoints[t + 1] with windows[t] as the CEW. Returns the schedule of the
+    /// last checkpoint, which has no buses if a checkpoint could not be solved
+    primitiveVariables run(const vector<double> &checkpoints, const vector<vector<CleanEnergyWindow>> &windows);
+
+private:
+    ModelParameters parameters;
+    RunConfig config;
+    ostream &out;
+};
+
+#endif //SCHEDULER_ROLLING_HORIZON_H
@@ -0,0 +1,213 @@
+#include "RunConfig.h"
+#include "iostream"
+#include "cmath"
+
+using namespace std;
+
+const vector<string> RunConfig::requiredArguments = {
+        "chargeRate", "busEnergyCost", "busSpeed", "maxBatteryCapacity", "minBatteryCapacity", "startingCapacity",
+        "maxChargeTime", "minChargeTime", "deviationTime", "powerRatio", "busDataFile", "stationDataFile",
+        "stationDistanceFile", "chargingStationsFile"
+};
+
+const vector<string> RunConfig::simulationArguments = {"simulate", "chargeRate"};
+
+/// parses a whole argument as a number, the value is left unchanged and an error is added if it is not one
+static void parseNumber(const map<string, string> &arguments, const string &name, double &value,
+                        vector<string> &errors){
+    auto argument = arguments.find(name);
+    if(argument == arguments.end()){
+        return;
+    }
+    size_t end = 0;
+    try{
+        double parsed = stod(argument->second, &end);
+        if(argument->second.find_first_not_of(" \t", end) != string::npos){
+            throw invalid_argument(name);
+        }
+        value = parsed;
+    }
+    catch(logic_error &){
+        errors.push_back("--" + name + " '" + argument->second + "' is not a number");
+    }
+}
+
+static void parseInteger(const map<string, string> &arguments, const string &name, int &value,
+                         vector<string> &errors){
+    double parsed = value;
+    int previousErrors = errors.size();
+    parseNumber(arguments, name, parsed, errors);
+    if(errors.size() == previousErrors && parsed != (int) parsed){
+        errors.push_back("--" + name + " '" + arguments.at(name) + "' is not an integer");
+    }
+    else if(errors.size() == previousErrors){
+        value = (int) parsed;
+    }
+}
+
+RunConfig RunConfig::fromArguments(const map<string, string> &arguments, vector<string> &errors){
+    RunConfig config;
+    auto has = [&arguments](const string &name){
+        return arguments.find(name) != arguments.end();
+    };
+    for(const string &name: has("simulate") ? simulationArguments : requiredArguments){
+        if(!has(name)){
+            errors.push_back("--" + name + " is missing");
+        }
+    }
+
+    if(has("method")) config.method = arguments.at("method");
+    parseNumber(arguments, "chargeRate", config.chargeRate, errors);
+    parseInteger(arguments, "bigM", config.bigM, errors);
+    parseNumber(arguments, "busEnergyCost", config.busEnergyCost, errors);
+    parseNumber(arguments, "busSpeed", config.busSpeed, errors);
+    parseNumber(arguments, "maxBatteryCapacity", config.maxBatteryCapacity, errors);
+    parseNumber(arguments, "minBatteryCapacity", config.minBatteryCapacity, errors);
+    parseNumber(arguments, "startingCapacity", config.startingCapacity, errors);
+    parseNumber(arguments, "maxChargeTime", config.maxChargeTime, errors);
+    parseNumber(arguments, "minChargeTime", config.minChargeTime, errors);
+    parseNumber(arguments, "deviationTime", config.deviationTime, errors);
+    parseNumber(arguments, "horizonStartTime", config.horizonStartTime, errors);
+    parseNumber(arguments, "horizonEndTime", config.horizonEndTime, errors);
+    parseNumber(arguments, "discountFactor", config.discountFactor, errors);
+    parseNumber(arguments, "powerRatio", config.powerRatio, errors);
+    if(has("cewCoarsening")) config.cewCoarsening = arguments.at("cewCoarsening");
+    parseNumber(arguments, "cewTolerance", config.cewTolerance, errors);
+    if(has("recalculate")) config.recalculate = arguments.at("recalculate") == "true";
+    if(has("greedyStart")) config.greedyStart = arguments.at("greedyStart") != "false";
+    if(has("compressStops")) config.compressStops = arguments.at("compressStops") != "false";
+    if(has("formulation")) config.formulation = arguments.at("formulation");
+    if(has("decomposition")) config.decomposition = arguments.at("decomposition");
+    parseInteger(arguments, "decompositionIterations", config.decompositionIterations, errors);
+    if(has("subproblemSolver")) config.subproblemSolver = arguments.at("subproblemSolver");
+    parseNumber(arguments, "dpTimeStep", config.dpTimeStep, errors);
+    parseNumber(arguments, "dpEnergyStep", config.dpEnergyStep, errors);
+    parseInteger(arguments, "placementBudget", config.placementBudget, errors);
+    parseInteger(arguments, "placementIterations", config.placementIterations, errors);
+    parseInteger(arguments, "placementCandidates", config.placementCandidates, errors);
+    parseInteger(arguments, "placementKeep", config.placementKeep, errors);
+    if(has("placementSaveFile")) config.placementSaveFile = arguments.at("placementSaveFile");
+    parseInteger(arguments, "simulationScenarios", config.simulationScenarios, errors);
+    parseNumber(arguments, "scenarioNoise", config.scenarioNoise, errors);
+    parseNumber(arguments, "scenarioCorrelation", config.scenarioCorrelation, errors);
+    if(has("simulationSaveFile")) config.simulationSaveFile = arguments.at("simulationSaveFile");
+    if(has("backend")) config.backend = arguments.at("backend");
+    if(has("modelFile")) config.modelFile = arguments.at("modelFile");
+    parseInteger(arguments, "timeout", config.timeout, errors);
+    parseInteger(arguments, "maxSolutions", config.maxSolutions, errors);
+    parseInteger(arguments, "threads", config.threads, errors);
+    if(has("report")) config.report = arguments.at("report");
+    if(has("resultFile")) config.resultFile = arguments.at("resultFile");
+    if(has("metricsFile")) config.metricsFile = arguments.at("metricsFile");
+    if(has("perfCounters")) config.perfCounters = arguments.at("perfCounters") == "true";
+    if(has("resultFormat")) config.resultFormat = arguments.at("resultFormat");
+    if(has("resultDetail")) config.resultDetail = arguments.at("resultDetail");
+    if(has("logFile")) config.logFile = arguments.at("logFile");
+    if(has("warmingSolutionFile")) config.warmingSolutionFile = arguments.at("warmingSolutionFile");
+    if(has("LPFile")) config.solutionFile = arguments.at("LPFile");
+    if(has("solutionSaveFile")) config.solutionSaveFile = arguments.at("solutionSaveFile");
+    if(has("solutionDataFile")) config.solutionDataFile = arguments.at("solutionDataFile");
+
+    /// the values have to describe a model which can be built
+    if(config.method != "MPM" && config.method != "SPM"){
+        errors.push_back("--method '" + config.method + "' is not MPM or SPM");
+    }
+    if(config.formulation != "bigM" && config.formulation != "indicator"){
+        errors.push_back("--formulation '" + config.formulation + "' is not bigM or indicator");
+    }
+    if(config.cewCoarsening != "none" && config.cewCoarsening != "merge" && config.cewCoarsening != "refine"){
+        errors.push_back("--cewCoarsening '" + config.cewCoarsening + "' is not none, merge or refine");
+    }
+    if(config.cewCoarsening == "refine" && config.decomposition != "none"){
+        errors.push_back("--cewCoarsening refine needs --decomposition none");
+    }
+    if(config.cewTolerance < 0.0){
+        errors.push_back("--cewTolerance must not be negative");
+    }
+    if(config.decomposition != "none" && config.decomposition != "lagrangian"){
+        errors.push_back("--decomposition '" + config.decomposition + "' is not none or lagrangian");
+    }
+    if(config.decomposition != "none" && config.recalculate){
+        errors.push_back("--decomposition can not recalculate a schedule, use --decomposition none");
+    }
+    if(config.decompositionIterations <= 0){
+        errors.push_back("--decompositionIterations must be positive");
+    }
+    if(config.subproblemSolver != "mip" && config.subproblemSolver != "dp"){
+        errors.push_back("--subproblemSolver '" + config.subproblemSolver + "' is not mip or dp");
+    }
+    if(config.dpTimeStep <= 0.0 || config.dpEnergyStep <= 0.0){
+        errors.push_back("--dpTimeStep and --dpEnergyStep must be positive");
+    }
+    if(has("placementBudget") && config.placementBudget <= 0){
+        errors.push_back("--placementBudget must be positive");
+    }
+    if(config.placementIterations < 0 || config.placementCandidates <= 0 || config.placementKeep <= 0){
+        errors.push_back("--placementIterations must not be negative and --placementCandidates and --placementKeep "
+                         "must be positive");
+    }
+    if(config.simulationScenarios < 0 || config.scenarioNoise < 0.0 || abs(config.scenarioCorrelation) > 1.0){
+        errors.push_back("--simulationScenarios and --scenarioNoise must not be negative and --scenarioCorrelation "
+                         "must be between -1 and 1");
+    }
+    if(config.report != "full" && config.report != "summary" && config.report != "none"){
+        errors.push_back("--report '" + config.report + "' is not full, summary or none");
+    }
+    if(config.resultFormat != "jsonl" && config.resultFormat != "csv"){
+        errors.push_back("--resultFormat '" + config.resultFormat + "' is not jsonl or csv");
+    }
+    if(config.resultDetail != "full" && config.resultDetail != "summary"){
+        errors.push_back("--resultDetail '" + config.resultDetail + "' is not full or summary");
+    }
+    if(has("cewStore") != has("cewKey")){
+        errors.push_back("--cewStore and --cewKey are only used together");
+    }
+    if(config.method == "SPM" && !has("discountFactor")){
+        errors.push_back("--discountFactor is missing, it is required by SPM");
+    }
+    if(config.recalculate && config.solutionDataFile.empty()){
+        errors.push_back("--solutionDataFile is missing, it is required to recalculate a schedule");
+    }
+    /// a replayed schedule already holds the times and the energy of its trips
+    if(config.chargeRate <= 0.0 || (!has("simulate") && config.busSpeed <= 0.0)){
+        errors.push_back("--chargeRate and --busSpeed must be positive");
+    }
+    if(config.minBatteryCapacity < 0.0 || config.minBatteryCapacity > config.maxBatteryCapacity){
+        errors.push_back("--minBatteryCapacity must be between 0 and --maxBatteryCapacity");
+    }
+    if(config.startingCapacity < config.minBatteryCapacity || config.startingCapacity > config.maxBatteryCapacity){
+        errors.push_back("--startingCapacity must be between --minBatteryCapacity and --maxBatteryCapacity");
+    }
+    if(config.minChargeTime < 0.0 || config.minChargeTime > config.maxChargeTime){
+        errors.push_back("--minChargeTime must be between 0 and --maxChargeTime");
+    }
+    if(config.deviationTime < 0.0){
+        errors.push_back("--deviationTime must not be negative");
+    }
+    if(config.horizonStartTime >= config.horizonEndTime){
+        errors.push_back("--horizonStartTime must be before --horizonEndTime");
+    }
+    if(config.bigM <= 0 || config.timeout < 0 || config.maxSolutions < 0 || config.threads < 0){
+        errors.push_back("--bigM must be positive and --timeout, --maxSolutions and --threads must not be negative");
+    }
+    return config;
+}
+
+RunConfig RunConfig::fromArguments(const map<string, string> &arguments){
+    vector<string> errors;
+    RunConfig config = fromArguments(arguments, errors);
+    if(!errors.empty()){
+        cout << "Invalid arguments:" << endl;
+        for(string &error: errors){
+            cout << "\t" << error << endl;
+        }
+        exit(-1);
+    }
+    return config;
+}
+
+vector<string> RunConfig::validate(const map<string, string> &arguments){
+    vector<string> errors;
+    fromArguments(arguments, errors);
+    return errors;
+}
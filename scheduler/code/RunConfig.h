@@ -0,0 +1,154 @@
+#ifndef SCHEDULER_RUN_CONFIG_H
+#define SCHEDULER_RUN_CONFIG_H
+#include "string"
+#include "map"
+#include "vector"
+
+using namespace std;
+
+/// the settings of a single run. The names are the same as the command line arguments, see WP5-D1 and WP5-D2 for the
+/// meaning of the model parameters
+struct RunConfig{
+    /// MPM or SPM
+    string method = "MPM";
+
+    /// R the charge rate (in kWh per hour)
+    double chargeRate = 0.0;
+
+    /// M the largest constant used by the time related constraints, each constraint uses the smallest M which the
+    /// bounds of its columns allow
+    int bigM = 25;
+
+    /// the energy used by a bus (in kWh per km) and its speed (in km/h)
+    double busEnergyCost = 0.0;
+    double busSpeed = 0.0;
+
+    /// C_max, C_min and the starting capacity (in kWh) of each bus
+    double maxBatteryCapacity = 0.0;
+    double minBatteryCapacity = 0.0;
+    double startingCapacity = 0.0;
+
+    /// \beta and \gamma the maximum and minimum charge time (in hour decimal)
+    double maxChargeTime = 0.0;
+    double minChargeTime = 0.0;
+
+    /// \delta t_bi the maximum deviation (in hour decimal) from the scheduled arrival time
+    double deviationTime = 0.0;
+
+    /// the start and end (\Omega) of the current horizon/checkpoint
+    double horizonStartTime = 0.0;
+    double horizonEndTime = 24.0;
+
+    /// \phi the discount factor used by SPM
+    double discountFactor = 0.0;
+
+    /// the share of the clean energy which is available to this location
+    double powerRatio = 1.0;
+
+    /// how the CEW are coarsened before the model is built (see CEWCoarsening): none keeps the CEW, merge solves the
+    /// model with the merged CEW, refine solves it again with the original CEW, starting from the schedule of the
+    /// merged CEW. cewTolerance is the share of the clean energy the merged CEW may add to a schedule
+    string cewCoarsening = "none";
+    double cewTolerance = 0.01;
+
+    /// recalculate the schedule, keeping the values of a previous solution before horizonStartTime
+    bool recalculate = false;
+
+    /// use the greedy heuristic as a MIP start
+    bool greedyStart = true;
+
+    /// only create columns for the stops at charging stations and the first and last stop of each bus, see
+    /// StopSegments
+    bool compressStops = true;
+
+    /// how the disjunctions (3.13/3.14, 3.16/3.17, 3.21/3.22, 2.1 and 2.3) are written: bigM rows or indicator rows
+    string formulation = "bigM";
+
+    /// how the horizon is solved: none solves the model of the whole fleet, lagrangian decomposes it into the
+    /// subproblems of the single buses (see LagrangianDecomposition), which are solved by the solver backend
+    string decomposition = "none";
+
+    /// the largest number of subgradient steps of the decomposition
+    int decompositionIterations = 100;
+
+    /// how the decomposition solves the subproblems: mip solves the model of each bus with the solver backend, dp
+    /// uses BusChargePlanner, which needs no solver
+    string subproblemSolver = "mip";
+
+    /// the grid of BusChargePlanner, the step of the arrival and charge times (in hour decimal) and of the capacity
+    /// (in kWh). The plans are the cheapest ones on the grid, a coarser grid is faster and its plans cost more
+    double dpTimeStep = 1.0 / 60.0;
+    double dpEnergyStep = 0.1;
+
+    /// the number of charging stations of the placement search (see PlacementSearch), which runs instead of the
+    /// schedule if it is given. The search takes placementIterations moves, evaluates placementCandidates moves for
+    /// each of them and writes the placementKeep best placements to placementSaveFile, in which {rank} is replaced by
+    /// the rank of the placement
+    int placementBudget = 0;
+    int placementIterations = 200;
+    int placementCandidates = 64;
+    int placementKeep = 5;
+    string placementSaveFile = "charging_stations_{rank}.txt";
+
+    /// the schedule simulation (see ScheduleSimulator) replays the CEW of the schedule, the CEW files of
+    /// --simulationCEWFiles and simulationScenarios perturbations of the CEW of the schedule, each window is multiplied
+    /// by 1 + scenarioNoise * z with a correlation of scenarioCorrelation between consecutive windows. The
+    /// distributions are written to simulationSaveFile_*.csv
+    int simulationScenarios = 10000;
+    double scenarioNoise = 0.2;
+    double scenarioCorrelation = 0.5;
+    string simulationSaveFile = "simulation";
+
+    /// the solver backend, the default backend of the build is used if it is empty
+    string backend;
+
+    /// the model is written to this file for debugging purposes, no file is written if it is empty
+    string modelFile = "model.mps";
+
+    /// search limits, 0 means no limit
+    int timeout = 0;
+    int maxSolutions = 0;
+    int threads = 0;
+
+    /// the human-readable report printed after each solve: full, summary leaves out the buses and the CEW, none
+    string report = "full";
+
+    /// the results of each solve are written to resultFile as JSON Lines (resultFormat jsonl) or csv files, summary
+    /// (resultDetail) only writes the totals. No file is written if it is empty, {horizon} is replaced by the start of
+    /// the horizon
+    string resultFile;
+    string resultFormat = "jsonl";
+    string resultDetail = "full";
+
+    /// the time of each phase, the size of the model, the allocations and the peak memory of a run are written to
+    /// metricsFile as JSON, no file is written if it is empty. perfCounters adds the hardware counters of the run
+    string metricsFile;
+    bool perfCounters = false;
+
+    /// the solver log, the warming solution, the solution written by the solver (LPFile), the file the schedule is
+    /// saved to and the file a previous schedule is loaded from
+    string logFile;
+    string warmingSolutionFile;
+    string solutionFile;
+    string solutionSaveFile;
+    string solutionDataFile;
+
+    /// the arguments which have no sensible default, including the input files of the location
+    static const vector<string> requiredArguments;
+
+    /// the arguments which have no sensible default when a schedule is only replayed (--simulate), which does not read
+    /// the files of the location
+    static const vector<string> simulationArguments;
+
+    /// parses the arguments, arguments which are not given keep their default value. Every problem with the arguments
+    /// is added to errors
+    static RunConfig fromArguments(const map<string, string> &arguments, vector<string> &errors);
+
+    /// as above, but prints the problems and exits if the arguments are not valid
+    static RunConfig fromArguments(const map<string, string> &arguments);
+
+    /// the problems with the arguments, empty if a run can be started with them
+    static vector<string> validate(const map<string, string> &arguments);
+};
+
+#endif //SCHEDULER_RUN_CONFIG_H
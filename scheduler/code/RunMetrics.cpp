@@ -0,0 +1,172 @@
+#include "RunMetrics.h"
+#include "cerrno"
+#include "cstring"
+#include "fstream"
+#include "iostream"
+#include <nlohmann/json.hpp>
+#include <sys/resource.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace std;
+using json = nlohmann::json;
+
+static thread_local RunMetrics *currentMetrics = nullptr;
+thread_local AllocationCount threadAllocationCount;
+bool allocationsCounted = false;
+
+RunMetrics::RunMetrics(bool perfCounters): startTime(chrono::steady_clock::now()),
+                                           startAllocations(threadAllocationCount.allocations),
+                                           startAllocatedBytes(threadAllocationCount.bytes){
+    if(!perfCounters){
+        return;
+    }
+#ifdef __linux__
+    /// the counters of the calling thread and the threads it starts from now on, without the kernel
+    vector<pair<string, pair<unsigned int, unsigned long>>> events = {
+            {"cycles", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES}},
+            {"instructions", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS}},
+            {"cacheReferences", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES}},
+            {"cacheMisses", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES}},
+            {"branchMisses", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}},
+            {"pageFaults", {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS}}
+    };
+    for(auto &[name, event]: events){
+        perf_event_attr attributes;
+        memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = event.first;
+        attributes.config = event.second;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.inherit = 1;
+        int descriptor = syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+        if(descriptor < 0){
+            if(perfError.empty()){
+                perfError = "perf_event_open " + name + ": " + strerror(errno);
+            }
+            continue;
+        }
+        perfEvents.push_back({name, descriptor});
+    }
+#else
+    perfError = "perf_event is only available on Linux";
+#endif
+}
+
+RunMetrics::~RunMetrics(){
+    for(auto &event: perfEvents){
+        close(event.second);
+    }
+}
+
+RunMetrics *RunMetrics::current(){
+    return currentMetrics;
+}
+
+void RunMetrics::count(const string &name, double value){
+    if(currentMetrics != nullptr){
+        currentMetrics->setCounter(name, value);
+    }
+}
+
+void RunMetrics::addPhase(const string &name, double milliseconds){
+    for(auto &phase: phaseTimes){
+        if(phase.name == name){
+            phase.milliseconds += milliseconds;
+            phase.calls++;
+            return;
+        }
+    }
+    phaseTimes.push_back({name, milliseconds, 1});
+}
+
+void RunMetrics::setCounter(const string &name, double value){
+    for(auto &counter: counters){
+        if(counter.first == name){
+            counter.second = value;
+            return;
+        }
+    }
+    counters.push_back({name, value});
+}
+
+const vector<PhaseTime> &RunMetrics::phases() const{
+    return phaseTimes;
+}
+
+long RunMetrics::allocations() const{
+    return threadAllocationCount.allocations - startAllocations;
+}
+
+void RunMetrics::write(string metricsFile) const{
+    json metrics;
+    metrics["totalMilliseconds"] = chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count();
+    metrics["phases"] = json::array();
+    for(auto &phase: phaseTimes){
+        metrics["phases"].push_back({{"name", phase.name}, {"milliseconds", phase.milliseconds},
+                                     {"calls", phase.calls}});
+    }
+    metrics["counters"] = json::object();
+    for(auto &counter: counters){
+        metrics["counters"][counter.first] = counter.second;
+    }
+    if(allocationsCounted){
+        metrics["allocations"] = allocations();
+        metrics["allocatedBytes"] = threadAllocationCount.bytes - startAllocatedBytes;
+    }
+
+    /// ru_maxrss is in kB on Linux, the peak of the whole process
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    metrics["peakRSSKilobytes"] = usage.ru_maxrss;
+
+    if(!perfEvents.empty() || !perfError.empty()){
+        metrics["perf"] = json::object();
+        for(auto &[name, descriptor]: perfEvents){
+            unsigned long long value = 0;
+            if(read(descriptor, &value, sizeof(value)) == sizeof(value)){
+                metrics["perf"][name] = value;
+            }
+        }
+        if(!perfError.empty()){
+            metrics["perf"]["error"] = perfError;
+        }
+    }
+
+    ofstream file(metricsFile);
+    if(!file){
+        cout << "Can not write the metrics file " << metricsFile << endl;
+        return;
+    }
+    file << metrics.dump(2) << endl;
+}
+
+MetricsScope::MetricsScope(RunMetrics &metrics): previous(currentMetrics){
+    currentMetrics = &metrics;
+}
+
+MetricsScope::~MetricsScope(){
+    currentMetrics = previous;
+}
+
+PhaseTimer::PhaseTimer(const char *phase): phase(phase), metrics(currentMetrics),
+                                            startTime(chrono::steady_clock::now()){}
+
+PhaseTimer::~PhaseTimer(){
+    if(!stopped){
+        stop();
+    }
+}
+
+double PhaseTimer::stop(){
+    double milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count();
+    if(metrics != nullptr && !stopped){
+        metrics->addPhase(phase, milliseconds);
+    }
+    stopped = true;
+    return milliseconds / 1000.0;
+}
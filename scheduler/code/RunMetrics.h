@@ -0,0 +1,92 @@
+#ifndef SCHEDULER_RUN_METRICS_H
+#define SCHEDULER_RUN_METRICS_H
+#include "chrono"
+#include "string"
+#include "vector"
+
+using namespace std;
+
+/// the allocations made with new by a thread. They are only counted in executables linked with AllocationCounter.cpp,
+/// which sets allocationsCounted: scheduler_benchmark, and the scheduler when built with COUNT_ALLOCATIONS
+struct AllocationCount{
+    long allocations = 0;
+    long bytes = 0;
+};
+extern thread_local AllocationCount threadAllocationCount;
+extern bool allocationsCounted;
+
+/// the time spent in a phase of a run, calls counts how often the phase was entered
+struct PhaseTime{
+    string name;
+    double milliseconds = 0.0;
+    int calls = 0;
+};
+
+/// Collects where the time of a run goes: the time of each phase, counters such as the size of the model, the
+/// allocations of the thread of the run, the peak memory of the process and, with perfCounters on Linux, the hardware
+/// counters of the thread of the run and the threads it starts. The metrics are collected by the thread which made
+/// them current with a MetricsScope, the PhaseTimer and count calls of a thread without current metrics do nothing,
+/// so the code can be instrumented without passing the metrics around. The runs of a sweep each have their own.
+class RunMetrics{
+public:
+    explicit RunMetrics(bool perfCounters = false);
+    ~RunMetrics();
+    RunMetrics(const RunMetrics &) = delete;
+    RunMetrics &operator=(const RunMetrics &) = delete;
+
+    /// the metrics of the calling thread, nullptr if it has none
+    static RunMetrics *current();
+
+    /// set counter name of the current metrics of the calling thread to value
+    static void count(const string &name, double value);
+
+    void addPhase(const string &name, double milliseconds);
+    void setCounter(const string &name, double value);
+    const vector<PhaseTime> &phases() const;
+
+    /// the allocations of the thread of the run so far, 0 if they are not counted
+    long allocations() const;
+
+    /// writes the metrics collected up to now as JSON
+    void write(string metricsFile) const;
+
+private:
+    chrono::steady_clock::time_point startTime;
+    vector<PhaseTime> phaseTimes;
+    vector<pair<string, double>> counters;
+    long startAllocations;
+    long startAllocatedBytes;
+
+    /// the file descriptors of the perf events and the reason the first missing one is not counted
+    vector<pair<string, int>> perfEvents;
+    string perfError;
+};
+
+/// makes metrics the current metrics of the calling thread while the scope lives
+class MetricsScope{
+public:
+    explicit MetricsScope(RunMetrics &metrics);
+    ~MetricsScope();
+
+private:
+    RunMetrics *previous;
+};
+
+/// adds the time from its construction to its destruction to the phase of the current metrics of the thread
+class PhaseTimer{
+public:
+    explicit PhaseTimer(const char *phase);
+    ~PhaseTimer();
+
+    /// ends the phase before the end of the scope and returns its time in seconds, also without current metrics, so
+    /// the times reported by the run are the ones of its metrics
+    double stop();
+
+private:
+    const char *phase;
+    RunMetrics *metrics;
+    chrono::steady_clock::time_point startTime;
+    bool stopped = false;
+};
+
+#endif //SCHEDULER_RUN_METRICS_H
@@ -0,0 +1,202 @@
+#include "ScheduleSimulator.h"
+#include "algorithm"
+#include "cmath"
+#include "random"
+
+using namespace std;
+
+/// the number of scenarios replayed together, the remaining energy of every window of a block fits in the cache
+static const int SCENARIO_BLOCK = 256;
+
+void ScenarioBatch::add(string name, const vector<CleanEnergyWindow> &scenarioWindows){
+    vector<int> indices;
+    for(auto &window: scenarioWindows){
+        indices.push_back(windowIndex(window));
+    }
+    for(auto &energy: windowEnergy){
+        energy.push_back(0.0);
+    }
+    for(int w = 0; w < scenarioWindows.size(); w++){
+        windowEnergy[indices[w]].back() += scenarioWindows[w].availableEnergy;
+    }
+    scenarioNames.push_back(name);
+}
+
+void ScenarioBatch::addPerturbed(const vector<CleanEnergyWindow> &base, int count, double noise, double correlation,
+                                 unsigned int seed){
+    vector<int> indices;
+    for(auto &window: base){
+        indices.push_back(windowIndex(window));
+    }
+    for(auto &energy: windowEnergy){
+        energy.reserve(energy.size() + count);
+    }
+    mt19937 generator(seed);
+    normal_distribution<double> normal(0.0, 1.0);
+    double innovation = sqrt(max(0.0, 1.0 - correlation * correlation));
+    for(int scenario = 0; scenario < count; scenario++){
+        for(auto &energy: windowEnergy){
+            energy.push_back(0.0);
+        }
+        double z = normal(generator);
+        for(int w = 0; w < base.size(); w++){
+            if(w > 0){
+                z = correlation * z + innovation * normal(generator);
+            }
+            windowEnergy[indices[w]].back() += base[w].availableEnergy * max(0.0, 1.0 + noise * z);
+        }
+        scenarioNames.push_back("perturbed " + to_string(scenario + 1));
+    }
+}
+
+/// the index of the window with the times of window, a window which is not in the batch yet is added without energy
+/// in the scenarios of the batch
+int ScenarioBatch::windowIndex(const CleanEnergyWindow &window){
+    for(int k = 0; k < windows.size(); k++){
+        if(windows[k].startTime == window.startTime && windows[k].endTime == window.endTime){
+            return k;
+        }
+    }
+    windows.push_back({window.startTime, window.endTime, 0.0});
+    windowEnergy.push_back(vector<double>(scenarioNames.size(), 0.0));
+    return windows.size() - 1;
+}
+
+int ScenarioBatch::numberScenarios() const{
+    return scenarioNames.size();
+}
+
+int ScenarioBatch::numberWindows() const{
+    return windows.size();
+}
+
+const CleanEnergyWindow &ScenarioBatch::window(int k) const{
+    return windows[k];
+}
+
+const double *ScenarioBatch::energy(int k) const{
+    return windowEnergy[k].data();
+}
+
+const vector<string> &ScenarioBatch::names() const{
+    return scenarioNames;
+}
+
+ScheduleSimulator::ScheduleSimulator(const primitiveVariables &schedule, const RunConfig &config,
+                                     const vector<double> &horizons): buses(schedule.buses), horizons(horizons){
+    chargeRate = config.chargeRate;
+    bool spm = config.method == "SPM";
+    for(int n = 0; n < schedule.buses.size(); n++){
+        for(int i = schedule.stopStart[n]; i < schedule.stopStart[n + 1]; i++){
+            if(schedule.chargeTime[i] <= 0.0 || schedule.chargeAmount[i] <= 0.0){
+                continue;
+            }
+            double arrival = schedule.arrivalTime[i];
+            int horizon = upper_bound(horizons.begin(), horizons.end(), arrival) - horizons.begin() - 1;
+            if(horizon >= (int) horizons.size() - 1){
+                horizon = -1;
+            }
+            double discount = spm && arrival >= config.horizonEndTime ? config.discountFactor : 0.0;
+            charges.push_back({n, horizon, arrival, arrival + schedule.chargeTime[i], schedule.chargeAmount[i],
+                               discount * schedule.chargeAmount[i]});
+        }
+    }
+    stable_sort(charges.begin(), charges.end(), [](const Charge &a, const Charge &b){
+        return a.start < b.start;
+    });
+}
+
+SimulationResult ScheduleSimulator::run(const ScenarioBatch &scenarios) const{
+    int numberScenarios = scenarios.numberScenarios();
+    int numberWindows = scenarios.numberWindows();
+    int numberHorizons = max(0, (int) horizons.size() - 1);
+    SimulationResult result;
+    result.buses = buses;
+    result.horizons = horizons;
+    result.scenarioNames = scenarios.names();
+    for(int k = 0; k < numberWindows; k++){
+        result.windows.push_back(scenarios.window(k));
+    }
+    result.busClean = vector<vector<double>>(buses.size(), vector<double>(numberScenarios, 0.0));
+    result.busNonRenewable = vector<vector<double>>(buses.size(), vector<double>(numberScenarios, 0.0));
+    result.windowClean = vector<vector<double>>(numberWindows, vector<double>(numberScenarios, 0.0));
+    result.horizonClean = vector<vector<double>>(numberHorizons, vector<double>(numberScenarios, 0.0));
+    result.horizonNonRenewable = vector<vector<double>>(numberHorizons, vector<double>(numberScenarios, 0.0));
+    result.totalClean = vector<double>(numberScenarios, 0.0);
+    result.totalNonRenewable = vector<double>(numberScenarios, 0.0);
+
+    /// the windows each charge overlaps and the most clean energy it can take from each of them
+    vector<int> overlapStart{0};
+    vector<int> overlapWindow;
+    vector<double> overlapEnergy;
+    for(auto &charge: charges){
+        for(int k = 0; k < numberWindows; k++){
+            const CleanEnergyWindow &window = scenarios.window(k);
+            double overlap = min(charge.end, window.endTime) - max(charge.start, window.startTime);
+            if(overlap > 0.0){
+                overlapWindow.push_back(k);
+                overlapEnergy.push_back(chargeRate * overlap);
+            }
+        }
+        overlapStart.push_back(overlapWindow.size());
+    }
+
+    vector<double> windowLeft(numberWindows * SCENARIO_BLOCK);
+    vector<double> chargeLeft(SCENARIO_BLOCK);
+    for(int first = 0; first < numberScenarios; first += SCENARIO_BLOCK){
+        int lanes = min(SCENARIO_BLOCK, numberScenarios - first);
+        for(int k = 0; k < numberWindows; k++){
+            copy(scenarios.energy(k) + first, scenarios.energy(k) + first + lanes,
+                 windowLeft.begin() + k * SCENARIO_BLOCK);
+        }
+        for(int c = 0; c < charges.size(); c++){
+            const Charge &charge = charges[c];
+            double amount = charge.amount;
+            double *left = chargeLeft.data();
+            fill(left, left + lanes, amount);
+            for(int o = overlapStart[c]; o < overlapStart[c + 1]; o++){
+                double limit = overlapEnergy[o];
+                double *remaining = windowLeft.data() + overlapWindow[o] * SCENARIO_BLOCK;
+                double *used = result.windowClean[overlapWindow[o]].data() + first;
+#pragma omp simd
+                for(int s = 0; s < lanes; s++){
+                    double energy = min(limit, min(remaining[s], left[s]));
+                    remaining[s] -= energy;
+                    left[s] -= energy;
+                    used[s] += energy;
+                }
+            }
+
+            double discount = charge.discount;
+            double *busClean = result.busClean[charge.bus].data() + first;
+            double *busNonRenewable = result.busNonRenewable[charge.bus].data() + first;
+#pragma omp simd
+            for(int s = 0; s < lanes; s++){
+                busClean[s] += amount - left[s];
+                busNonRenewable[s] += max(0.0, left[s] - discount);
+            }
+            if(charge.horizon >= 0){
+                double *horizonClean = result.horizonClean[charge.horizon].data() + first;
+                double *horizonNonRenewable = result.horizonNonRenewable[charge.horizon].data() + first;
+#pragma omp simd
+                for(int s = 0; s < lanes; s++){
+                    horizonClean[s] += amount - left[s];
+                    horizonNonRenewable[s] += max(0.0, left[s] - discount);
+                }
+            }
+        }
+    }
+
+    for(int n = 0; n < buses.size(); n++){
+        const double *busClean = result.busClean[n].data();
+        const double *busNonRenewable = result.busNonRenewable[n].data();
+        double *totalClean = result.totalClean.data();
+        double *totalNonRenewable = result.totalNonRenewable.data();
+#pragma omp simd
+        for(int s = 0; s < numberScenarios; s++){
+            totalClean[s] += busClean[s];
+            totalNonRenewable[s] += busNonRenewable[s];
+        }
+    }
+    return result;
+}
@@ -0,0 +1,85 @@
+#ifndef SCHEDULER_SCHEDULE_SIMULATOR_H
+#define SCHEDULER_SCHEDULE_SIMULATOR_H
+#include "string"
+#include "vector"
+#include "DataStructures.h"
+#include "RunConfig.h"
+
+using namespace std;
+
+/// CEW scenarios over the same windows, stored as a structure of arrays: the energy of a window in every scenario is
+/// one contiguous array, so a schedule can be replayed against all scenarios with the same instructions
+class ScenarioBatch{
+public:
+    /// the windows of the batch are the windows of the added scenarios, a window a scenario does not have has no
+    /// energy in that scenario
+    void add(string name, const vector<CleanEnergyWindow> &windows);
+
+    /// count scenarios of the windows of base with the energy of each window multiplied by 1 + noise * z, or 0 if
+    /// that is negative. z is a standard normal with the given correlation between consecutive windows
+    void addPerturbed(const vector<CleanEnergyWindow> &base, int count, double noise, double correlation,
+                      unsigned int seed);
+
+    int numberScenarios() const;
+    int numberWindows() const;
+    const CleanEnergyWindow &window(int k) const;
+
+    /// the energy of window k in each scenario, numberScenarios values
+    const double *energy(int k) const;
+    const vector<string> &names() const;
+
+private:
+    int windowIndex(const CleanEnergyWindow &window);
+
+    vector<string> scenarioNames;
+    vector<CleanEnergyWindow> windows;
+    vector<vector<double>> windowEnergy;
+};
+
+/// the clean and non-clean energy of a replayed schedule for the keys of the buses, the windows of the scenarios and
+/// the horizons, each vector of values holds one value for each scenario
+struct SimulationResult{
+    vector<int> buses;
+    vector<CleanEnergyWindow> windows;
+    vector<double> horizons;
+    vector<string> scenarioNames;
+    vector<vector<double>> busClean;
+    vector<vector<double>> busNonRenewable;
+    vector<vector<double>> windowClean;
+    vector<vector<double>> horizonClean;
+    vector<vector<double>> horizonNonRenewable;
+    vector<double> totalClean;
+    vector<double> totalNonRenewable;
+};
+
+/// Replays the charges of a schedule against a batch of CEW scenarios. The arrival, charge time and charge amount of
+/// each stop are kept, only the clean energy the charges get changes. The charges are served in the order of their
+/// arrival and take the clean energy of the windows they overlap (constraints 3.18-3.23), up to the charge rate for
+/// the overlap and the energy left in the window, the rest of the charge is non-clean energy, less the discount of
+/// SPM after the end of the horizon (2.4). The scenarios are replayed in blocks, the loops over the scenarios of a
+/// block are vectorized.
+class ScheduleSimulator{
+public:
+    /// horizons holds the start of each horizon and the end of the last one, every charge is in the horizon it
+    /// arrives in
+    ScheduleSimulator(const primitiveVariables &schedule, const RunConfig &config, const vector<double> &horizons);
+    SimulationResult run(const ScenarioBatch &scenarios) const;
+
+private:
+    /// a stop of the schedule which charges
+    struct Charge{
+        int bus;
+        int horizon;
+        double start;
+        double end;
+        double amount;
+        double discount;
+    };
+
+    vector<Charge> charges;
+    vector<int> buses;
+    vector<double> horizons;
+    double chargeRate;
+};
+
+#endif //SCHEDULER_SCHEDULE_SIMULATOR_H
@@ -0,0 +1,971 @@
+#include "SchedulingProblem.h"
+#include "cmath"
+#include "algorithm"
+#include "ConflictIndex.h"
+#include "WindowIndex.h"
+#include "RunMetrics.h"
+
+using namespace std;
+
+/// the M of a disjunction whose inactive side has to allow a violation of up to required, which follows from the
+/// bounds of the columns. --bigM is kept as the largest M
+static double disjunctionM(const RunConfig &config, double required){
+    return min((double) config.bigM, max(0.0, required));
+}
+
+/// add the row terms <= rhs ('L') or terms >= rhs ('G') which only has to hold while the binary column indicator has
+/// the value active. The bigM formulation relaxes the row by the M of required for the other value of the indicator,
+/// the indicator formulation leaves that to the solver
+static int addDisjunction(ModelIR &model, const RunConfig &config, int indicator, int active, vector<Term> terms,
+                          char sense, double rhs, double required){
+    if(config.formulation == "indicator"){
+        return model.addIndicatorRow(indicator, active, terms, sense, rhs);
+    }
+    double relaxation = sense == 'G' ? disjunctionM(config, required) : -disjunctionM(config, required);
+    if(active == 1){
+        terms.push_back({indicator, -relaxation});
+        rhs -= relaxation;
+    }
+    else{
+        terms.push_back({indicator, relaxation});
+    }
+    return model.addRow(terms, sense, rhs);
+}
+
+/// The parts of the model which differ between the methods are taken from a policy. The policy is selected once when
+/// the model is built, so the per-stop loops are compiled for each method and never compare the method.
+/// MPM (WP5-D1) has no discounts
+struct MPMConstraints{
+    /// the columns of a stop which are only used by this method, stay NO_COLUMN otherwise
+    static void addStopColumns(ModelIR &model, const RunConfig &config, const string &varString, int &ase,
+                               int &discount){}
+
+    /// the rows of stop s which are only used by this method
+    static void addStopRows(ModelIR &model, ModelColumns &columns, const RunConfig &config, int s){}
+
+    /// the rows which bound the non-clean energy of a stop (3.25/3.26) do not count a discount
+    static void addDiscountTerm(vector<Term> &row, int discount){}
+};
+
+/// SPM (WP5-D2) discounts the energy charged after the end of the current horizon
+struct SPMConstraints{
+    /// create variable for ase_bi and r_bi
+    static void addStopColumns(ModelIR &model, const RunConfig &config, const string &varString, int &ase,
+                               int &discount){
+        ase = model.addColumn(0, 1, INTEGER, varString + "ase");
+        discount = model.addColumn(0, config.maxChargeTime * config.chargeRate, CONTINUOUS, varString + "Discount");
+    }
+
+    /// the rows which depend on the end of the horizon are kept so the horizon can be moved
+    static void addStopRows(ModelIR &model, ModelColumns &columns, const RunConfig &config, int s){
+        const StopSegments &segments = columns.segments;
+        int actualArrival = columns.actualArrival[s];
+        int chargeAmount = columns.chargeAmount[s];
+        int discount = columns.discounts[s];
+        int ase = columns.ases[s];
+
+        /// Constraint 2.1 WP5-D2, the row is only needed while \Omega lies within the bounds of t_bi, see setHorizonEnd
+        columns.horizonEndRows[s] = addDisjunction(model, config, ase, 0, {{actualArrival, 1.0}}, 'G',
+                                                   columns.horizonEndTime,
+                                                   segments.arrivalUpper[s] - segments.arrivalLower[s]);
+
+        /// Constraint 2.2 WP5-D2
+        model.addRow({{discount, 1.0}, {chargeAmount, -config.discountFactor}}, 'L', 0.0);
+
+        /// Constraint 2.3 WP5-D2, r_bi can not exceed the discount of the longest charge
+        addDisjunction(model, config, ase, 1, {{discount, 1.0}}, 'L', 0.0,
+                       config.discountFactor * segments.chargeLimit[s] * config.chargeRate);
+    }
+
+    /// Constraint 2.4 WP5-D2, the discount counts towards the non-clean energy
+    static void addDiscountTerm(vector<Term> &row, int discount){
+        row.push_back({discount, 1.0});
+    }
+};
+
+SchedulingProblem::SchedulingProblem(const ModelParameters &parameters, const RunConfig &config, ostream &out):
+        parameters(parameters), config(config), out(out){
+    this->parameters.setLegs(config.busEnergyCost, config.busSpeed);
+}
+
+void SchedulingProblem::build(primitiveVariables *previousSchedule){
+    if(config.method == "SPM"){
+        buildModel<SPMConstraints>();
+    }
+    else{
+        buildModel<MPMConstraints>();
+    }
+
+    /// if we want to recalculate the schedule for the current day then we must assign the values of variables which
+    /// occur before the current checkpoint start
+    ModelChanges changes;
+    if(config.recalculate && previousSchedule != nullptr){
+        setPreviousValues(*previousSchedule, config.horizonStartTime, changes);
+    }
+    setHorizonEnd(changes);
+
+    out << "Number of constraints: " << model.numberRows() << endl;
+    RunMetrics::count("columns", model.numberColumns());
+    RunMetrics::count("integerColumns", count(model.columnType.begin(), model.columnType.end(), INTEGER));
+    RunMetrics::count("rows", model.numberRows());
+    RunMetrics::count("nonzeros", model.numberNonzeros());
+    RunMetrics::count("stops", parameters.totalStops());
+    RunMetrics::count("cleanEnergyWindows", columns.powerExcess.size());
+}
+
+template <class Method>
+void SchedulingProblem::buildModel(){
+    /// create the variables used in the MIP model, the objective minimizes the total amount of non-clean energy consumed.
+    {
+        PhaseTimer timer("build.variables");
+        createVariables<Method>();
+    }
+
+    /// create the constraints used in the MIP model
+    PhaseTimer timer("build.constraints");
+    addConstraints<Method>();
+}
+
+const vector<CleanEnergyWindow> &SchedulingProblem::cleanEnergyWindows() const{
+    return columns.powerExcess;
+}
+
+/// create the variables used for the MIP model constraints
+template <class Method>
+void SchedulingProblem::createVariables(){
+
+    double deviationTime = config.deviationTime;
+    double maxChargeTime = config.maxChargeTime;
+    double chargeRate = config.chargeRate;
+    double maxBatteryCapacity = config.maxBatteryCapacity;
+    double minBatteryCapacity = config.minBatteryCapacity;
+    int numberStops = parameters.totalStops();
+
+    columns.horizonEndTime = config.horizonEndTime;
+    columns.buses = parameters.busKeys;
+    columns.stopStart = parameters.stopStart;
+    columns.chargingStation = vector<int>(parameters.numberStations);
+
+    /// assign values of X_i
+    for(int i=0;i<parameters.chargingStops.size();i++){
+        columns.chargingStation[i] = parameters.chargingStops[i];
+    }
+
+    setCleanEnergyWindows(parameters.cleanEnergyWindows);
+
+    /// only the stops where something can be decided get columns
+    columns.segments.build(parameters, columns.chargingStation, deviationTime, maxChargeTime, config.compressStops);
+
+    columns.actualArrival = vector<int>(numberStops, NO_COLUMN);
+    columns.deviationTime = vector<int>(numberStops, NO_COLUMN);
+    columns.batteryCapacity = vector<int>(numberStops, NO_COLUMN);
+    columns.chargeTime = vector<int>(numberStops, NO_COLUMN);
+    columns.charge = vector<int>(numberStops, NO_COLUMN);
+    columns.chargeAmount = vector<int>(numberStops, NO_COLUMN);
+    columns.nonRenewable = vector<int>(numberStops, NO_COLUMN);
+    columns.ases = vector<int>(numberStops, NO_COLUMN);
+    columns.discounts = vector<int>(numberStops, NO_COLUMN);
+    columns.horizonEndRows = vector<int>(numberStops, NO_ROW);
+
+    /// create variables associated with each bus
+    for(int n = 0; n < parameters.numberBuses(); n++){
+        int b = parameters.busKeys[n];
+        for(int i=0; i<parameters.numberStops(n); i++){
+            int s = parameters.stopStart[n] + i;
+            if(!columns.segments.isKept(s)){
+                continue;
+            }
+            string varString = "Bus" + to_string(b) + "SequenceStop" + to_string(i);
+
+            /// create the variable for t_bi, bounded by the deviation of the stops of the bus and the legs between them
+            columns.actualArrival[s] = model.addColumn(columns.segments.arrivalLower[s],
+                                                       columns.segments.arrivalUpper[s], CONTINUOUS,
+                                                       varString + "ArrivalTime");
+
+            /// create the variable for \delta t_bi
+            columns.deviationTime[s] = model.addColumn(0.0, deviationTime, CONTINUOUS, varString + "DeltaTime");
+
+            /// create the variable for c_bi
+            columns.batteryCapacity[s] = model.addColumn(minBatteryCapacity, maxBatteryCapacity, CONTINUOUS,
+                                                         varString + "BatteryCapacity");
+            /// create the variable for ct_bi
+            columns.chargeTime[s] = model.addColumn(0.0, maxChargeTime, CONTINUOUS, varString + "ChargeTime");
+
+            /// create the variable for x_bi
+            columns.charge[s] = model.addColumn(0, 1, INTEGER, varString + "Charge");
+
+            /// create the variable for e_bi
+            columns.chargeAmount[s] = model.addColumn(0.0, maxChargeTime * chargeRate, CONTINUOUS,
+                                                      varString + "chargeAmount");
+
+            /// create variable for nc_bi, the objective minimizes the total amount of non-clean energy consumed.
+            columns.nonRenewable[s] = model.addColumn(0.0, maxChargeTime * chargeRate, CONTINUOUS,
+                                                      varString + "nonRenewable", 1.0);
+
+            /// create variable for ase_bi and r_bi, these are only used by SPM
+            Method::addStopColumns(model, config, varString, columns.ases[s], columns.discounts[s]);
+        }
+    }
+    /// assign D_ij, the distance between two stops multiplied by the energy consumption per km
+    columns.tripCost = TripCost{parameters.distances, config.busEnergyCost};
+
+    /// assign T_ij, the distance / (time * speed) formula using the distance between ij and the bus speed.
+    columns.tripTime = TripTime{parameters.distances, config.busSpeed};
+
+    createCEWVariables();
+}
+
+/// not all CEW have to be considered, ones that occur before the first bus are removed.
+vector<CleanEnergyWindow> SchedulingProblem::usedWindows(const ModelParameters &parameters,
+                                                         const vector<CleanEnergyWindow> &windows){
+    vector<CleanEnergyWindow> used;
+    for(auto& window: windows){
+        bool beforeFirstBus = true;
+        for(int n = 0; n < parameters.numberBuses(); n++){
+            if(window.endTime>parameters.scheduledTimes[parameters.stopStart[n]]){
+                beforeFirstBus=false;
+            }
+        }
+        if(!beforeFirstBus){
+            used.push_back(window);
+        }
+    }
+    return used;
+}
+
+void SchedulingProblem::setCleanEnergyWindows(const vector<CleanEnergyWindow> &windows){
+    columns.powerExcess = usedWindows(parameters, windows);
+}
+
+/// the CEW which replace earlier ones get their own column names
+string SchedulingProblem::cewSuffix() const{
+    return columns.cewGeneration == 0 ? "" : "Checkpoint" + to_string(columns.cewGeneration);
+}
+
+/// the entry of CEW k at stop s, -1 if stop s can not reach it
+int SchedulingProblem::windowEntry(int s, int k) const{
+    for(int e = columns.windowStart[s]; e < columns.windowStart[s + 1]; e++){
+        if(columns.entryWindow[e] == k){
+            return e;
+        }
+    }
+    return -1;
+}
+
+/// create the variables of the individual CEW's (wt_bik, kt_bik and ce_kbi). They are only created for the CEW a stop
+/// at a charging station can reach, all others would be fixed to 0 by the model
+void SchedulingProblem::createCEWVariables(){
+    double maxChargeTime = config.maxChargeTime;
+    double chargeRate = config.chargeRate;
+    int firstColumn = model.numberColumns();
+    string suffix = cewSuffix();
+    int numberWindows = columns.powerExcess.size();
+
+    WindowIndex windowIndex;
+    windowIndex.build(columns.powerExcess, config.deviationTime, maxChargeTime);
+    vector<int> reachable;
+    columns.windowStart = vector<int>{0};
+    columns.entryWindow.clear();
+    for(int s = 0; s < parameters.totalStops(); s++){
+        if(columns.chargingStation[parameters.stations[s]] == 1){
+            windowIndex.reachableWindows(parameters.scheduledTimes[s], reachable);
+            columns.entryWindow.insert(columns.entryWindow.end(), reachable.begin(), reachable.end());
+        }
+        columns.windowStart.push_back(columns.entryWindow.size());
+    }
+    int numberEntries = columns.entryWindow.size();
+    columns.cleanChargeTime = vector<int>(numberEntries);
+    columns.cleanWindowCharge = vector<int>(numberEntries);
+    columns.windowEnergyUsed = vector<int>(numberEntries);
+
+    for(int n = 0; n < parameters.numberBuses(); n++){
+        int b = parameters.busKeys[n];
+        for(int i=0; i<parameters.numberStops(n); i++){
+            int s = parameters.stopStart[n] + i;
+            string varString = "Bus" + to_string(b) + "SequenceStop" + to_string(i);
+            for(int e = columns.windowStart[s]; e < columns.windowStart[s + 1]; e++){
+                int k = columns.entryWindow[e];
+                /// create variable for wt_bik
+                columns.cleanChargeTime[e] = model.addColumn(0.0, maxChargeTime, CONTINUOUS,
+                                                             varString + "CleanEnergyTime" + to_string(k) + suffix);
+
+                /// create variable for kt_bik
+                columns.cleanWindowCharge[e] =
+                        model.addColumn(0, 1, INTEGER, varString + "CleanEnergyCharge" + to_string(k) + suffix);
+
+                /// assign the variable to determine how much energy was used for each CEW.
+                columns.windowEnergyUsed[e] =
+                        model.addColumn(0.0, maxChargeTime * chargeRate, CONTINUOUS,
+                                        "window"+to_string(columns.powerExcess[k].startTime)+
+                                        "to"+to_string(columns.powerExcess[k].endTime)+"bus"+
+                                        to_string(b)+"stop"+to_string(i)+suffix);
+            }
+        }
+    }
+    out << "Clean Energy Windows: [";
+    for(int k=0;k<numberWindows;k++){
+        out << (k == 0 ? "" : ", ") << "[" << columns.powerExcess[k].startTime << ", "
+             << columns.powerExcess[k].endTime << ", " << columns.powerExcess[k].availableEnergy << "]";
+    }
+    out << "]" << endl;
+    for(int c = firstColumn; c < model.numberColumns(); c++){
+        columns.cewColumns.push_back(c);
+    }
+}
+
+/// create the constraints for the CEW's of stop s, only the CEW the stop can reach have columns
+template <class Method>
+void SchedulingProblem::addStopCEWConstraints(int s){
+
+    double chargeRate = config.chargeRate;
+    double arrivalLower = columns.segments.arrivalLower[s];
+    double arrivalUpper = columns.segments.arrivalUpper[s];
+    double departureUpper = columns.segments.departureUpper[s];
+
+    int actualArrival = columns.actualArrival[s];
+    int chargeTime = columns.chargeTime[s];
+    int chargeAmount = columns.chargeAmount[s];
+    int nonRenewable = columns.nonRenewable[s];
+    int discount = columns.discounts[s];
+    int firstEntry = columns.windowStart[s];
+    int endEntry = columns.windowStart[s + 1];
+
+    if (firstEntry < endEntry) {
+        vector<Term> windowTimeValues;
+        /// the row of constraint 3.21 holds wt_bik of the CEW up to the current one, it grows by one term for every CEW
+        vector<Term> windowEndRow;
+        for (int e = firstEntry; e < endEntry; e++) {
+            int windowEnergy = columns.windowEnergyUsed[e];
+            int cleanChargeTime = columns.cleanChargeTime[e];
+            int cleanWindowCharge = columns.cleanWindowCharge[e];
+            double windowStart = columns.powerExcess[columns.entryWindow[e]].startTime;
+            double windowEnd = columns.powerExcess[columns.entryWindow[e]].endTime;
+
+            /// the bus can not charge during a CEW which ends before its earliest arrival or starts after its latest
+            /// departure
+            if(windowEnd < arrivalLower || windowStart > departureUpper){
+                model.columnUpper[cleanWindowCharge] = 0.0;
+            }
+
+            /// Constraint 3.16 WP5-D1
+            addDisjunction(model, config, cleanWindowCharge, 1, {{actualArrival, 1.0}, {chargeTime, 1.0}}, 'G',
+                           windowStart, windowStart - arrivalLower);
+
+            /// Constraint 3.17 WP5-D1
+            addDisjunction(model, config, cleanWindowCharge, 1, {{actualArrival, 1.0}}, 'L', windowEnd,
+                           arrivalUpper - windowEnd);
+
+            /// Constraint 3.18 WP5-D1
+            model.addRow({{cleanWindowCharge, 1.0}, {cleanChargeTime, -1.0}}, 'G', 0.0);
+
+            /// Constraint 3.19 WP5-D1
+            model.addRow({{cleanWindowCharge, chargeRate}, {windowEnergy, -1.0}}, 'G', 0.0);
+
+            /// Constraint 3.20 WP5-D1
+            model.addRow({{columns.charge[s], 1.0}, {cleanWindowCharge, -1.0}}, 'G', 0.0);
+
+            /// Constraint 3.21 WP5-D1
+            windowEndRow.push_back({cleanChargeTime, 1.0});
+            vector<Term> windowEndTerms = windowEndRow;
+            windowEndTerms.push_back({actualArrival, 1.0});
+            addDisjunction(model, config, cleanWindowCharge, 1, windowEndTerms, 'L', windowEnd,
+                           departureUpper - windowEnd);
+
+            /// Constraint 3.22 WP5-D1
+            addDisjunction(model, config, cleanWindowCharge, 1,
+                           {{actualArrival, 1.0}, {chargeTime, 1.0}, {cleanChargeTime, -1.0}}, 'G', windowStart,
+                           windowStart - arrivalLower);
+
+            /// Constraint 3.23 WP5-D1
+            model.addRow({{windowEnergy, 1.0}, {cleanChargeTime, -chargeRate}}, 'L', 0.0);
+
+            windowTimeValues.push_back({windowEnergy, 1.0});
+
+        }
+
+        /// Constraint 3.24 WP5-D1
+        vector<Term> cleanTimeSum;
+        for(int e = firstEntry; e < endEntry; e++){
+            cleanTimeSum.push_back({columns.cleanChargeTime[e], 1.0});
+        }
+        cleanTimeSum.push_back({chargeTime, -1.0});
+        model.addRow(cleanTimeSum, 'L', 0.0);
+
+        /// Setting the upper bounds for the amount of energy charged during CEWs
+        vector<Term> cleanEnergySum = windowTimeValues;
+        cleanEnergySum.push_back({chargeAmount, -1.0});
+        model.addRow(cleanEnergySum, 'L', 0.0);
+
+        /// Constraint 3.25 WP5-D1
+        vector<Term> nonRenewableRow = windowTimeValues;
+        nonRenewableRow.push_back({nonRenewable, 1.0});
+        nonRenewableRow.push_back({chargeAmount, -1.0});
+        Method::addDiscountTerm(nonRenewableRow, discount);
+        model.addRow(nonRenewableRow, 'G', 0.0);
+
+    }
+    else{
+        /// Constraint 3.26 WP5-D1, the lower bound for non-clean energy if there is no charging station/CEW
+        vector<Term> nonRenewableRow{{nonRenewable, 1.0}, {chargeAmount, -1.0}};
+        Method::addDiscountTerm(nonRenewableRow, discount);
+        model.addRow(nonRenewableRow, 'G', 0.0);
+    }
+}
+
+/// create the constraints for the MIP model
+template <class Method>
+void SchedulingProblem::addConstraints(){
+    double minChargeTime = config.minChargeTime;
+    double maxChargeTime = config.maxChargeTime;
+    double chargeRate = config.chargeRate;
+    double startingCapacity = config.startingCapacity;
+    double maxBatteryCapacity = config.maxBatteryCapacity;
+    double minBatteryCapacity = config.minBatteryCapacity;
+    double deviationTime = config.deviationTime;
+
+    /// only visits of two buses to the same station within this window can overlap while charging
+    ConflictIndex conflictIndex;
+    conflictIndex.build(parameters.stopStart, parameters.stations, parameters.scheduledTimes);
+    vector<ConflictPair> conflictPairs = conflictIndex.candidatePairs((maxChargeTime + deviationTime) * 2);
+    int conflictPairIndex = 0;
+    columns.nonOverlap.clear();
+
+    const vector<int> &stations = parameters.stations;
+    const vector<double> &scheduledArrival = parameters.scheduledTimes;
+    const vector<int> &actualArrival = columns.actualArrival;
+    const vector<int> &deviation = columns.deviationTime;
+    const vector<int> &batteryCapacity = columns.batteryCapacity;
+    const vector<int> &chargeAmount = columns.chargeAmount;
+    const vector<int> &chargeTime = columns.chargeTime;
+    const vector<int> &charge = columns.charge;
+    const vector<int> &nonRenewable = columns.nonRenewable;
+    const StopSegments &segments = columns.segments;
+
+    for (int busIndex=0;busIndex<columns.buses.size();busIndex++ ) {
+        int b = columns.buses[busIndex];
+        int first = columns.stopStart[busIndex];
+        int end = columns.stopStart[busIndex + 1];
+        double minEnergyNeeded = 0.0;
+
+        /// create the constraints for the first stop of b
+        /// Constraint 3.1  WP5-D1 For first stop the capacity must be equal to the starting capacity. Thus it cannot be below the minimum battery capacity
+        model.addRow({{batteryCapacity[first], 1.0}, {chargeAmount[first], 1.0}}, 'L', maxBatteryCapacity);
+        model.addRow({{batteryCapacity[first], 1.0}}, 'E', startingCapacity);
+
+        /// Constraint 3.2 WP5-D1
+        model.addRow({{chargeTime[first], 1.0}, {charge[first], -maxChargeTime}}, 'L', 0.0);
+
+        /// Constraint 3.3 WP5-D1
+        model.addRow({{charge[first], 1.0}}, 'L', columns.chargingStation[stations[first]]);
+
+        /// Constraint 3.4 WP5-D1
+        model.addRow({{chargeAmount[first], 1.0}, {chargeTime[first], -chargeRate}}, 'L', 0.0);
+
+        /// Constraint 3.5 WP5-D1
+        model.addRow({{chargeTime[first], 1.0}, {charge[first], -minChargeTime}}, 'G', 0.0);
+
+        /// Constraint 3.8/3.9 WP5-D1 For the first stop it is assumed that there is no deviation from the original schedule
+        model.addRow({{deviation[first], 1.0}}, 'L', 0.0);
+        model.addRow({{actualArrival[first], 1.0}}, 'E', scheduledArrival[first]);
+
+        /// Constraint 3.26 WP5-D1
+        model.addRow({{nonRenewable[first], 1.0}, {chargeAmount[first], -1.0}}, 'L', 0.0);
+
+
+        Method::addStopRows(model, columns, config, first);
+
+        /// create constraints for the rest of the bus stops. The stops without columns are covered by the segment
+        /// which ends at the next kept stop, j is the kept stop before i
+        for (int i = first + 1; i < end; i++) {
+            minEnergyNeeded += parameters.legCost[i];
+            if(!segments.isKept(i)){
+                continue;
+            }
+            int j = segments.previousKept[i];
+
+            /// Constraint 3.1 WP5-D1
+            model.addRow({{batteryCapacity[i], 1.0}}, 'G', minBatteryCapacity);
+            model.addRow({{batteryCapacity[i], 1.0}, {chargeAmount[i], 1.0}}, 'L', maxBatteryCapacity);
+
+            /// Constraint 3.2 WP5-D1
+            model.addRow({{charge[i], maxChargeTime}, {chargeTime[i], -1.0}}, 'G', 0.0);
+
+            /// Constraint 3.3 WP5-D1
+            model.addRow({{charge[i], 1.0}}, 'L', columns.chargingStation[stations[i]]);
+
+            /// Constraint 3.4 WP5-D1
+            model.addRow({{chargeAmount[i], 1.0}, {chargeTime[i], -chargeRate}}, 'L', 0.0);
+
+            /// Constraint 3.5 WP5-D1
+            model.addRow({{chargeTime[i], 1.0}, {charge[i], -minChargeTime}}, 'G', 0.0);
+
+            /// Constraint 3.6 WP5-D1
+            model.addRow({{batteryCapacity[i], 1.0}, {batteryCapacity[j], -1.0}, {chargeAmount[j], -1.0}}, 'L',
+                         -segments.segmentCost[i]);
+
+            /// Constraint 3.7 WP5-D1
+            /// in some cases the bus schedule expects buses to travel at extremely high speeds to reach the next stop when adhering to the original schedule (i.e., traveling at 77 km/h).
+            /// it is assumed there is some issue with this, as a result it is assumed the travel time from ij in this situation is the difference between the scheduled times.
+            model.addRow({{actualArrival[i], 1.0}, {actualArrival[j], -1.0}, {chargeTime[j], -1.0}}, 'G',
+                         segments.segmentTime[i]);
+
+            /// the skipped stops between j and i have to be reached within their deviation, which bounds the
+            /// departure from j, the earliest arrival at i is part of the bounds of t_bi
+            if(segments.latestDeparture[i] != INFINITE_BOUND){
+                model.addRow({{actualArrival[j], 1.0}, {chargeTime[j], 1.0}}, 'L', segments.latestDeparture[i]);
+            }
+
+            /// If a driver rest is required then we enforce that there must be no deviation in arrival time for the following stop
+            if(parameters.rests[i - 1] == 1 && stations[i] == stations[i - 1]){
+                model.addRow({{deviation[i], 1.0}}, 'L', 0.0);
+            }
+
+            /// Constraint 3.8 WP5-D1
+            model.addRow({{deviation[i], 1.0}, {actualArrival[i], -1.0}}, 'G', -scheduledArrival[i]);
+            /// Constraint 3.9 WP5-D1
+            model.addRow({{deviation[i], 1.0}, {actualArrival[i], 1.0}}, 'G', scheduledArrival[i]);
+
+            /// Constraint 3.26 WP5-D1
+            model.addRow({{nonRenewable[i], 1.0}, {chargeAmount[i], -1.0}}, 'L', 0.0);
+
+            Method::addStopRows(model, columns, config, i);
+
+
+
+        }
+        /// add the non-overlapping constraints for the pairs found by the conflict index, which are sorted by bus
+        for (; conflictPairIndex < conflictPairs.size() && conflictPairs[conflictPairIndex].busIndex == busIndex;
+               conflictPairIndex++) {
+            const ConflictPair &pair = conflictPairs[conflictPairIndex];
+            int d = columns.buses[pair.otherBusIndex];
+            int i = first + pair.stop;
+            int j = columns.stopStart[pair.otherBusIndex] + pair.otherStop;
+            /// without a charger neither bus can charge, so the ordering does not have to be decided
+            if(config.compressStops && columns.chargingStation[stations[i]] != 1){
+                continue;
+            }
+            string varName = "busb" +  to_string(b)+"busd"+ to_string(d) +"stopi"+to_string(pair.stop)+"stopj"+
+                             to_string(pair.otherStop);
+            int sameStop = model.addColumn(0, 1, INTEGER, varName + "samestop");
+
+            /// Constraint 3.10 WP5-D1
+            model.addRow({{sameStop, 1.0}, {charge[i], -1.0}}, 'L', 0.0);
+
+            /// Constraint 3.11 WP5-D1
+            model.addRow({{sameStop, 1.0}, {charge[j], -1.0}}, 'L', 0.0);
+
+            /// Constraint 3.12 WP5-D1
+            model.addRow({{charge[i], 1.0}, {charge[j], 1.0}, {sameStop, -1.0}}, 'L', 1.0);
+            int const11 = model.addColumn(0, 1, INTEGER, varName + "jbeforei");
+            int const12 = model.addColumn(0, 1, INTEGER, varName + "ibeforej");
+
+            /// Constraint 3.13 WP5-D1
+            addDisjunction(model, config, const11, 0,
+                           {{actualArrival[i], 1.0}, {actualArrival[j], -1.0}, {chargeTime[j], -1.0}}, 'G', 0.0,
+                           segments.departureUpper[j] - segments.arrivalLower[i]);
+
+            /// Constraint 3.14 WP5-D1
+            addDisjunction(model, config, const12, 0,
+                           {{actualArrival[j], 1.0}, {actualArrival[i], -1.0}, {chargeTime[i], -1.0}}, 'G', 0.0,
+                           segments.departureUpper[i] - segments.arrivalLower[j]);
+
+            /// Constraint 3.15 WP5-D1
+            model.addRow({{const11, 1.0}, {const12, 1.0}, {sameStop, 1.0}}, 'L', 2.0);
+            columns.nonOverlap.push_back({i, j, sameStop, const11, const12});
+        }
+
+        /// a simplification. A bus needs as much energy as is needed to reach the end of their route minus the min battery capacity and starting capacity
+        vector<Term> chargeAmountSum;
+        for(int s = first; s < end; s++){
+            if(segments.isKept(s)){
+                chargeAmountSum.push_back({chargeAmount[s], 1.0});
+            }
+        }
+        model.addRow(chargeAmountSum, 'G', minEnergyNeeded + minBatteryCapacity - startingCapacity);
+        if(minEnergyNeeded + minBatteryCapacity - startingCapacity <= 0){
+            model.addRow(chargeAmountSum, 'L', 0.0);
+        }
+
+        out << "Bus: " << b << "\tTravel energy:" << minEnergyNeeded <<"\tMinBatCap: " << minBatteryCapacity
+        <<"\tStarting cap:" << startingCapacity << "\tmin energy needed:" << minEnergyNeeded +
+        minBatteryCapacity - startingCapacity <<endl;
+    }
+
+    addCEWConstraints<Method>();
+}
+
+/// create the constraints of the CEW's for every stop, and limit the clean energy used from each CEW. The rows and
+/// columns are kept so the CEW can be replaced
+template <class Method>
+void SchedulingProblem::addCEWConstraints(){
+    int firstRow = model.numberRows();
+    string suffix = cewSuffix();
+    int numberWindows = columns.powerExcess.size();
+    columns.windowBusTotal = vector<int>(columns.buses.size() * numberWindows);
+    for(int s = 0; s < parameters.totalStops(); s++){
+        if(columns.segments.isKept(s)){
+            addStopCEWConstraints<Method>(s);
+        }
+    }
+
+    /// the ce_kbi of each CEW, in order of the stops
+    vector<vector<int>> windowEntries(numberWindows);
+    for(int e = 0; e < columns.entryWindow.size(); e++){
+        windowEntries[columns.entryWindow[e]].push_back(e);
+    }
+    for(int k=0;k<numberWindows;k++){
+        vector<Term> windowTotals;
+        int position = 0;
+        for(int busIndex = 0; busIndex<columns.buses.size();busIndex++){
+            int b = columns.buses[busIndex];
+            vector<Term> busTotalRow;
+            for(; position < windowEntries[k].size() &&
+                  windowEntries[k][position] < columns.windowStart[columns.stopStart[busIndex + 1]]; position++){
+                busTotalRow.push_back({columns.windowEnergyUsed[windowEntries[k][position]], -1.0});
+            }
+            columns.windowBusTotal[busIndex * numberWindows + k] = NO_COLUMN;
+            if(busTotalRow.empty()){
+                continue;
+            }
+            int busTotal = model.addColumn(0.0, INFINITE_BOUND, CONTINUOUS,
+                                           "window"+to_string(k) + "bus"+to_string(b) + suffix);
+            busTotalRow.insert(busTotalRow.begin(), Term{busTotal, 1.0});
+            model.addRow(busTotalRow, 'G', 0.0);
+            windowTotals.push_back({busTotal, 1.0});
+            columns.windowBusTotal[busIndex * numberWindows + k] = busTotal;
+            columns.cewColumns.push_back(busTotal);
+        }
+        /// Constraint 3.27 WP5-D1
+        if(!windowTotals.empty()){
+            model.addRow(windowTotals, 'L', columns.powerExcess[k].availableEnergy);
+        }
+    }
+    for(int r = firstRow; r < model.numberRows(); r++){
+        columns.cewRows.push_back(r);
+    }
+}
+
+/// the objective of the columns of the coupling rows, which a decomposition prices instead of adding the rows. The
+/// objective of the model is restored by prices of 0
+void SchedulingProblem::priceCouplingRows(const vector<double> &windowPrices, const vector<double> &chargeTimePrices){
+    int numberWindows = columns.powerExcess.size();
+    for(int busIndex = 0; busIndex < columns.buses.size(); busIndex++){
+        for(int k = 0; k < numberWindows; k++){
+            int busTotal = columns.windowBusTotal[busIndex * numberWindows + k];
+            if(busTotal != NO_COLUMN){
+                model.objective[busTotal] = windowPrices[k];
+            }
+        }
+    }
+    for(int s = 0; s < parameters.totalStops(); s++){
+        if(columns.chargeTime[s] != NO_COLUMN){
+            model.objective[columns.chargeTime[s]] = chargeTimePrices[s];
+        }
+    }
+}
+
+void SchedulingProblem::limitCleanEnergy(const vector<double> &windowEnergy){
+    int numberWindows = columns.powerExcess.size();
+    for(int busIndex = 0; busIndex < columns.buses.size(); busIndex++){
+        for(int k = 0; k < numberWindows; k++){
+            int busTotal = columns.windowBusTotal[busIndex * numberWindows + k];
+            if(busTotal != NO_COLUMN){
+                model.columnUpper[busTotal] = max(0.0, windowEnergy[k]);
+            }
+        }
+    }
+}
+
+void SchedulingProblem::addChargerBusy(int s, double start, double end){
+    if(columns.charge[s] == NO_COLUMN){
+        return;
+    }
+    const StopSegments &segments = columns.segments;
+    int actualArrival = columns.actualArrival[s];
+    int chargeTime = columns.chargeTime[s];
+    string varName = "busy" + to_string(columns.chargerBusy.size()) + "stop" + to_string(s);
+    int before = model.addColumn(0, 1, INTEGER, varName + "before");
+    int after = model.addColumn(0, 1, INTEGER, varName + "after");
+    addDisjunction(model, config, before, 0, {{actualArrival, 1.0}, {chargeTime, 1.0}}, 'L', start,
+                   segments.departureUpper[s] - start);
+    addDisjunction(model, config, after, 0, {{actualArrival, 1.0}}, 'G', end, end - segments.arrivalLower[s]);
+    model.addRow({{before, 1.0}, {after, 1.0}, {columns.charge[s], 1.0}}, 'L', 2.0);
+    columns.chargerBusy.push_back({s, start, end, before, after});
+}
+
+/// converts the values of the model columns into primitives (i.e., int, float, bool etc) for printing.
+primitiveVariables SchedulingProblem::solutionToPrimitive(const vector<double> &values){
+    primitiveVariables outputVars;
+    int numberStops = parameters.totalStops();
+    bool spm = !columns.ases.empty() && columns.ases[0] != NO_COLUMN;
+    /// the stops without columns are filled in by StopSegments::expand
+    auto columnValues = [&values](const vector<int> &stopColumns, vector<double> &stopValues){
+        stopValues.resize(stopColumns.size());
+        for(int s = 0; s < stopColumns.size(); s++){
+            stopValues[s] = stopColumns[s] == NO_COLUMN ? 0.0 : values[stopColumns[s]];
+        }
+    };
+    auto binaryValues = [&values](const vector<int> &stopColumns, vector<int> &stopValues){
+        stopValues.resize(stopColumns.size());
+        for(int s = 0; s < stopColumns.size(); s++){
+            stopValues[s] = stopColumns[s] == NO_COLUMN ? 0 : lround(values[stopColumns[s]]);
+        }
+    };
+
+    outputVars.buses = columns.buses;
+    outputVars.stopStart = columns.stopStart;
+    outputVars.busSequences = parameters.stations;
+    outputVars.scheduledTime = parameters.scheduledTimes;
+    columnValues(columns.actualArrival, outputVars.arrivalTime);
+    columnValues(columns.deviationTime, outputVars.deviationTime);
+    columnValues(columns.batteryCapacity, outputVars.capacity);
+    columnValues(columns.chargeTime, outputVars.chargeTime);
+    binaryValues(columns.charge, outputVars.charge);
+    columnValues(columns.nonRenewable, outputVars.nonRenewable);
+    columnValues(columns.chargeAmount, outputVars.chargeAmount);
+    /// ase and r_bi are only assigned values if SPM is used.
+    if(spm){
+        binaryValues(columns.ases, outputVars.ases);
+        columnValues(columns.discounts, outputVars.discounts);
+    }
+    columns.segments.expand(parameters, outputVars, columns.horizonEndTime, spm);
+
+    /// only the CEW used by a stop are kept
+    for(int busIndex = 0; busIndex < columns.buses.size(); busIndex++){
+        for(int s = columns.stopStart[busIndex]; s < columns.stopStart[busIndex + 1]; s++){
+            for(int e = columns.windowStart[s]; e < columns.windowStart[s + 1]; e++){
+                CleanEnergyUse use{columns.entryWindow[e], busIndex, s - columns.stopStart[busIndex],
+                                   values[columns.windowEnergyUsed[e]],
+                                   values[columns.cleanChargeTime[e]],
+                                   (int) lround(values[columns.cleanWindowCharge[e]])};
+                if(use.energy != 0.0 || use.chargeTime != 0.0 || use.charge != 0){
+                    outputVars.cleanEnergy.push_back(use);
+                }
+            }
+        }
+    }
+    outputVars.chargingStations = columns.chargingStation;
+    outputVars.powerExcess = columns.powerExcess;
+    return outputVars;
+
+}
+
+/// converts a schedule with the same buses as the model into a value for every column of the model, used to hand a
+/// heuristic solution to the solver
+vector<double> SchedulingProblem::primitiveToColumns(primitiveVariables &schedule){
+    vector<double> values(model.numberColumns(), 0.0);
+    int numberWindows = columns.powerExcess.size();
+    for(int s = 0; s < parameters.totalStops(); s++){
+        if(!columns.segments.isKept(s)){
+            continue;
+        }
+        values[columns.actualArrival[s]] = schedule.arrivalTime[s];
+        values[columns.deviationTime[s]] = schedule.deviationTime[s];
+        values[columns.batteryCapacity[s]] = schedule.capacity[s];
+        values[columns.chargeTime[s]] = schedule.chargeTime[s];
+        values[columns.charge[s]] = schedule.charge[s];
+        values[columns.chargeAmount[s]] = schedule.chargeAmount[s];
+        values[columns.nonRenewable[s]] = schedule.nonRenewable[s];
+        if(columns.ases[s] != NO_COLUMN){
+            values[columns.ases[s]] = schedule.ases[s];
+            values[columns.discounts[s]] = schedule.discounts[s];
+        }
+    }
+    /// a CEW the stop can not reach has no columns, its use is 0 in the model
+    for(auto &use: schedule.cleanEnergy){
+        int e = windowEntry(columns.stopStart[use.bus] + use.stop, use.window);
+        if(e < 0){
+            continue;
+        }
+        values[columns.cleanChargeTime[e]] = use.chargeTime;
+        values[columns.cleanWindowCharge[e]] = use.charge;
+        values[columns.windowEnergyUsed[e]] = use.energy;
+        values[columns.windowBusTotal[use.bus * numberWindows + use.window]] += use.energy;
+    }
+
+    /// a stop charges before a charge outside of the model if its middle is earlier
+    for(auto &busy: columns.chargerBusy){
+        bool before = 2 * schedule.arrivalTime[busy.stop] + schedule.chargeTime[busy.stop] <= busy.start + busy.end;
+        values[busy.before] = schedule.charge[busy.stop] == 1 && before ? 0 : 1;
+        values[busy.after] = schedule.charge[busy.stop] == 1 && !before ? 0 : 1;
+    }
+
+    /// the ordering binaries only have to hold for the bus which charges second. Charges which touch are ordered by
+    /// their middle, so rounding in the end of the first charge does not turn the order around
+    for(auto &stops: columns.nonOverlap){
+        bool sameStop = schedule.charge[stops.stop] == 1 && schedule.charge[stops.otherStop] == 1;
+        bool dFirst = 2 * schedule.arrivalTime[stops.stop] + schedule.chargeTime[stops.stop] >=
+                      2 * schedule.arrivalTime[stops.otherStop] + schedule.chargeTime[stops.otherStop];
+        values[stops.sameStop] = sameStop ? 1 : 0;
+        values[stops.jBeforeI] = sameStop && dFirst ? 0 : 1;
+        values[stops.iBeforeJ] = sameStop && !dFirst ? 0 : 1;
+    }
+    return values;
+}
+
+/// sets the values of variables which occur before the current checkpoint denoted by startTime. The values are fixed
+/// through the column bounds, so the same model can be moved to a later checkpoint without adding rows
+void SchedulingProblem::setPreviousValues(primitiveVariables &loadedVars, double startTime, ModelChanges &changes){
+    auto fixColumn = [this, &changes](int column, double value){
+        model.columnLower[column] = value;
+        model.columnUpper[column] = value;
+        changes.columns.push_back(column);
+    };
+
+    /// the previous schedule may list the buses in another order
+    map<int, int> busIndices;
+    for(int busIndex = 0; busIndex < columns.buses.size(); busIndex++){
+        busIndices[columns.buses[busIndex]] = busIndex;
+    }
+    for (int loadedIndex = 0; loadedIndex < loadedVars.buses.size(); loadedIndex++) {
+        auto busIndex = busIndices.find(loadedVars.buses[loadedIndex]);
+        if(busIndex == busIndices.end()){
+            continue;
+        }
+        int numStops = min(loadedVars.numberStops(loadedIndex), parameters.numberStops(busIndex->second));
+        /// the last stop without columns which was reached, it bounds the arrival and the capacity at the next stop
+        int reachedSkipped = -1;
+        double reachedArrival = 0.0;
+        double reachedCapacity = 0.0;
+        for(int i = 0; i<numStops;i++){
+            int loaded = loadedVars.stopStart[loadedIndex] + i;
+            int s = columns.stopStart[busIndex->second] + i;
+            bool reached = loadedVars.arrivalTime[loaded] <= startTime;
+            if(!columns.segments.isKept(s)){
+                if(reached){
+                    reachedSkipped = s;
+                    reachedArrival = loadedVars.arrivalTime[loaded];
+                    reachedCapacity = loadedVars.capacity[loaded];
+                }
+                continue;
+            }
+            if(reachedSkipped >= 0 && !reached){
+                for(int skipped = reachedSkipped + 1; skipped <= s; skipped++){
+                    reachedArrival += parameters.legTime[skipped];
+                    reachedCapacity -= parameters.legCost[skipped];
+                }
+                int arrival = columns.actualArrival[s];
+                int capacity = columns.batteryCapacity[s];
+                model.columnLower[arrival] = max(model.columnLower[arrival], reachedArrival);
+                model.columnUpper[capacity] = min(model.columnUpper[capacity], reachedCapacity);
+                changes.columns.push_back(arrival);
+                changes.columns.push_back(capacity);
+            }
+            reachedSkipped = -1;
+            if(reached){
+                fixColumn(columns.actualArrival[s], loadedVars.arrivalTime[loaded]);
+                fixColumn(columns.deviationTime[s], loadedVars.deviationTime[loaded]);
+                fixColumn(columns.batteryCapacity[s], loadedVars.capacity[loaded]);
+                fixColumn(columns.charge[s], loadedVars.charge[loaded]);
+                fixColumn(columns.chargeTime[s], loadedVars.chargeTime[loaded]);
+                fixColumn(columns.chargeAmount[s], loadedVars.chargeAmount[loaded]);
+
+                int nonRenewable = columns.nonRenewable[s];
+                model.columnLower[nonRenewable] = max(model.columnLower[nonRenewable], loadedVars.nonRenewable[loaded]);
+                changes.columns.push_back(nonRenewable);
+            }
+        }
+    }
+}
+
+/// Constraint 2.1 WP5-D2 depends on \Omega. Where the bounds of t_bi already decide whether the bus arrives before
+/// \Omega, ase_bi is fixed and the row is switched off or always met. The M of the row covers the bounds of t_bi, so
+/// it stays valid for any \Omega
+void SchedulingProblem::setHorizonEnd(ModelChanges &changes){
+    double horizonEndTime = columns.horizonEndTime;
+    for(int s = 0; s < columns.horizonEndRows.size(); s++){
+        int row = columns.horizonEndRows[s];
+        if(row == NO_ROW){
+            continue;
+        }
+        int ase = columns.ases[s];
+        int arrival = columns.actualArrival[s];
+        model.columnLower[ase] = 0.0;
+        model.columnUpper[ase] = 1.0;
+        model.rowLower[row] = horizonEndTime;
+        if(model.columnUpper[arrival] < horizonEndTime){
+            model.columnLower[ase] = 1.0;
+            model.rowLower[row] = -INFINITE_BOUND;
+        }
+        else if(model.columnLower[arrival] >= horizonEndTime){
+            model.columnUpper[ase] = 0.0;
+        }
+        changes.columns.push_back(ase);
+        changes.rows.push_back(row);
+    }
+}
+
+/// move the model to the next checkpoint of a rolling horizon. The stops reached before horizonStartTime are fixed
+/// to the values of schedule, the end of the horizon is moved and, if they changed, the CEW are replaced. The rows and
+/// columns of the old CEW are switched off and the new ones are appended, so a loaded model only has to be updated.
+ModelChanges SchedulingProblem::advanceHorizon(primitiveVariables &schedule, double horizonStartTime,
+                                               double horizonEndTime, const vector<CleanEnergyWindow> &windows){
+    ModelChanges changes;
+    config.recalculate = true;
+    config.horizonStartTime = horizonStartTime;
+    config.horizonEndTime = horizonEndTime;
+    columns.horizonEndTime = horizonEndTime;
+
+    setPreviousValues(schedule, horizonStartTime, changes);
+    setHorizonEnd(changes);
+
+    vector<CleanEnergyWindow> previousWindows = columns.powerExcess;
+    parameters.cleanEnergyWindows = windows;
+    setCleanEnergyWindows(windows);
+    bool sameWindows = previousWindows.size() == columns.powerExcess.size();
+    for(int k = 0; sameWindows && k < previousWindows.size(); k++){
+        sameWindows = previousWindows[k].startTime == columns.powerExcess[k].startTime &&
+                      previousWindows[k].endTime == columns.powerExcess[k].endTime &&
+                      previousWindows[k].availableEnergy == columns.powerExcess[k].availableEnergy;
+    }
+    if(sameWindows){
+        return changes;
+    }
+
+    for(int column: columns.cewColumns){
+        model.columnLower[column] = 0.0;
+        model.columnUpper[column] = 0.0;
+        changes.columns.push_back(column);
+    }
+    for(int row: columns.cewRows){
+        model.rowLower[row] = -INFINITE_BOUND;
+        model.rowUpper[row] = INFINITE_BOUND;
+        changes.rows.push_back(row);
+    }
+    columns.cewColumns.clear();
+    columns.cewRows.clear();
+    columns.cewGeneration++;
+    createCEWVariables();
+    if(config.method == "SPM"){
+        addCEWConstraints<SPMConstraints>();
+    }
+    else{
+        addCEWConstraints<MPMConstraints>();
+    }
+    return changes;
+}
+
+/// a starting solution for the current model made from the schedule of the previous checkpoint. The CEW may have
+/// changed, so all energy is counted as non-clean, which keeps the schedule feasible
+primitiveVariables SchedulingProblem::restartSchedule(primitiveVariables schedule){
+    int numberStops = schedule.arrivalTime.size();
+    bool spm = config.method == "SPM";
+    schedule.powerExcess = columns.powerExcess;
+    schedule.cleanEnergy.clear();
+    if(spm){
+        schedule.ases = vector<int>(numberStops);
+        schedule.discounts = vector<double>(numberStops);
+    }
+    for(int s = 0; s < numberStops; s++){
+        /// only charges after the end of the horizon (ase_bi = 0) can be discounted
+        if(spm){
+            schedule.ases[s] = schedule.arrivalTime[s] < config.horizonEndTime ? 1 : 0;
+            schedule.discounts[s] = schedule.ases[s] == 1 ? 0.0 : config.discountFactor * schedule.chargeAmount[s];
+            schedule.nonRenewable[s] = schedule.chargeAmount[s] - schedule.discounts[s];
+        }
+        else{
+            schedule.nonRenewable[s] = schedule.chargeAmount[s];
+        }
+    }
+    return schedule;
+}
@@ -0,0 +1,185 @@
+#ifndef SCHEDULER_SCHEDULING_PROBLEM_H
+#define SCHEDULER_SCHEDULING_PROBLEM_H
+#include "vector"
+#include "map"
+#include "iostream"
+#include "DataStructures.h"
+#include "RunConfig.h"
+#include "ModelIR.h"
+#include "StopSegments.h"
+
+using namespace std;
+
+/// the binaries of the non-overlap constraints (3.10-3.15) between the stops stop and otherStop of two buses, both are
+/// indices into the per stop columns
+struct nonOverlapVariables{
+    int stop;
+    int otherStop;
+    int sameStop;
+    int jBeforeI;
+    int iBeforeJ;
+};
+
+/// the binaries of a charge of another bus, from start to end, at the charger of stop. The charge of the stop ends
+/// before it while before is 0 and starts after it while after is 0, see addChargerBusy
+struct chargerBusyVariables{
+    int stop;
+    double start;
+    double end;
+    int before;
+    int after;
+};
+
+/// the columns of the model which hold each variable, and the constants used to build the constraints. The per stop
+/// columns use the layout of ModelParameters, the columns of the stops of bus buses[n] are stopStart[n] to
+/// stopStart[n + 1] - 1. Stops which are not kept by segments have no columns (NO_COLUMN). Per CEW columns are only created for the CEW a stop can reach, see windowStart.
+struct ModelColumns{
+    /// x_i Binary variable which is 1 if charging station is install at station i
+    vector<int> chargingStation;
+
+    /// B set of available buses
+    vector<int> buses;
+    vector<int> stopStart;
+
+    /// the stops which have columns, and the legs between them
+    StopSegments segments;
+
+    /// nc_bi amount of non-clean energy (in kWh) used by bus b at stop i
+    vector<int> nonRenewable;
+
+    /// t_bi actual arrival time (in hour decimal) of bus b at stop j
+    vector<int> actualArrival;
+
+    /// delta tbi difference between actual arrival time and original schedule time of bus b at stop j
+    vector<int> deviationTime;
+
+    /// c_bi amount of capacity (in kWh) bus b has at stop i
+    vector<int> batteryCapacity;
+
+    /// e_bi amount of energy gained (in kWh) by bus b at stop i
+    vector<int> chargeAmount;
+
+    /// ct_bi charge time (in hour decimal) of bus b at stop i
+    vector<int> chargeTime;
+
+    /// x_bi binary variable assigned 1 if bus b charges at stop i
+    vector<int> charge;
+
+    /// T_ij amount of time required for a trip between stations i and j
+    TripTime tripTime;
+
+    /// \Gamma_k information about the k^th Clean Energy Window
+    vector<CleanEnergyWindow> powerExcess;
+
+    /// Dij amount of energy required for a trip between stations i and j
+    TripCost tripCost;
+
+    /// the CEW stop s can reach are entries windowStart[s] to windowStart[s + 1] - 1, entry e is CEW entryWindow[e].
+    /// Stops without a charging station have none
+    vector<int> windowStart;
+    vector<int> entryWindow;
+
+    /// ce_kbi amount of clean energy used in CEW k by bus b at stop i, per entry
+    vector<int> windowEnergyUsed;
+
+    /// ase_bi a binary variable assigned 1 if bus b arrives at stop i before the end of the current checkpoint (Omega)
+    /// only created for SPM, NO_COLUMN otherwise
+    vector<int> ases;
+
+    /// r_bi the reduction in energy (in kWh) given to charges after the current checkpoint. Only created for SPM.
+    vector<int> discounts;
+
+    /// \Omega the time which the current horizon/checkpoint ends
+    double horizonEndTime;
+
+    /// wt_bik the time (in hour decimal) bus b spends charging at stop i using clean energy from CEW k, per entry
+    vector<int> cleanChargeTime;
+
+    /// kt_bik binary variable assigned 1 if bus b charges at stop i during CEW k, per entry
+    vector<int> cleanWindowCharge;
+
+    /// the binaries created for each pair of stops which could share a charger
+    vector<nonOverlapVariables> nonOverlap;
+
+    /// the charges of buses outside of the model, see addChargerBusy
+    vector<chargerBusyVariables> chargerBusy;
+
+    /// the total clean energy used by bus b from CEW k, n * K + k for the bus with index n. NO_COLUMN if no stop of the
+    /// bus can reach CEW k
+    vector<int> windowBusTotal;
+
+    /// the row of constraint 2.1 WP5-D2 of each stop, which depends on the end of the horizon. NO_ROW for MPM
+    vector<int> horizonEndRows;
+
+    /// the columns and rows which belong to the current CEW
+    vector<int> cewColumns;
+    vector<int> cewRows;
+
+    /// the number of times the CEW were replaced
+    int cewGeneration = 0;
+
+};
+
+/// The MIP model of one run. All state of the model, including the column of each variable, is owned by the instance,
+/// so several problems can be built and solved at the same time.
+class SchedulingProblem{
+public:
+    SchedulingProblem(const ModelParameters &parameters, const RunConfig &config, ostream &out = cout);
+
+    /// create the variables and constraints. When recalculating, the values of previousSchedule are kept for the stops
+    /// which occur before the start of the horizon
+    void build(primitiveVariables *previousSchedule = nullptr);
+    primitiveVariables solutionToPrimitive(const vector<double> &values);
+    vector<double> primitiveToColumns(primitiveVariables &schedule);
+
+    /// used by the rolling horizon, see the definitions
+    ModelChanges advanceHorizon(primitiveVariables &schedule, double horizonStartTime, double horizonEndTime,
+                                const vector<CleanEnergyWindow> &windows);
+    primitiveVariables restartSchedule(primitiveVariables schedule);
+
+    /// the CEW which are part of the model
+    const vector<CleanEnergyWindow> &cleanEnergyWindows() const;
+
+    /// the windows which are kept by a model of the buses of parameters
+    static vector<CleanEnergyWindow> usedWindows(const ModelParameters &parameters,
+                                                 const vector<CleanEnergyWindow> &windows);
+
+    /// windowPrices[k] is the objective of the clean energy used from CEW k by each bus (3.27), chargeTimePrices[s] the
+    /// objective of ct_bi of stop s
+    void priceCouplingRows(const vector<double> &windowPrices, const vector<double> &chargeTimePrices);
+
+    /// the clean energy each bus may use from CEW k is limited to windowEnergy[k]
+    void limitCleanEnergy(const vector<double> &windowEnergy);
+
+    /// the charger of stop s is used by a bus outside of the model from start to end, a charge at the stop has to end
+    /// before start or begin after end (as 3.13-3.15)
+    void addChargerBusy(int s, double start, double end);
+
+    ModelParameters parameters;
+    RunConfig config;
+    ModelIR model;
+
+private:
+    /// Method is the policy of MPM or SPM, see SchedulingProblem.cpp
+    template <class Method>
+    void buildModel();
+    template <class Method>
+    void createVariables();
+    void setCleanEnergyWindows(const vector<CleanEnergyWindow> &windows);
+    void createCEWVariables();
+    string cewSuffix() const;
+    int windowEntry(int s, int k) const;
+    template <class Method>
+    void addConstraints();
+    template <class Method>
+    void addCEWConstraints();
+    template <class Method>
+    void addStopCEWConstraints(int s);
+    void setPreviousValues(primitiveVariables &loadedVars, double startTime, ModelChanges &changes);
+    void setHorizonEnd(ModelChanges &changes);
+
+    ModelColumns columns;
+    ostream &out;
+};
+
+#endif //SCHEDULER_SCHEDULING_PROBLEM_H
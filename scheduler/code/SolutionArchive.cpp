@@ -0,0 +1,500 @@
+#include "SolutionArchive.h"
+#include "fstream"
+#include "cstring"
+#include "algorithm"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const char archiveMagic[8] = {'E', 'B', 'U', 'S', 'S', 'O', 'L', '\0'};
+
+static uint64_t aligned(uint64_t offset){
+    return (offset + 7) & ~(uint64_t) 7;
+}
+
+/// the groups, rows and values of one field while the archive is written
+struct TableBuilder{
+    uint32_t field;
+    uint32_t valueType;
+    vector<int32_t> groupKeys;
+    vector<uint64_t> groupStarts = {0};
+    vector<int32_t> rowKeys;
+    vector<uint64_t> rowStarts = {0};
+    vector<int32_t> intValues;
+    vector<double> doubleValues;
+
+    TableBuilder(ArchiveField field, ArchiveValueType valueType): field(field), valueType(valueType){}
+
+    template <class T>
+    void addRow(int key, const T *first, const T *last){
+        rowKeys.push_back(key);
+        if(valueType == ARCHIVE_INT32){
+            intValues.insert(intValues.end(), first, last);
+            rowStarts.push_back(intValues.size());
+        }
+        else{
+            doubleValues.insert(doubleValues.end(), first, last);
+            rowStarts.push_back(doubleValues.size());
+        }
+    }
+
+    template <class T>
+    void addRow(int key, const vector<T> &row){
+        addRow(key, row.data(), row.data() + row.size());
+    }
+
+    void endGroup(int key){
+        groupKeys.push_back(key);
+        groupStarts.push_back(rowKeys.size());
+    }
+
+    /// a per stop array as a row for each bus keyed by the bus, in a single group. A field which is not used by the
+    /// solution, such as ases for MPM, has no rows
+    template <class T>
+    void addStops(const primitiveVariables &solution, const vector<T> &stops){
+        for(int n = 0; !stops.empty() && n < solution.buses.size(); n++){
+            addRow(solution.buses[n], stops.data() + solution.stopStart[n], stops.data() + solution.stopStart[n + 1]);
+        }
+        endGroup(0);
+    }
+
+    /// a list of rows keyed by their index in a single group
+    template <class T>
+    void addList(const vector<vector<T>> &rows){
+        for(int i = 0; i < rows.size(); i++){
+            addRow(i, rows[i]);
+        }
+        endGroup(0);
+    }
+
+    template <class T>
+    void write(ofstream &file, const vector<T> &section){
+        file.write(reinterpret_cast<const char *>(section.data()), section.size() * sizeof(T));
+    }
+};
+
+static void pad(ofstream &file, uint64_t &offset){
+    static const char zeros[8] = {0};
+    uint64_t next = aligned(offset);
+    file.write(zeros, next - offset);
+    offset = next;
+}
+
+void SolutionArchive::write(const primitiveVariables &solution, string solutionFile){
+    vector<TableBuilder> builders;
+
+    builders.emplace_back(ARCHIVE_BUSES, ARCHIVE_INT32);
+    builders.back().addList(vector<vector<int>>{solution.buses});
+    builders.emplace_back(ARCHIVE_CHARGING_STATIONS, ARCHIVE_INT32);
+    builders.back().addList(vector<vector<int>>{solution.chargingStations});
+    builders.emplace_back(ARCHIVE_BUS_SEQUENCES, ARCHIVE_INT32);
+    builders.back().addStops(solution, solution.busSequences);
+    builders.emplace_back(ARCHIVE_NON_RENEWABLE, ARCHIVE_FLOAT64);
+    builders.back().addStops(solution, solution.nonRenewable);
+    builders.emplace_back(ARCHIVE_ARRIVAL_TIME, ARCHIVE_FLOAT64);
+    builders.back().addStops(solution, solution.arrivalTime);
+    builders.emplace_back(ARCHIVE_SCHEDULED_TIME, ARCHIVE_FLOAT64);
+    builders.back().addStops(solution, solution.scheduledTime);
+    builders.emplace_back(ARCHIVE_DEVIATION_TIME, ARCHIVE_FLOAT64);
+    builders.back().addStops(solution, solution.deviationTime);
+    builders.emplace_back(ARCHIVE_CAPACITY, ARCHIVE_FLOAT64);
+    builders.back().addStops(solution, solution.capacity);
+    builders.emplace_back(ARCHIVE_CHARGE_TIME, ARCHIVE_FLOAT64);
+    builders.back().addStops(solution, solution.chargeTime);
+    builders.emplace_back(ARCHIVE_CHARGE_AMOUNT, ARCHIVE_FLOAT64);
+    builders.back().addStops(solution, solution.chargeAmount);
+    builders.emplace_back(ARCHIVE_CHARGE, ARCHIVE_INT32);
+    builders.back().addStops(solution, solution.charge);
+
+    /// each window is a row of start time, end time and available energy
+    builders.emplace_back(ARCHIVE_POWER_EXCESS, ARCHIVE_FLOAT64);
+    for(int k = 0; k < solution.powerExcess.size(); k++){
+        const CleanEnergyWindow &window = solution.powerExcess[k];
+        builders.back().addRow(k, vector<double>{window.startTime, window.endTime, window.availableEnergy});
+    }
+    builders.back().endGroup(0);
+
+    builders.emplace_back(ARCHIVE_ASES, ARCHIVE_INT32);
+    builders.back().addStops(solution, solution.ases);
+    builders.emplace_back(ARCHIVE_DISCOUNTS, ARCHIVE_FLOAT64);
+    builders.back().addStops(solution, solution.discounts);
+
+    /// each member of the CEW entries is a single row with a value for every entry
+    int numberEntries = solution.cleanEnergy.size();
+    vector<int> windows(numberEntries), buses(numberEntries), stops(numberEntries), charges(numberEntries);
+    vector<double> energies(numberEntries), chargeTimes(numberEntries);
+    for(int e = 0; e < numberEntries; e++){
+        const CleanEnergyUse &use = solution.cleanEnergy[e];
+        windows[e] = use.window;
+        buses[e] = use.bus;
+        stops[e] = use.stop;
+        energies[e] = use.energy;
+        chargeTimes[e] = use.chargeTime;
+        charges[e] = use.charge;
+    }
+    builders.emplace_back(ARCHIVE_CLEAN_ENERGY_WINDOW, ARCHIVE_INT32);
+    builders.back().addList(vector<vector<int>>{windows});
+    builders.emplace_back(ARCHIVE_CLEAN_ENERGY_BUS, ARCHIVE_INT32);
+    builders.back().addList(vector<vector<int>>{buses});
+    builders.emplace_back(ARCHIVE_CLEAN_ENERGY_STOP, ARCHIVE_INT32);
+    builders.back().addList(vector<vector<int>>{stops});
+    builders.emplace_back(ARCHIVE_CLEAN_ENERGY_AMOUNT, ARCHIVE_FLOAT64);
+    builders.back().addList(vector<vector<double>>{energies});
+    builders.emplace_back(ARCHIVE_CLEAN_ENERGY_TIME, ARCHIVE_FLOAT64);
+    builders.back().addList(vector<vector<double>>{chargeTimes});
+    builders.emplace_back(ARCHIVE_CLEAN_ENERGY_CHARGE, ARCHIVE_INT32);
+    builders.back().addList(vector<vector<int>>{charges});
+
+    /// lay out the sections of every table after the header and the table directory
+    vector<ArchiveTable> directory(builders.size());
+    uint64_t offset = aligned(sizeof(ArchiveHeader) + builders.size() * sizeof(ArchiveTable));
+    for(int t = 0; t < builders.size(); t++){
+        TableBuilder &builder = builders[t];
+        ArchiveTable &entry = directory[t];
+        entry.field = builder.field;
+        entry.valueType = builder.valueType;
+        entry.numberGroups = builder.groupKeys.size();
+        entry.numberRows = builder.rowKeys.size();
+        entry.numberValues = builder.rowStarts.back();
+        entry.groupKeys = offset;
+        offset = aligned(offset + entry.numberGroups * sizeof(int32_t));
+        entry.groupStarts = offset;
+        offset = aligned(offset + (entry.numberGroups + 1) * sizeof(uint64_t));
+        entry.rowKeys = offset;
+        offset = aligned(offset + entry.numberRows * sizeof(int32_t));
+        entry.rowStarts = offset;
+        offset = aligned(offset + (entry.numberRows + 1) * sizeof(uint64_t));
+        entry.values = offset;
+        offset = aligned(offset + entry.numberValues *
+                                  (builder.valueType == ARCHIVE_INT32 ? sizeof(int32_t) : sizeof(double)));
+    }
+
+    ArchiveHeader header;
+    memcpy(header.magic, archiveMagic, sizeof(archiveMagic));
+    header.version = version;
+    header.numberTables = builders.size();
+    header.fileSize = offset;
+
+    ofstream file(solutionFile, ios::binary);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(directory.data()), directory.size() * sizeof(ArchiveTable));
+    uint64_t written = sizeof(header) + directory.size() * sizeof(ArchiveTable);
+    pad(file, written);
+    for(int t = 0; t < builders.size(); t++){
+        TableBuilder &builder = builders[t];
+        builder.write(file, builder.groupKeys);
+        written += builder.groupKeys.size() * sizeof(int32_t);
+        pad(file, written);
+        builder.write(file, builder.groupStarts);
+        written += builder.groupStarts.size() * sizeof(uint64_t);
+        builder.write(file, builder.rowKeys);
+        written += builder.rowKeys.size() * sizeof(int32_t);
+        pad(file, written);
+        builder.write(file, builder.rowStarts);
+        written += builder.rowStarts.size() * sizeof(uint64_t);
+        if(builder.valueType == ARCHIVE_INT32){
+            builder.write(file, builder.intValues);
+            written += builder.intValues.size() * sizeof(int32_t);
+        }
+        else{
+            builder.write(file, builder.doubleValues);
+            written += builder.doubleValues.size() * sizeof(double);
+        }
+        pad(file, written);
+    }
+}
+
+bool SolutionArchive::isArchive(string solutionFile){
+    ifstream file(solutionFile, ios::binary);
+    char magic[sizeof(archiveMagic)];
+    return file.read(magic, sizeof(magic)) && memcmp(magic, archiveMagic, sizeof(magic)) == 0;
+}
+
+SolutionArchive::~SolutionArchive(){
+    close();
+}
+
+void SolutionArchive::close(){
+    if(data != nullptr){
+        munmap((void *) data, size);
+    }
+    data = nullptr;
+    size = 0;
+    tables.clear();
+}
+
+/// true if count elements of the given size starting at offset lie within the file and are aligned
+static bool validSection(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize){
+    return offset % 8 == 0 && offset <= fileSize && count <= (fileSize - offset) / elementSize;
+}
+
+/// true if the starts begin at 0, never decrease and end at the size of the next level
+static bool validStarts(const uint64_t *starts, uint64_t count, uint64_t last){
+    if(starts[0] != 0 || starts[count] != last){
+        return false;
+    }
+    for(uint64_t i = 0; i < count; i++){
+        if(starts[i] > starts[i + 1]){
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SolutionArchive::open(string solutionFile, string &error){
+    close();
+    error.clear();
+    int descriptor = ::open(solutionFile.c_str(), O_RDONLY);
+    if(descriptor < 0){
+        error = solutionFile + " can not be opened";
+        return false;
+    }
+    struct stat status;
+    if(fstat(descriptor, &status) != 0 || status.st_size < (off_t) sizeof(ArchiveHeader)){
+        ::close(descriptor);
+        error = solutionFile + " is too small to be a solution archive";
+        return false;
+    }
+    void *mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if(mapping == MAP_FAILED){
+        error = solutionFile + " can not be mapped";
+        return false;
+    }
+    data = static_cast<const char *>(mapping);
+    size = status.st_size;
+
+    const ArchiveHeader *header = reinterpret_cast<const ArchiveHeader *>(data);
+    if(memcmp(header->magic, archiveMagic, sizeof(archiveMagic)) != 0){
+        error = solutionFile + " is not a solution archive";
+    }
+    else if(header->version == 0 || header->version > version){
+        error = solutionFile + " has archive version " + to_string(header->version) + ", only versions up to " +
+                to_string(version) + " can be read";
+    }
+    else if(header->fileSize != size || !validSection(sizeof(ArchiveHeader), header->numberTables,
+                                                      sizeof(ArchiveTable), size)){
+        error = solutionFile + " is truncated";
+    }
+    if(!error.empty()){
+        close();
+        return false;
+    }
+
+    const ArchiveTable *directory = reinterpret_cast<const ArchiveTable *>(data + sizeof(ArchiveHeader));
+    for(int t = 0; t < header->numberTables; t++){
+        const ArchiveTable &entry = directory[t];
+        uint64_t valueSize = entry.valueType == ARCHIVE_INT32 ? sizeof(int32_t) : sizeof(double);
+        bool valid = (entry.valueType == ARCHIVE_INT32 || entry.valueType == ARCHIVE_FLOAT64) &&
+                     validSection(entry.groupKeys, entry.numberGroups, sizeof(int32_t), size) &&
+                     validSection(entry.groupStarts, entry.numberGroups + 1, sizeof(uint64_t), size) &&
+                     validSection(entry.rowKeys, entry.numberRows, sizeof(int32_t), size) &&
+                     validSection(entry.rowStarts, entry.numberRows + 1, sizeof(uint64_t), size) &&
+                     validSection(entry.values, entry.numberValues, valueSize, size) &&
+                     validStarts(groupStarts(entry), entry.numberGroups, entry.numberRows) &&
+                     validStarts(rowStarts(entry), entry.numberRows, entry.numberValues);
+        if(!valid){
+            error = solutionFile + " has a corrupt table for field " + to_string(entry.field);
+            close();
+            return false;
+        }
+
+        /// fields written by a newer version are skipped
+        if(entry.field > ARCHIVE_CLEAN_ENERGY_CHARGE){
+            continue;
+        }
+        if(tables.size() <= entry.field){
+            tables.resize(entry.field + 1, nullptr);
+        }
+        tables[entry.field] = &entry;
+    }
+    return true;
+}
+
+const ArchiveTable *SolutionArchive::table(ArchiveField field) const{
+    return field < tables.size() ? tables[field] : nullptr;
+}
+
+const int32_t *SolutionArchive::groupKeys(const ArchiveTable &table) const{
+    return reinterpret_cast<const int32_t *>(data + table.groupKeys);
+}
+
+const uint64_t *SolutionArchive::groupStarts(const ArchiveTable &table) const{
+    return reinterpret_cast<const uint64_t *>(data + table.groupStarts);
+}
+
+const int32_t *SolutionArchive::rowKeys(const ArchiveTable &table) const{
+    return reinterpret_cast<const int32_t *>(data + table.rowKeys);
+}
+
+const uint64_t *SolutionArchive::rowStarts(const ArchiveTable &table) const{
+    return reinterpret_cast<const uint64_t *>(data + table.rowStarts);
+}
+
+/// copies the rows of one group of a field into rows, keyed by the row keys
+template <class T>
+void SolutionArchive::loadRows(ArchiveField field, int group, map<int, vector<T>> &rows) const{
+    const ArchiveTable *fieldTable = table(field);
+    if(fieldTable == nullptr || group >= fieldTable->numberGroups){
+        return;
+    }
+    const uint64_t *starts = rowStarts(*fieldTable);
+    const int32_t *keys = rowKeys(*fieldTable);
+    for(uint64_t r = groupStarts(*fieldTable)[group]; r < groupStarts(*fieldTable)[group + 1]; r++){
+        vector<T> &row = rows[keys[r]];
+        if(fieldTable->valueType == ARCHIVE_INT32){
+            row.assign(values<int32_t>(*fieldTable) + starts[r], values<int32_t>(*fieldTable) + starts[r + 1]);
+        }
+        else{
+            row.assign(values<double>(*fieldTable) + starts[r], values<double>(*fieldTable) + starts[r + 1]);
+        }
+    }
+}
+
+/// rows keyed by their index back into a list
+template <class T>
+static vector<vector<T>> rowList(map<int, vector<T>> &rows){
+    vector<vector<T>> list(rows.empty() ? 0 : max(0, rows.rbegin()->first + 1));
+    for(auto &row: rows){
+        if(row.first >= 0){
+            list[row.first] = move(row.second);
+        }
+    }
+    return list;
+}
+
+/// copies the rows of a per stop field into the stops of the bus they are keyed by. The rows are written in the order
+/// of the buses, older archives sort them by bus, so the rows are placed by key. Stops missing from a row keep 0
+template <class T>
+void SolutionArchive::loadStops(ArchiveField field, const map<int, int> &busIndices, const vector<int> &stopStart,
+                                vector<T> &stops) const{
+    const ArchiveTable *fieldTable = table(field);
+    if(fieldTable == nullptr || fieldTable->numberGroups == 0 || fieldTable->numberRows == 0){
+        return;
+    }
+    stops = vector<T>(stopStart.back(), T());
+    const uint64_t *starts = rowStarts(*fieldTable);
+    const int32_t *keys = rowKeys(*fieldTable);
+    for(uint64_t r = groupStarts(*fieldTable)[0]; r < groupStarts(*fieldTable)[1]; r++){
+        auto busIndex = busIndices.find(keys[r]);
+        if(busIndex == busIndices.end()){
+            continue;
+        }
+        int n = busIndex->second;
+        uint64_t count = min(starts[r + 1] - starts[r], (uint64_t) (stopStart[n + 1] - stopStart[n]));
+        if(fieldTable->valueType == ARCHIVE_INT32){
+            copy_n(values<int32_t>(*fieldTable) + starts[r], count, stops.begin() + stopStart[n]);
+        }
+        else{
+            copy_n(values<double>(*fieldTable) + starts[r], count, stops.begin() + stopStart[n]);
+        }
+    }
+}
+
+/// reads the CEW entries, version 1 archives hold the dense CEW fields which are reduced to the entries
+void SolutionArchive::loadCleanEnergy(primitiveVariables &solution) const{
+    const ArchiveTable *windowTable = table(ARCHIVE_CLEAN_ENERGY_WINDOW);
+    if(windowTable != nullptr){
+        map<int, vector<int>> windows, buses, stops, charges;
+        map<int, vector<double>> energies, chargeTimes;
+        loadRows(ARCHIVE_CLEAN_ENERGY_WINDOW, 0, windows);
+        loadRows(ARCHIVE_CLEAN_ENERGY_BUS, 0, buses);
+        loadRows(ARCHIVE_CLEAN_ENERGY_STOP, 0, stops);
+        loadRows(ARCHIVE_CLEAN_ENERGY_AMOUNT, 0, energies);
+        loadRows(ARCHIVE_CLEAN_ENERGY_TIME, 0, chargeTimes);
+        loadRows(ARCHIVE_CLEAN_ENERGY_CHARGE, 0, charges);
+        int numberEntries = windows[0].size();
+        if(buses[0].size() != numberEntries || stops[0].size() != numberEntries ||
+           energies[0].size() != numberEntries || chargeTimes[0].size() != numberEntries ||
+           charges[0].size() != numberEntries){
+            return;
+        }
+        for(int e = 0; e < numberEntries; e++){
+            int n = buses[0][e];
+            if(n < 0 || n >= solution.buses.size() || stops[0][e] < 0 || stops[0][e] >= solution.numberStops(n)){
+                continue;
+            }
+            solution.cleanEnergy.push_back({windows[0][e], n, stops[0][e], energies[0][e], chargeTimes[0][e],
+                                            charges[0][e]});
+        }
+        return;
+    }
+
+    nestedVariables nested;
+    nested.powerExcess = solution.powerExcess;
+    map<int, vector<int>> intRows;
+    map<int, vector<double>> doubleRows;
+    const ArchiveTable *energyTable = table(ARCHIVE_WINDOW_ENERGY_USED);
+    for(int g = 0; energyTable != nullptr && g < energyTable->numberGroups; g++){
+        int k = groupKeys(*energyTable)[g];
+        if(k < 0){
+            continue;
+        }
+        if(nested.windowEnergyUsed.size() <= k){
+            nested.windowEnergyUsed.resize(k + 1);
+        }
+        loadRows(ARCHIVE_WINDOW_ENERGY_USED, g, nested.windowEnergyUsed[k]);
+    }
+    const ArchiveTable *timeTable = table(ARCHIVE_CLEAN_CHARGE_TIME);
+    for(int g = 0; timeTable != nullptr && g < timeTable->numberGroups; g++){
+        loadRows(ARCHIVE_CLEAN_CHARGE_TIME, g, doubleRows);
+        nested.cleanChargeTime[groupKeys(*timeTable)[g]] = rowList(doubleRows);
+        doubleRows.clear();
+    }
+    const ArchiveTable *chargeTable = table(ARCHIVE_CLEAN_WINDOW_CHARGE);
+    for(int g = 0; chargeTable != nullptr && g < chargeTable->numberGroups; g++){
+        loadRows(ARCHIVE_CLEAN_WINDOW_CHARGE, g, intRows);
+        nested.cleanWindowCharge[groupKeys(*chargeTable)[g]] = rowList(intRows);
+        intRows.clear();
+    }
+    solution.cleanEnergy = flattenCleanEnergy(nested, solution);
+}
+
+primitiveVariables SolutionArchive::load() const{
+    primitiveVariables solution;
+    map<int, vector<int>> intRows;
+    map<int, vector<double>> doubleRows;
+
+    loadRows(ARCHIVE_BUSES, 0, intRows);
+    solution.buses = intRows[0];
+    intRows.clear();
+    loadRows(ARCHIVE_CHARGING_STATIONS, 0, intRows);
+    solution.chargingStations = intRows[0];
+    intRows.clear();
+
+    /// the number of stops of each bus is the length of its row of busSequences
+    loadRows(ARCHIVE_BUS_SEQUENCES, 0, intRows);
+    map<int, int> busIndices = solution.busIndices();
+    for(int b: solution.buses){
+        auto sequence = intRows.find(b);
+        solution.stopStart.push_back(solution.stopStart.back() +
+                                     (sequence == intRows.end() ? 0 : sequence->second.size()));
+    }
+    intRows.clear();
+
+    loadStops(ARCHIVE_BUS_SEQUENCES, busIndices, solution.stopStart, solution.busSequences);
+    loadStops(ARCHIVE_NON_RENEWABLE, busIndices, solution.stopStart, solution.nonRenewable);
+    loadStops(ARCHIVE_ARRIVAL_TIME, busIndices, solution.stopStart, solution.arrivalTime);
+    loadStops(ARCHIVE_SCHEDULED_TIME, busIndices, solution.stopStart, solution.scheduledTime);
+    loadStops(ARCHIVE_DEVIATION_TIME, busIndices, solution.stopStart, solution.deviationTime);
+    loadStops(ARCHIVE_CAPACITY, busIndices, solution.stopStart, solution.capacity);
+    loadStops(ARCHIVE_CHARGE_TIME, busIndices, solution.stopStart, solution.chargeTime);
+    loadStops(ARCHIVE_CHARGE_AMOUNT, busIndices, solution.stopStart, solution.chargeAmount);
+    loadStops(ARCHIVE_CHARGE, busIndices, solution.stopStart, solution.charge);
+    loadStops(ARCHIVE_ASES, busIndices, solution.stopStart, solution.ases);
+    loadStops(ARCHIVE_DISCOUNTS, busIndices, solution.stopStart, solution.discounts);
+
+    loadRows(ARCHIVE_POWER_EXCESS, 0, doubleRows);
+    for(auto &window: rowList(doubleRows)){
+        if(window.size() == 3){
+            solution.powerExcess.push_back({window[0], window[1], window[2]});
+        }
+    }
+    doubleRows.clear();
+
+    loadCleanEnergy(solution);
+    return solution;
+}
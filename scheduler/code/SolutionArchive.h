@@ -0,0 +1,116 @@
+#ifndef SCHEDULER_SOLUTION_ARCHIVE_H
+#define SCHEDULER_SOLUTION_ARCHIVE_H
+#include "string"
+#include "vector"
+#include "cstdint"
+#include "DataStructures.h"
+
+using namespace std;
+
+/// the fields of primitiveVariables stored in a solution archive. New fields are added at the end, readers skip the
+/// fields they do not know. Version 1 archives hold the CEW as the dense fields ARCHIVE_WINDOW_ENERGY_USED,
+/// ARCHIVE_CLEAN_CHARGE_TIME and ARCHIVE_CLEAN_WINDOW_CHARGE, later versions as the ARCHIVE_CLEAN_ENERGY fields which
+/// hold one value for each entry of primitiveVariables::cleanEnergy
+enum ArchiveField : uint32_t{
+    ARCHIVE_BUSES = 0,
+    ARCHIVE_CHARGING_STATIONS,
+    ARCHIVE_BUS_SEQUENCES,
+    ARCHIVE_NON_RENEWABLE,
+    ARCHIVE_ARRIVAL_TIME,
+    ARCHIVE_SCHEDULED_TIME,
+    ARCHIVE_DEVIATION_TIME,
+    ARCHIVE_CAPACITY,
+    ARCHIVE_CHARGE_TIME,
+    ARCHIVE_CHARGE_AMOUNT,
+    ARCHIVE_CHARGE,
+    /// T_ij and D_ij, only written by archives before the distances were shared, they are skipped
+    ARCHIVE_TRIP_TIME,
+    ARCHIVE_TRIP_COST,
+    ARCHIVE_POWER_EXCESS,
+    ARCHIVE_WINDOW_ENERGY_USED,
+    ARCHIVE_ASES,
+    ARCHIVE_DISCOUNTS,
+    ARCHIVE_CLEAN_CHARGE_TIME,
+    ARCHIVE_CLEAN_WINDOW_CHARGE,
+    ARCHIVE_CLEAN_ENERGY_WINDOW,
+    ARCHIVE_CLEAN_ENERGY_BUS,
+    ARCHIVE_CLEAN_ENERGY_STOP,
+    ARCHIVE_CLEAN_ENERGY_AMOUNT,
+    ARCHIVE_CLEAN_ENERGY_TIME,
+    ARCHIVE_CLEAN_ENERGY_CHARGE
+};
+
+enum ArchiveValueType : uint32_t{
+    ARCHIVE_INT32 = 0,
+    ARCHIVE_FLOAT64 = 1
+};
+
+/// the start of every archive
+struct ArchiveHeader{
+    char magic[8];
+    uint32_t version;
+    uint32_t numberTables;
+    uint64_t fileSize;
+};
+
+/// one field of the archive. A field is a list of groups, each group a list of rows and each row a list of values, e.g.
+/// arrivalTime has a single group with a row for each bus, in the order of buses. The keys of the groups and rows are the bus, stop
+/// or window they belong to. Starts are indices into the next level, offsets are bytes from the start of the file and
+/// every section is 8 byte aligned, so the values can be used in place once the file is mapped
+struct ArchiveTable{
+    uint32_t field;
+    uint32_t valueType;
+    uint64_t numberGroups;
+    uint64_t numberRows;
+    uint64_t numberValues;
+    uint64_t groupKeys;
+    uint64_t groupStarts;
+    uint64_t rowKeys;
+    uint64_t rowStarts;
+    uint64_t values;
+};
+
+/// Versioned binary solution file with one flat column per field of primitiveVariables. Files are little endian and
+/// read through a memory mapping without a parse pass; load() only copies the rows into the per stop arrays.
+class SolutionArchive{
+public:
+    static const uint32_t version = 2;
+
+    SolutionArchive() = default;
+    ~SolutionArchive();
+    SolutionArchive(const SolutionArchive &) = delete;
+    SolutionArchive &operator=(const SolutionArchive &) = delete;
+
+    static void write(const primitiveVariables &solution, string solutionFile);
+    /// true if the file starts with the archive magic, text archives written by boost do not
+    static bool isArchive(string solutionFile);
+
+    /// maps the file and checks that every table lies within it, error describes the problem if false is returned
+    bool open(string solutionFile, string &error);
+    void close();
+    primitiveVariables load() const;
+
+    const ArchiveTable *table(ArchiveField field) const;
+    const int32_t *groupKeys(const ArchiveTable &table) const;
+    const uint64_t *groupStarts(const ArchiveTable &table) const;
+    const int32_t *rowKeys(const ArchiveTable &table) const;
+    const uint64_t *rowStarts(const ArchiveTable &table) const;
+    template <class T>
+    const T *values(const ArchiveTable &table) const{
+        return reinterpret_cast<const T *>(data + table.values);
+    }
+
+private:
+    template <class T>
+    void loadRows(ArchiveField field, int group, map<int, vector<T>> &rows) const;
+    template <class T>
+    void loadStops(ArchiveField field, const map<int, int> &busIndices, const vector<int> &stopStart,
+                   vector<T> &stops) const;
+    void loadCleanEnergy(primitiveVariables &solution) const;
+
+    const char *data = nullptr;
+    uint64_t size = 0;
+    vector<const ArchiveTable *> tables;
+};
+
+#endif //SCHEDULER_SOLUTION_ARCHIVE_H
@@ -0,0 +1,115 @@
+#include "Solver.h"
+#include "chrono"
+#include "MpsWriter.h"
+#include "GreedyScheduler.h"
+#include "RunMetrics.h"
+
+using namespace std;
+
+Solver::Solver(const RunConfig &config, ostream &out): config(config), out(out){}
+
+primitiveVariables Solver::solve(SchedulingProblem &problem, primitiveVariables *previousSchedule,
+                                 primitiveVariables *startSchedule){
+    lastResult = SolverResult();
+    solveTime = 0.0;
+
+    /// export the created MIP model for debugging purposes, this should be disabled (--modelFile "") if not used as it
+    /// might take up a large amount of space.
+    string backendName = config.backend.empty() ? defaultSolverBackend() : config.backend;
+    if(!config.modelFile.empty() && backendName != "mps"){
+        PhaseTimer timer("solve.export");
+        MpsWriter writer;
+        writer.write(problem.model, config.modelFile);
+    }
+
+    backend = createSolverBackend(backendName, config.modelFile);
+    if(!backend){
+        lastResult.status = "Solver backend " + backendName + " is not available in this build";
+        cerr << lastResult.status << endl;
+        return primitiveVariables();
+    }
+    if(problem.model.hasIndicatorRows() && !backend->supportsIndicatorRows()){
+        lastResult.status = "Solver backend " + backendName +
+                            " does not support indicator rows, use --formulation bigM";
+        cerr << lastResult.status << endl;
+        backend.reset();
+        return primitiveVariables();
+    }
+
+    out << "Solving..." << endl;
+    {
+        PhaseTimer timer("solve.load");
+        backend->loadModel(problem.model);
+    }
+
+    if(startSchedule != nullptr){
+        vector<double> startValues = problem.primitiveToColumns(*startSchedule);
+        backend->setMIPStart(startValues);
+        out << "Start schedule given. Violated rows and bounds: " << problem.model.countViolations(startValues, 1e-6)
+            << endl;
+    }
+    /// build a schedule with the greedy heuristic and use it as a MIP start, so the search does not start cold
+    else if(config.greedyStart){
+        PhaseTimer timer("solve.greedyStart");
+        auto heuristicStartTime = chrono::steady_clock::now();
+        GreedyScheduler heuristic(config);
+        primitiveVariables greedySchedule = heuristic.buildSchedule(problem.parameters, problem.cleanEnergyWindows(),
+                                                                    config.recalculate ? previousSchedule : nullptr,
+                                                                    config.horizonStartTime);
+        vector<double> startValues = problem.primitiveToColumns(greedySchedule);
+        backend->setMIPStart(startValues);
+        out << "Greedy start objective: " << heuristic.objectiveValue() << "\tInfeasible buses: "
+            << heuristic.infeasibleBuses() << "\tViolated rows and bounds: "
+            << problem.model.countViolations(startValues, 1e-6) << "\tTime (ms): "
+            << chrono::duration<double, milli>(chrono::steady_clock::now() - heuristicStartTime).count() << endl;
+    }
+
+    return search(problem, config.warmingSolutionFile);
+}
+
+primitiveVariables Solver::resolve(SchedulingProblem &problem, const ModelChanges &changes,
+                                   primitiveVariables &startSchedule){
+    if(!backend){
+        return solve(problem);
+    }
+    out << "Solving..." << endl;
+    backend->updateModel(problem.model, changes);
+    vector<double> startValues = problem.primitiveToColumns(startSchedule);
+    backend->setMIPStart(startValues);
+    out << "Previous schedule as start. Violated rows and bounds: " << problem.model.countViolations(startValues, 1e-6)
+        << endl;
+
+    /// the previous schedule replaces the warming solution file
+    return search(problem, "");
+}
+
+primitiveVariables Solver::search(SchedulingProblem &problem, const string &warmingSolutionFile){
+    SolverSettings settings;
+    settings.timeout = config.timeout;
+    settings.maxSolutions = config.maxSolutions;
+    settings.threads = config.threads;
+    settings.warmingSolutionFile = warmingSolutionFile;
+    settings.solutionFile = config.solutionFile;
+    settings.logFile = config.logFile;
+    settings.exactIntegrality = !problem.model.hasIndicatorRows();
+
+    /// begin the search process
+    PhaseTimer searchTimer("solve.search");
+    lastResult = backend->solve(settings);
+    solveTime = searchTimer.stop();
+    if(!lastResult.solved){
+        return primitiveVariables();
+    }
+
+    /// convert the values of the best solution into basic data-types (i.e., int, float)
+    PhaseTimer timer("solve.extract");
+    return problem.solutionToPrimitive(lastResult.values);
+}
+
+const SolverResult &Solver::result() const{
+    return lastResult;
+}
+
+double Solver::elapsedTime() const{
+    return solveTime;
+}
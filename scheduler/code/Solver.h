@@ -0,0 +1,40 @@
+#ifndef SCHEDULER_SOLVER_H
+#define SCHEDULER_SOLVER_H
+#include "iostream"
+#include "DataStructures.h"
+#include "RunConfig.h"
+#include "SolverBackend.h"
+#include "SchedulingProblem.h"
+
+using namespace std;
+
+/// solves a SchedulingProblem with the backend selected by the configuration, starting from the greedy schedule
+class Solver{
+public:
+    explicit Solver(const RunConfig &config, ostream &out = cout);
+
+    /// returns the best schedule found, which has no buses if no solution was found. startSchedule is used as the MIP
+    /// start instead of the greedy schedule if it is given
+    primitiveVariables solve(SchedulingProblem &problem, primitiveVariables *previousSchedule = nullptr,
+                             primitiveVariables *startSchedule = nullptr);
+
+    /// solve the problem again after it was changed. The backend of the previous solve keeps its model and only the
+    /// changes are applied, startSchedule is used as the MIP start
+    primitiveVariables resolve(SchedulingProblem &problem, const ModelChanges &changes,
+                               primitiveVariables &startSchedule);
+
+    /// the outcome of the last solve and its duration in seconds
+    const SolverResult &result() const;
+    double elapsedTime() const;
+
+private:
+    primitiveVariables search(SchedulingProblem &problem, const string &warmingSolutionFile);
+
+    RunConfig config;
+    ostream &out;
+    unique_ptr<SolverBackend> backend;
+    SolverResult lastResult;
+    double solveTime = 0.0;
+};
+
+#endif //SCHEDULER_SOLVER_H
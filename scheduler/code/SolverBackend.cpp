@@ -0,0 +1,37 @@
+#include "SolverBackend.h"
+#include "MpsWriter.h"
+#ifdef HAS_CPLEX
+#include "CplexBackend.h"
+#endif
+#ifdef HAS_HIGHS
+#include "HighsBackend.h"
+#endif
+
+using namespace std;
+
+unique_ptr<SolverBackend> createSolverBackend(const string &backendName, const string &modelFile){
+#ifdef HAS_CPLEX
+    if(backendName == "cplex"){
+        return unique_ptr<SolverBackend>(new CplexBackend());
+    }
+#endif
+#ifdef HAS_HIGHS
+    if(backendName == "highs"){
+        return unique_ptr<SolverBackend>(new HighsBackend());
+    }
+#endif
+    if(backendName == "mps"){
+        return unique_ptr<SolverBackend>(new MpsBackend(modelFile));
+    }
+    return nullptr;
+}
+
+string defaultSolverBackend(){
+#if defined(HAS_CPLEX)
+    return "cplex";
+#elif defined(HAS_HIGHS)
+    return "highs";
+#else
+    return "mps";
+#endif
+}
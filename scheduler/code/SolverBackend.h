@@ -0,0 +1,62 @@
+#ifndef SCHEDULER_SOLVER_BACKEND_H
+#define SCHEDULER_SOLVER_BACKEND_H
+#include "string"
+#include "vector"
+#include "memory"
+#include "ModelIR.h"
+
+using namespace std;
+
+/// settings shared by all solvers, a value of 0 means no limit
+struct SolverSettings{
+    int timeout = 0;
+    int maxSolutions = 0;
+    int threads = 0;
+    string logFile;
+    string warmingSolutionFile;
+    string solutionFile;
+
+    /// the big-M rows are only exact for integral binaries, so the integrality tolerance is set to 0. Not needed if
+    /// the disjunctions are indicator rows
+    bool exactIntegrality = true;
+};
+
+/// the outcome of a solve, values holds one value for each column of the model
+struct SolverResult{
+    bool solved = false;
+    string status;
+    double objectiveValue = 0.0;
+    double relativeGap = 0.0;
+    vector<double> values;
+};
+
+/// interface implemented by each solver the model can be handed to
+class SolverBackend{
+public:
+    virtual ~SolverBackend() = default;
+    virtual string name() const = 0;
+    virtual void loadModel(const ModelIR &model) = 0;
+
+    /// bring the loaded model up to date: the bounds of the changed columns and rows are updated and the columns and
+    /// rows added since the model was loaded are appended. By default the whole model is loaded again
+    virtual void updateModel(const ModelIR &model, const ModelChanges &changes){
+        loadModel(model);
+    }
+
+    /// values for every column which are handed to the solver as a starting solution, ignored by default
+    virtual void setMIPStart(const vector<double> &values){}
+
+    /// whether the indicator rows of a ModelIR can be passed to the solver
+    virtual bool supportsIndicatorRows() const{
+        return false;
+    }
+    virtual SolverResult solve(const SolverSettings &settings) = 0;
+};
+
+/// create the backend with the given name (cplex, highs or mps), returns nullptr if it is not available in this build
+unique_ptr<SolverBackend> createSolverBackend(const string &backendName, const string &modelFile);
+
+/// the backend used when none is given on the command line
+string defaultSolverBackend();
+
+#endif //SCHEDULER_SOLVER_BACKEND_H
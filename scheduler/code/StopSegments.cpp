@@ -0,0 +1,158 @@
+#include "StopSegments.h"
+#include "algorithm"
+#include "cmath"
+#include "ModelIR.h"
+
+using namespace std;
+
+/// the bounds of t_bi
+static const double EARLIEST_ARRIVAL = 0.0;
+static const double LATEST_ARRIVAL = 24.0;
+
+void StopSegments::build(const ModelParameters &parameters, const vector<int> &chargingStation, double deviationTime,
+                         double maxChargeTime, bool compress){
+    int numberStops = parameters.totalStops();
+    kept = vector<char>(numberStops, 1);
+    previousKept = vector<int>(numberStops, -1);
+    allowedDeviation = vector<double>(numberStops, deviationTime);
+    segmentCost = vector<double>(numberStops, 0.0);
+    segmentTime = vector<double>(numberStops, 0.0);
+    earliestArrival = vector<double>(numberStops, -INFINITE_BOUND);
+    latestDeparture = vector<double>(numberStops, INFINITE_BOUND);
+
+    for(int n = 0; n < parameters.numberBuses(); n++){
+        int first = parameters.stopStart[n];
+        int end = parameters.stopStart[n + 1];
+        allowedDeviation[first] = 0.0;
+        for(int i = first + 1; i < end; i++){
+            /// a driver rest at the same station keeps the following stop on time
+            if(parameters.rests[i - 1] == 1 && parameters.stations[i] == parameters.stations[i - 1]){
+                allowedDeviation[i] = 0.0;
+            }
+            if(compress && i < end - 1 && chargingStation[parameters.stations[i]] != 1){
+                kept[i] = 0;
+            }
+        }
+
+        /// the sums of the current segment, and its bounds on the arrival at its end and the departure from its start
+        int previous = first;
+        double cost = 0.0;
+        double time = 0.0;
+        double earliest = -INFINITE_BOUND;
+        double latest = INFINITE_BOUND;
+        for(int i = first + 1; i < end; i++){
+            previousKept[i] = previous;
+            cost += parameters.legCost[i];
+            time += parameters.legTime[i];
+            earliest += parameters.legTime[i];
+            if(kept[i]){
+                segmentCost[i] = cost;
+                segmentTime[i] = time;
+                earliestArrival[i] = earliest;
+                latestDeparture[i] = latest;
+                previous = i;
+                cost = 0.0;
+                time = 0.0;
+                earliest = -INFINITE_BOUND;
+                latest = INFINITE_BOUND;
+                continue;
+            }
+            double lower = max(EARLIEST_ARRIVAL, parameters.scheduledTimes[i] - allowedDeviation[i]);
+            double upper = min(LATEST_ARRIVAL, parameters.scheduledTimes[i] + allowedDeviation[i]);
+            earliest = max(earliest, lower);
+            latest = earliest > upper ? -1.0 : min(latest, upper - time);
+        }
+    }
+    propagateBounds(parameters, chargingStation, maxChargeTime);
+}
+
+/// forward over the kept stops of each bus the arrival can not be earlier than the earliest departure from the
+/// previous kept stop plus the segment time (constraint 3.7), backwards the departure can not be later than the
+/// latest arrival at the next kept stop minus the segment time
+void StopSegments::propagateBounds(const ModelParameters &parameters, const vector<int> &chargingStation,
+                                   double maxChargeTime){
+    int numberStops = parameters.totalStops();
+    chargeLimit = vector<double>(numberStops, 0.0);
+    arrivalLower = vector<double>(numberStops, EARLIEST_ARRIVAL);
+    arrivalUpper = vector<double>(numberStops, LATEST_ARRIVAL);
+    departureUpper = vector<double>(numberStops, LATEST_ARRIVAL);
+
+    for(int n = 0; n < parameters.numberBuses(); n++){
+        int first = parameters.stopStart[n];
+        int end = parameters.stopStart[n + 1];
+        int last = first;
+        for(int i = first; i < end; i++){
+            if(!kept[i]){
+                continue;
+            }
+            /// constraint 3.3, only a charging station allows a charge
+            chargeLimit[i] = chargingStation[parameters.stations[i]] == 1 ? maxChargeTime : 0.0;
+            arrivalLower[i] = max(EARLIEST_ARRIVAL, parameters.scheduledTimes[i] - allowedDeviation[i]);
+            arrivalUpper[i] = min(LATEST_ARRIVAL, parameters.scheduledTimes[i] + allowedDeviation[i]);
+            if(i > first){
+                arrivalLower[i] = max(arrivalLower[i], max(earliestArrival[i],
+                                                           arrivalLower[previousKept[i]] + segmentTime[i]));
+            }
+            departureUpper[i] = arrivalUpper[i] + chargeLimit[i];
+            last = i;
+        }
+        for(int i = last; i > first; i--){
+            if(!kept[i]){
+                continue;
+            }
+            int j = previousKept[i];
+            departureUpper[j] = min(departureUpper[j], min(arrivalUpper[i] - segmentTime[i], latestDeparture[i]));
+            arrivalUpper[j] = min(arrivalUpper[j], departureUpper[j]);
+        }
+    }
+}
+
+void StopSegments::expand(const ModelParameters &parameters, primitiveVariables &schedule, double horizonEndTime,
+                          bool spm) const{
+    vector<double> latestArrival;
+    for(int b = 0; b < kept.size(); b++){
+        int a = previousKept[b];
+        if(!kept[b] || a < 0 || b - a == 1){
+            continue;
+        }
+
+        /// the latest arrival at each skipped stop which still reaches b at its arrival time
+        latestArrival = vector<double>(b - a);
+        double latest = schedule.arrivalTime[b];
+        for(int i = b - 1; i > a; i--){
+            latest = min(latest - parameters.legTime[i + 1],
+                         min(LATEST_ARRIVAL, parameters.scheduledTimes[i] + allowedDeviation[i]));
+            latestArrival[i - a] = latest;
+        }
+
+        double departure = schedule.arrivalTime[a] + schedule.chargeTime[a];
+        double capacity = schedule.capacity[a] + schedule.chargeAmount[a];
+        for(int i = a + 1; i < b; i++){
+            double earliest = max(departure + parameters.legTime[i],
+                                  max(EARLIEST_ARRIVAL, parameters.scheduledTimes[i] - allowedDeviation[i]));
+            double arrival = max(earliest, min(parameters.scheduledTimes[i], latestArrival[i - a]));
+            capacity -= parameters.legCost[i];
+            schedule.arrivalTime[i] = arrival;
+            schedule.deviationTime[i] = abs(arrival - parameters.scheduledTimes[i]);
+            schedule.capacity[i] = capacity;
+            schedule.chargeTime[i] = 0.0;
+            schedule.chargeAmount[i] = 0.0;
+            schedule.nonRenewable[i] = 0.0;
+            schedule.charge[i] = 0;
+            /// ase_bi has to be 1 for arrivals before the end of the checkpoint
+            if(spm){
+                schedule.ases[i] = arrival < horizonEndTime ? 1 : 0;
+                schedule.discounts[i] = 0.0;
+            }
+            departure = arrival;
+        }
+    }
+}
+
+bool StopSegments::isKept(int s) const{
+    return kept[s] == 1;
+}
+
+int StopSegments::numberKept() const{
+    return count(kept.begin(), kept.end(), 1);
+}
@@ -0,0 +1,58 @@
+#ifndef SCHEDULER_STOP_SEGMENTS_H
+#define SCHEDULER_STOP_SEGMENTS_H
+#include "vector"
+#include "DataStructures.h"
+
+using namespace std;
+
+/// Collapses the stops at stations without a charger. At such a stop nothing can be decided: constraint 3.3 forces
+/// x_bi, ct_bi and e_bi to 0, so the battery only drops by the leg costs and the bus only has to stay within the
+/// allowed deviation. The first and the last stop of a bus and every stop at a charging station are kept, the stops
+/// between two kept stops form the segment which ends at the second one. A segment carries the sum of the leg costs
+/// and times, the earliest arrival the skipped stops allow and the latest departure from the previous kept stop which
+/// lets the bus reach every skipped stop in time. The model only has columns for the kept stops, the skipped stops
+/// are filled in by expand. Per stop arrays use the layout of ModelParameters.
+class StopSegments{
+public:
+    /// all stops are kept if compress is false
+    void build(const ModelParameters &parameters, const vector<int> &chargingStation, double deviationTime,
+               double maxChargeTime, bool compress);
+
+    /// fills the values of the skipped stops of a schedule whose kept stops hold the values of the model. The skipped
+    /// stops are placed as close to their scheduled time as the kept stops around them allow
+    void expand(const ModelParameters &parameters, primitiveVariables &schedule, double horizonEndTime,
+                bool spm) const;
+
+    bool isKept(int s) const;
+    int numberKept() const;
+
+    /// whether each stop has columns, and the kept stop before each stop of the same bus (-1 for the first stop)
+    vector<char> kept;
+    vector<int> previousKept;
+
+    /// the largest deviation (in hour decimal) from the scheduled time of each stop, 0 for the first stop and the
+    /// stops after a driver rest at the same station
+    vector<double> allowedDeviation;
+
+    /// for each kept stop, the energy and the time of the legs since the previous kept stop
+    vector<double> segmentCost;
+    vector<double> segmentTime;
+
+    /// for each kept stop, the earliest arrival the skipped stops before it allow (-INFINITE_BOUND if there are none)
+    /// and the latest time the bus can leave the previous kept stop (INFINITE_BOUND if there are none). A skipped stop
+    /// which can not be reached in time whenever the bus leaves gives a latest departure of -1, which no schedule meets
+    vector<double> earliestArrival;
+    vector<double> latestDeparture;
+
+    /// for each kept stop, the bounds on t_bi and on the departure t_bi + ct_bi which follow from the deviation of
+    /// the stops of the bus and the leg times between them, and the longest charge (0 without a charging station)
+    vector<double> arrivalLower;
+    vector<double> arrivalUpper;
+    vector<double> departureUpper;
+    vector<double> chargeLimit;
+
+private:
+    void propagateBounds(const ModelParameters &parameters, const vector<int> &chargingStation, double maxChargeTime);
+};
+
+#endif //SCHEDULER_STOP_SEGMENTS_H
@@ -0,0 +1,259 @@
+#include "SweepRunner.h"
+#include "Parser.h"
+#include "RunConfig.h"
+#include "RunMetrics.h"
+#include "fstream"
+#include "thread"
+#include "atomic"
+#include "chrono"
+#include "algorithm"
+#include "filesystem"
+
+using namespace std;
+
+/// grid values can be given as strings or numbers, numbers are used the same way the shell script used them
+static string gridValue(const json &value){
+    return value.is_string() ? value.get<string>() : value.dump();
+}
+
+SweepRunner::SweepRunner(string gridFile, RunFunction runFunction): runFunction(runFunction){
+    FileReader reader;
+    grid = reader.readJson(gridFile);
+}
+
+/// enumerate the configurations of the grid in the same order and with the same rules as example_scheduler.sh
+vector<SweepChain> SweepRunner::enumerate(){
+    vector<SweepChain> chains;
+    Parser parser;
+    string outputFolder = grid.value("outputFolder", "results");
+    string cewFolder = grid.value("cewFolder", "");
+    string cewStore = grid.value("cewStore", "");
+    string year = gridValue(grid.value("year", json(2022)));
+    string month = gridValue(grid.value("month", json(2)));
+    json horizonStartTimes = grid.at("horizonStartTimes");
+    json horizonEndTimes = grid.at("horizonEndTimes");
+
+    json gridArguments = grid.value("arguments", json::object());
+    map<string, string> commonArguments;
+    for(auto &argument: gridArguments.items()){
+        commonArguments[argument.key()] = gridValue(argument.value());
+    }
+    string solutionSaveFile = commonArguments.count("solutionSaveFile") ? commonArguments["solutionSaveFile"]
+                                                                          : "scheduleDetails";
+    string logFile = commonArguments.count("logFile") ? commonArguments["logFile"] : "logFile.txt";
+    string lpFile = commonArguments.count("LPFile") ? commonArguments["LPFile"] : "solution.lp";
+    string modelFile = commonArguments.count("modelFile") ? commonArguments["modelFile"] : "";
+
+    for(auto &methodValue: grid.at("methods")){
+        string method = gridValue(methodValue);
+        for(auto &location: grid.at("locations")){
+            string locationName = location.at("name");
+            string path = location.value("path", ".");
+            string powerRatio = gridValue(location.at("powerRatio"));
+            string warmingSolutionFile = location.value("warmingSolutionFile", "");
+            if(warmingSolutionFile.find("{method}") != string::npos){
+                warmingSolutionFile.replace(warmingSolutionFile.find("{method}"), 8, method);
+            }
+
+            for(auto &datatypeValue: grid.at("datatypes")){
+                string datatype = gridValue(datatypeValue);
+                for(auto &battery: grid.at("batteries")){
+                    string maxBatteryCapacity = gridValue(battery.at("maxBatteryCapacity"));
+                    string maxChargeTime = gridValue(battery.at("maxChargeTime"));
+                    for(auto &deviationValue: grid.at("deviationTimes")){
+                        string deviationTime = gridValue(deviationValue);
+                        for(int d = 0; d < grid.at("dates").size(); d++){
+                            string date = gridValue(grid.at("dates")[d]);
+                            /// without clean energy the date makes no difference, so only the first one is used
+                            if(datatype == "noClean" && d > 0){
+                                continue;
+                            }
+
+                            SweepChain chain;
+                            chain.location = locationName;
+                            for(int t = 0; t < horizonStartTimes.size(); t++){
+                                string horizonStartTime = gridValue(horizonStartTimes[t]);
+                                string horizonEndTime = gridValue(horizonEndTimes[t]);
+                                /// only predicted CEW are recalculated at each checkpoint, otherwise the whole day
+                                /// is scheduled at once
+                                if(datatype != "predicted"){
+                                    if(stod(horizonStartTime) != 0){
+                                        continue;
+                                    }
+                                    horizonEndTime = "24";
+                                }
+
+                                SweepRun run;
+                                run.arguments = commonArguments;
+                                if(datatype == "noClean"){
+                                    run.arguments["CEW"] = "18.00-24.00=0,";
+                                }
+                                else if(!cewStore.empty()){
+                                    run.arguments["cewStore"] = cewStore;
+                                    run.arguments["cewKey"] = datatype + "/" + method + "/" + year + "-" + month +
+                                                              "-" + date + "-" + horizonStartTime;
+                                }
+                                else{
+                                    run.arguments["CEW"] = parser.readCEWFile(cewFolder + "/" + datatype + "/" +
+                                                                              method + "/" + year + "-" + month +
+                                                                              "-" + date + "-" + horizonStartTime +
+                                                                              ".txt");
+                                }
+                                run.resultDirectory = outputFolder + "/" + locationName + "/" + datatype + "/" +
+                                                      method + "/" + date + "_" + locationName + "_" +
+                                                      maxBatteryCapacity + "_" + deviationTime + "_" +
+                                                      run.arguments["busSpeed"] + "_" + horizonStartTime + "_" +
+                                                      powerRatio;
+
+                                run.arguments["method"] = method;
+                                run.arguments["location"] = locationName;
+                                run.arguments["powerRatio"] = powerRatio;
+                                run.arguments["busDataFile"] = path + "/" + run.arguments["busDataFile"];
+                                run.arguments["stationDataFile"] = path + "/" + run.arguments["stationDataFile"];
+                                run.arguments["stationDistanceFile"] = path + "/" + run.arguments["stationDistanceFile"];
+                                run.arguments["chargingStationsFile"] = location.at("chargingStationsFile");
+                                run.arguments["maxBatteryCapacity"] = maxBatteryCapacity;
+                                run.arguments["maxChargeTime"] = maxChargeTime;
+                                run.arguments["deviationTime"] = deviationTime;
+                                run.arguments["horizonStartTime"] = horizonStartTime;
+                                run.arguments["horizonEndTime"] = horizonEndTime;
+
+                                /// every run writes into its own directory, so concurrent runs never share a file
+                                run.arguments["solutionSaveFile"] = run.resultDirectory + "/" + solutionSaveFile;
+                                run.arguments["logFile"] = run.resultDirectory + "/" + logFile;
+                                run.arguments["LPFile"] = run.resultDirectory + "/" + lpFile;
+                                if(run.arguments.count("resultFile")){
+                                    run.arguments["resultFile"] = run.resultDirectory + "/" +
+                                                                  run.arguments["resultFile"];
+                                }
+                                run.arguments["modelFile"] = modelFile.empty() ? "" : run.resultDirectory + "/" +
+                                                                                      modelFile;
+                                run.arguments["threads"] = gridValue(grid.value("threadsPerSolve", json(0)));
+
+                                /// a recalculation starts from the solution of the previous horizon of the chain
+                                if(chain.runs.empty()){
+                                    run.arguments["warmingSolutionFile"] = warmingSolutionFile;
+                                }
+                                else{
+                                    run.arguments["recalculate"] = "true";
+                                    run.arguments["warmingSolutionFile"] = chain.runs.back().arguments["LPFile"];
+                                    run.arguments["solutionDataFile"] = chain.runs.back().arguments["solutionSaveFile"];
+                                }
+                                chain.runs.push_back(run);
+                            }
+                            if(!chain.runs.empty()){
+                                chains.push_back(chain);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return chains;
+}
+
+void SweepRunner::runChain(const SweepChain &chain, const ModelParameters &locationParameters){
+    Parser parser;
+    primitiveVariables previousSolution;
+    for(int t = 0; t < chain.runs.size(); t++){
+        const SweepRun &run = chain.runs[t];
+        auto startTime = chrono::steady_clock::now();
+        filesystem::create_directories(run.resultDirectory);
+        ofstream result(run.resultDirectory + "/result.txt");
+        RunMetrics metrics(run.arguments.count("perfCounters") && run.arguments.at("perfCounters") == "true");
+        MetricsScope metricsScope(metrics);
+        for(auto &keyVal: run.arguments){
+            result << keyVal.first << ":" << keyVal.second << endl;
+        }
+
+        ModelParameters parameters = locationParameters;
+        double powerRatio = stod(run.arguments.at("powerRatio"));
+        if(run.arguments.count("cewKey")){
+            parameters.cleanEnergyWindows = parser.parseCEWStore(run.arguments.at("cewStore"),
+                                                                 run.arguments.at("cewKey"), powerRatio, result);
+        }
+        else{
+            parameters.cleanEnergyWindows = parser.parseCleanEnergyWindows(run.arguments.at("CEW"), powerRatio,
+                                                                           result);
+        }
+        previousSolution = runFunction(previousSolution, parameters, run.arguments, result);
+        result.close();
+        metrics.write(run.resultDirectory + "/metrics.json");
+
+        lock_guard<mutex> lock(outputMutex);
+        finishedRuns++;
+        cout << "[" << finishedRuns << "/" << totalRuns << "] " << run.resultDirectory << "\tTime (s): "
+             << chrono::duration<double>(chrono::steady_clock::now() - startTime).count() << endl;
+
+        /// the following horizons can not be recalculated without a solution for this one
+        if(previousSolution.buses.empty() && t + 1 < chain.runs.size()){
+            cout << "No solution found for " << run.resultDirectory << ", skipping the remaining "
+                 << chain.runs.size() - t - 1 << " horizons of this chain" << endl;
+            finishedRuns += chain.runs.size() - t - 1;
+            break;
+        }
+    }
+}
+
+void SweepRunner::run(){
+    vector<SweepChain> chains = enumerate();
+
+    /// the chains with the most horizons are started first so they do not end up being the last ones running
+    stable_sort(chains.begin(), chains.end(), [](const SweepChain &a, const SweepChain &b){
+        return a.runs.size() > b.runs.size();
+    });
+    totalRuns = 0;
+    finishedRuns = 0;
+    for(auto &chain: chains){
+        totalRuns += chain.runs.size();
+    }
+
+    /// every run is checked before the first one is started, so a bad grid does not fail half way through the sweep
+    int invalidRuns = 0;
+    for(auto &chain: chains){
+        for(auto &run: chain.runs){
+            vector<string> errors = RunConfig::validate(run.arguments);
+            if(!errors.empty()){
+                invalidRuns++;
+                cout << "Invalid arguments for " << run.resultDirectory << ":" << endl;
+                for(string &error: errors){
+                    cout << "\t" << error << endl;
+                }
+            }
+        }
+    }
+    if(invalidRuns > 0){
+        cout << invalidRuns << " of " << totalRuns << " runs have invalid arguments" << endl;
+        exit(-1);
+    }
+
+    /// the input files are parsed once for each location, the CEW are added for each run
+    Parser parser;
+    map<string, ModelParameters> locationParameters;
+    for(auto &chain: chains){
+        if(locationParameters.find(chain.location) == locationParameters.end()){
+            locationParameters[chain.location] = parser.parseLocationData(chain.runs[0].arguments);
+        }
+    }
+
+    int threadsPerSolve = grid.value("threadsPerSolve", 0);
+    int defaultSolves = max(1, (int) thread::hardware_concurrency() / max(1, threadsPerSolve));
+    int concurrentSolves = min((int) chains.size(), grid.value("concurrentSolves", defaultSolves));
+    cout << "Sweep: " << totalRuns << " runs in " << chains.size() << " chains, " << concurrentSolves
+         << " concurrent solves with " << threadsPerSolve << " threads each" << endl;
+
+    /// each worker takes the next chain which has not been started yet
+    atomic<int> nextChain(0);
+    vector<thread> workers;
+    for(int w = 0; w < concurrentSolves; w++){
+        workers.emplace_back([&](){
+            for(int c = nextChain++; c < chains.size(); c = nextChain++){
+                runChain(chains[c], locationParameters.at(chains[c].location));
+            }
+        });
+    }
+    for(auto &worker: workers){
+        worker.join();
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef SCHEDULER_SWEEP_RUNNER_H
+#define SCHEDULER_SWEEP_RUNNER_H
+#include "string"
+#include "vector"
+#include "map"
+#include "functional"
+#include "iostream"
+#include "mutex"
+#include <nlohmann/json.hpp>
+#include "DataStructures.h"
+
+using namespace std;
+using json = nlohmann::json;
+
+/// one configuration of the sweep, arguments are the same as the command line arguments of a single run
+struct SweepRun{
+    map<string, string> arguments;
+    string resultDirectory;
+};
+
+/// the horizons of one (method, location, datatype, capacity, deviation, date) combination. Each horizon is
+/// recalculated from the solution of the previous one, so the runs of a chain are executed in order by one worker
+struct SweepChain{
+    string location;
+    vector<SweepRun> runs;
+};
+
+/// solves a single configuration and prints its results to the given stream, returns the solution which has no buses
+/// if no solution was found
+typedef function<primitiveVariables(primitiveVariables, ModelParameters, map<string, string>, ostream &)> RunFunction;
+
+/// Runs every configuration of a grid file inside one process. The input files of each location are parsed once, and
+/// independent chains are solved concurrently by a fixed number of workers. The CEW are read from the files of
+/// cewFolder, or from the CEW store cewStore if the grid has one.
+class SweepRunner{
+public:
+    SweepRunner(string gridFile, RunFunction runFunction);
+    vector<SweepChain> enumerate();
+    void run();
+
+private:
+    void runChain(const SweepChain &chain, const ModelParameters &locationParameters);
+
+    json grid;
+    RunFunction runFunction;
+    mutex outputMutex;
+    int finishedRuns = 0;
+    int totalRuns = 0;
+};
+
+#endif //SCHEDULER_SWEEP_RUNNER_H
@@ -1,5 +1,8 @@
 #include "Utils.h"
 #include <string.h>
+#include "algorithm"
+#include "atomic"
+#include "thread"
 
 using namespace std;
 
@@ -10,4 +13,25 @@ double Utils::convertTime(string time){
     double minutes = stod(++minutesPointer) / 60;
     double convertedTime = hour + minutes;
     return convertedTime;
-}
\ No newline at end of file
+}
+
+void parallelFor(int count, int threads, const function<void(int)> &task){
+    atomic<int> nextTask(0);
+    auto worker = [&](){
+        for(int t = nextTask++; t < count; t = nextTask++){
+            task(t);
+        }
+    };
+    int workerCount = min(threads, count);
+    if(workerCount <= 1){
+        worker();
+        return;
+    }
+    vector<thread> workers;
+    for(int w = 0; w < workerCount; w++){
+        workers.emplace_back(worker);
+    }
+    for(auto &workerThread: workers){
+        workerThread.join();
+    }
+}
@@ -2,10 +2,15 @@
 #define SCHEDULER_UTILS_H
 #include "string"
 #include "vector"
+#include "functional"
 
 using namespace std;
 class Utils {
 public:
     double convertTime(string time);
 };
+
+/// run task(0) to task(count - 1) on up to threads threads, each thread takes the next task which has not been started
+/// yet. The tasks run on the calling thread if threads is 1 or there is only one task
+void parallelFor(int count, int threads, const function<void(int)> &task);
 #endif //SCHEDULER_UTILS_H
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "WindowIndex.h"
+#include "algorithm"
+
+using namespace std;
+
+void WindowIndex::build(const vector<CleanEnergyWindow> &cews, double deviation, double maxCharge){
+    windows = cews;
+    deviationTime = deviation;
+    maxChargeTime = maxCharge;
+    byStart = vector<int>(windows.size());
+    for(int k = 0; k < windows.size(); k++){
+        byStart[k] = k;
+    }
+    stable_sort(byStart.begin(), byStart.end(), [this](int a, int b){
+        return windows[a].startTime < windows[b].startTime;
+    });
+    startTimes.clear();
+    latestEnd.clear();
+    for(int k: byStart){
+        startTimes.push_back(windows[k].startTime);
+        latestEnd.push_back(latestEnd.empty() ? windows[k].endTime : max(latestEnd.back(), windows[k].endTime));
+    }
+}
+
+/// the CEW which start late enough are a prefix of byStart, it is searched backwards until no earlier CEW ends late
+/// enough. With CEW which do not overlap, only the reachable ones are visited
+void WindowIndex::reachableWindows(double scheduledTime, vector<int> &reachableWindows) const{
+    reachableWindows.clear();
+    double earliestEnd = scheduledTime - deviationTime;
+    double latestStart = scheduledTime + ((deviationTime + maxChargeTime) * 2);
+    int end = upper_bound(startTimes.begin(), startTimes.end(), latestStart) - startTimes.begin();
+    for(int position = end - 1; position >= 0 && latestEnd[position] >= earliestEnd; position--){
+        if(windows[byStart[position]].endTime >= earliestEnd){
+            reachableWindows.push_back(byStart[position]);
+        }
+    }
+    sort(reachableWindows.begin(), reachableWindows.end());
+}
+
+bool WindowIndex::reachable(int k, double scheduledTime) const{
+    return !(windows[k].endTime < scheduledTime - deviationTime ||
+             windows[k].startTime > scheduledTime + ((deviationTime + maxChargeTime) * 2));
+}
+
+int WindowIndex::numberWindows() const{
+    return windows.size();
+}
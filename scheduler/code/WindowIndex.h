@@ -0,0 +1,30 @@
+#ifndef SCHEDULER_WINDOW_INDEX_H
+#define SCHEDULER_WINDOW_INDEX_H
+#include "vector"
+#include "DataStructures.h"
+
+using namespace std;
+
+/// Interval index of the CEW sorted by start time, used to find the CEW a stop can reach. A bus scheduled at t can
+/// arrive up to the deviation time late and charge until t + (deviationTime + maxChargeTime) * 2, so only the CEW
+/// which end after t - deviationTime and start before that time can be used at the stop (constraints 3.16-3.23).
+class WindowIndex{
+public:
+    void build(const vector<CleanEnergyWindow> &windows, double deviationTime, double maxChargeTime);
+
+    /// sets windows to the CEW a stop scheduled at scheduledTime can reach, in increasing order of k
+    void reachableWindows(double scheduledTime, vector<int> &windows) const;
+    bool reachable(int k, double scheduledTime) const;
+    int numberWindows() const;
+
+private:
+    /// the CEW sorted by start time, with the latest end time of the CEW up to each position
+    vector<int> byStart;
+    vector<double> startTimes;
+    vector<double> latestEnd;
+    vector<CleanEnergyWindow> windows;
+    double deviationTime = 0.0;
+    double maxChargeTime = 0.0;
+};
+
+#endif //SCHEDULER_WINDOW_INDEX_H
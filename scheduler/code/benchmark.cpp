@@ -0,0 +1,1066 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include "vector"
+#include "map"
+#include "string"
+#include "filesystem"
+#include "fstream"
+#include "sstream"
+#include "cmath"
+#include "numeric"
+#include "functional"
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <nlohmann/json.hpp>
+#include "ConflictIndex.h"
+#include "Output.h"
+#include "Parser.h"
+#include "SolutionArchive.h"
+#include "BusDataReader.h"
+#include "MappedCSV.h"
+#include "FileReader.h"
+#include "SchedulingProblem.h"
+#include "LagrangianDecomposition.h"
+#include "BusChargePlanner.h"
+#include "GreedyScheduler.h"
+#include "PlacementSearch.h"
+#include "ScheduleSimulator.h"
+#include "CEWStore.h"
+#include "CEWCoarsening.h"
+#include "InstanceGenerator.h"
+#include "RunMetrics.h"
+#include "Solver.h"
+#include "SolverBackend.h"
+
+using namespace std;
+
+/// a synthetic fleet with the same layout as ModelParameters::stations and ModelParameters::scheduledTimes
+struct SyntheticFleet{
+    vector<int> stopStart = {0};
+    vector<int> stations;
+    vector<double> times;
+
+    int numberBuses() const{
+        return stopStart.size() - 1;
+    }
+};
+
+/// buses follow one of a number of random routes through the stations and start at random times of the day
+SyntheticFleet generateFleet(int numberBuses, int numberStations, int stopsPerBus, unsigned int seed){
+    SyntheticFleet fleet;
+    mt19937 generator(seed);
+    uniform_int_distribution<int> stationDistribution(0, numberStations - 1);
+    uniform_real_distribution<double> startDistribution(5.0, 20.0);
+    uniform_real_distribution<double> legDistribution(0.02, 0.1);
+
+    int numberRoutes = max(1, numberBuses / 10);
+    vector<vector<int>> routes(numberRoutes);
+    for(auto &route: routes){
+        for(int i = 0; i < stopsPerBus; i++){
+            route.push_back(stationDistribution(generator));
+        }
+    }
+    for(int b = 0; b < numberBuses; b++){
+        double time = startDistribution(generator);
+        for(int i = 0; i < stopsPerBus; i++){
+            fleet.times.push_back(time);
+            time += legDistribution(generator);
+        }
+        vector<int> &route = routes[b % numberRoutes];
+        fleet.stations.insert(fleet.stations.end(), route.begin(), route.end());
+        fleet.stopStart.push_back(fleet.stations.size());
+    }
+    return fleet;
+}
+
+/// the pairwise bus/stop loop previously used by addConstraints for constraints 3.10-3.15
+long naiveConflictPairs(SyntheticFleet &fleet, double window){
+    long pairs = 0;
+    for(int busIndex = 0; busIndex < fleet.numberBuses(); busIndex++){
+        for(int busIndexD = busIndex + 1; busIndexD < fleet.numberBuses(); busIndexD++){
+            for(int i = fleet.stopStart[busIndex]; i < fleet.stopStart[busIndex + 1]; i++){
+                for(int j = fleet.stopStart[busIndexD]; j < fleet.stopStart[busIndexD + 1]; j++){
+                    if(fleet.stations[j] == fleet.stations[i] && abs(fleet.times[i] - fleet.times[j]) <= window){
+                        pairs++;
+                    }
+                }
+            }
+        }
+    }
+    return pairs;
+}
+
+/// compare the time taken to find the candidate non-overlap pairs with the pairwise loop and the conflict index
+void benchmarkConflicts(){
+    double maxChargeTime = 0.16;
+    double deviationTime = 0.0833;
+    double window = (maxChargeTime + deviationTime) * 2;
+    int numberStations = 200;
+    int stopsPerBus = 40;
+
+    cout << "buses\tstops\tpairs\tloop (ms)\tindex (ms)\tspeed-up" << endl;
+    for(int numberBuses: {100, 500, 2000}){
+        SyntheticFleet fleet = generateFleet(numberBuses, numberStations, stopsPerBus, 42);
+
+        auto loopStart = chrono::steady_clock::now();
+        long loopPairs = naiveConflictPairs(fleet, window);
+        auto loopEnd = chrono::steady_clock::now();
+
+        ConflictIndex conflictIndex;
+        conflictIndex.build(fleet.stopStart, fleet.stations, fleet.times);
+        vector<ConflictPair> indexPairs = conflictIndex.candidatePairs(window);
+        auto indexEnd = chrono::steady_clock::now();
+
+        double loopTime = chrono::duration<double, milli>(loopEnd - loopStart).count();
+        double indexTime = chrono::duration<double, milli>(indexEnd - loopEnd).count();
+        if(loopPairs != indexPairs.size()){
+            cerr << "pair count mismatch for " << numberBuses << " buses: " << loopPairs << " vs "
+                 << indexPairs.size() << endl;
+        }
+        cout << numberBuses << "\t" << numberBuses * stopsPerBus << "\t" << indexPairs.size() << "\t"
+             << loopTime << "\t" << indexTime << "\t" << loopTime / max(indexTime, 1e-9) << endl;
+    }
+}
+
+/// a solution with every field of primitiveVariables filled, sized like a schedule of the given fleet
+primitiveVariables generateSolution(int numberBuses, int numberStations, int stopsPerBus, int numberWindows,
+                                    unsigned int seed){
+    primitiveVariables solution;
+    mt19937 generator(seed);
+    uniform_real_distribution<double> valueDistribution(0.0, 100.0);
+    uniform_int_distribution<int> binaryDistribution(0, 1);
+    uniform_int_distribution<int> stationDistribution(0, numberStations - 1);
+    auto doubles = [&](int size){
+        vector<double> values(size);
+        for(double &value: values){
+            value = valueDistribution(generator);
+        }
+        return values;
+    };
+    auto binaries = [&](int size){
+        vector<int> values(size);
+        for(int &value: values){
+            value = binaryDistribution(generator);
+        }
+        return values;
+    };
+
+    solution.chargingStations = binaries(numberStations);
+    for(int i = 0; i < numberStations; i++){
+    }
+    for(int k = 0; k < numberWindows; k++){
+        solution.powerExcess.push_back({6.0 + k, 6.5 + k, valueDistribution(generator)});
+    }
+    int numberStops = numberBuses * stopsPerBus;
+    for(int b = 0; b < numberBuses; b++){
+        solution.buses.push_back(b);
+        solution.stopStart.push_back(solution.stopStart.back() + stopsPerBus);
+    }
+    for(int s = 0; s < numberStops; s++){
+        solution.busSequences.push_back(stationDistribution(generator));
+    }
+    solution.nonRenewable = doubles(numberStops);
+    solution.arrivalTime = doubles(numberStops);
+    solution.scheduledTime = doubles(numberStops);
+    solution.deviationTime = doubles(numberStops);
+    solution.capacity = doubles(numberStops);
+    solution.chargeTime = doubles(numberStops);
+    solution.chargeAmount = doubles(numberStops);
+    solution.charge = binaries(numberStops);
+    solution.ases = binaries(numberStops);
+    solution.discounts = doubles(numberStops);
+
+    /// a charging stop uses one of the windows
+    for(int b = 0; b < numberBuses; b++){
+        for(int j = 0; j < stopsPerBus; j++){
+            if(solution.charge[b * stopsPerBus + j] == 1){
+                solution.cleanEnergy.push_back({(int) (generator() % numberWindows), b, j,
+                                                valueDistribution(generator), valueDistribution(generator), 1});
+            }
+        }
+    }
+    return solution;
+}
+
+/// compare the time taken to load a solution from the boost text archive and from the binary archive
+void benchmarkSolutions(){
+    int numberStations = 200;
+    int stopsPerBus = 40;
+    int numberWindows = 8;
+    string directory = filesystem::temp_directory_path().string();
+    Output writer;
+    Parser parser;
+
+    cout << "buses\ttext (KB)\tbinary (KB)\ttext load (ms)\tbinary map (ms)\tbinary load (ms)\tspeed-up" << endl;
+    for(int numberBuses: {100, 1000, 5000}){
+        primitiveVariables solution = generateSolution(numberBuses, numberStations, stopsPerBus, numberWindows, 42);
+        string textFile = directory + "/scheduler_benchmark_solution.txt";
+        string binaryFile = directory + "/scheduler_benchmark_solution.bin";
+        writer.writeTextSolutionFile(solution, textFile);
+        writer.writeSolutionFile(solution, binaryFile);
+
+        auto textStart = chrono::steady_clock::now();
+        primitiveVariables textSolution = parser.parseSolutionFile(textFile);
+        auto mapStart = chrono::steady_clock::now();
+        SolutionArchive archive;
+        string error;
+        if(!archive.open(binaryFile, error)){
+            cerr << error << endl;
+            return;
+        }
+        auto loadStart = chrono::steady_clock::now();
+        primitiveVariables binarySolution = archive.load();
+        auto loadEnd = chrono::steady_clock::now();
+
+        for(auto &fields: {differentFields(solution, textSolution), differentFields(solution, binarySolution)}){
+            if(!fields.empty()){
+                cerr << "loaded solutions differ for " << numberBuses << " buses in " << fields.front() << endl;
+            }
+        }
+        double textTime = chrono::duration<double, milli>(mapStart - textStart).count();
+        double mapTime = chrono::duration<double, milli>(loadStart - mapStart).count();
+        double loadTime = chrono::duration<double, milli>(loadEnd - mapStart).count();
+        cout << numberBuses << "\t" << filesystem::file_size(textFile) / 1024 << "\t"
+             << filesystem::file_size(binaryFile) / 1024 << "\t" << textTime << "\t" << mapTime << "\t" << loadTime
+             << "\t" << textTime / max(loadTime, 1e-9) << endl;
+        archive.close();
+        filesystem::remove(textFile);
+        filesystem::remove(binaryFile);
+    }
+}
+
+/// writes a timetable in the format of the bus data file of at least the given size. Every bus drives its route a number
+/// of times a day with a driver rest at the end of each trip
+void generateTimetable(string timetableFile, long minimumBytes, unsigned int seed){
+    mt19937 generator(seed);
+    uniform_int_distribution<int> stationDistribution(0, 999);
+    uniform_int_distribution<int> startDistribution(5 * 60, 8 * 60);
+    int routeLength = 20;
+    int busesPerRoute = 20;
+    int tripsPerBus = 12;
+
+    ofstream file(timetableFile);
+    file << "[";
+    long written = 1;
+    for(int route = 0; written < minimumBytes; route++){
+        vector<int> stations(routeLength);
+        for(int &station: stations){
+            station = stationDistribution(generator);
+        }
+        stringstream routeStream;
+        routeStream << (route == 0 ? "" : ", ") << "{\"route\": " << route << ", \"buses\": [";
+        for(int bus = 0; bus < busesPerRoute; bus++){
+            routeStream << (bus == 0 ? "" : ", ") << "{\"bus\": " << route * busesPerRoute + bus << ", \"path\": [";
+            int minutes = startDistribution(generator);
+            for(int stop = 0; stop < routeLength * tripsPerBus; stop++){
+                char time[6];
+                snprintf(time, sizeof(time), "%02d:%02d", (minutes / 60) % 24, minutes % 60);
+                bool rest = stop % routeLength == routeLength - 1;
+                routeStream << (stop == 0 ? "" : ", ") << "{\"time\": \"" << time << "\", \"station_id\": "
+                            << stations[stop % routeLength] << (rest ? ", \"rest\": 1}" : "}");
+                minutes += rest ? 15 : 10;
+            }
+            routeStream << "]}";
+        }
+        routeStream << "]}";
+        string routeText = routeStream.str();
+        file << routeText;
+        written += routeText.size();
+    }
+    file << "]";
+}
+
+/// the document based reader used by Parser::parseBusData before BusDataReader
+void documentBusData(string busDataFile, ModelParameters &parameters){
+    Utils utils;
+    ifstream file(busDataFile);
+    nlohmann::json busData = nlohmann::json::parse(file);
+    for(auto &busRoute: busData){
+        nlohmann::json routeBuses = busRoute.at("buses");
+        for(auto &bus: routeBuses){
+            for(int i = 0; i < bus.at("path").size(); i++){
+                nlohmann::json stop = bus.at("path")[i];
+                string time = stop.at("time");
+                double convertedTime = utils.convertTime(time);
+                parameters.scheduledTimes.push_back(convertedTime == 0 ? 24.0 : convertedTime);
+                parameters.stations.push_back(stop.at("station_id"));
+                parameters.rests.push_back(stop.contains("rest") ? 1 : 0);
+            }
+            parameters.busKeys.push_back(bus.at("bus"));
+            parameters.stopStart.push_back(parameters.stations.size());
+        }
+    }
+}
+
+/// reads the timetable in a child process, so the peak resident memory of each reader is measured on its own. The
+/// number of stops read is returned, the time (ms) and the peak resident memory (MB) are set
+long measureReader(string reader, string timetableFile, double &elapsed, double &peakMemory){
+    int results[2];
+    if(pipe(results) != 0){
+        return -1;
+    }
+    auto start = chrono::steady_clock::now();
+    pid_t child = fork();
+    if(child == 0){
+        close(results[0]);
+        ModelParameters parameters;
+        if(reader == "sax"){
+            BusDataReader busDataReader(parameters);
+            string error;
+            if(!busDataReader.read(timetableFile, error)){
+                cerr << error << endl;
+            }
+        }
+        else{
+            documentBusData(timetableFile, parameters);
+        }
+        long stops = parameters.stations.size();
+        write(results[1], &stops, sizeof(stops));
+        _exit(0);
+    }
+    close(results[1]);
+    long stops = -1;
+    if(read(results[0], &stops, sizeof(stops)) != sizeof(stops)){
+        stops = -1;
+    }
+    close(results[0]);
+    int status;
+    struct rusage usage;
+    wait4(child, &status, 0, &usage);
+    elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    peakMemory = usage.ru_maxrss / 1024.0;
+    return stops;
+}
+
+/// compare the document reader with the streaming reader on generated timetables, the largest is given in MB. The
+/// document reader is only run on the smaller timetables as its memory grows with several times the file size
+void benchmarkBusData(long largestMegabytes){
+    string timetableFile = filesystem::temp_directory_path().string() + "/scheduler_benchmark_buses.json";
+    long documentLimit = 256;
+
+    cout << "file (MB)\tstops\treader\ttime (ms)\tMB/s\tpeak RSS (MB)" << endl;
+    for(long megabytes: {16L, 256L, largestMegabytes}){
+        if(megabytes > largestMegabytes){
+            continue;
+        }
+        generateTimetable(timetableFile, megabytes << 20, 42);
+        double fileMegabytes = filesystem::file_size(timetableFile) / (1024.0 * 1024.0);
+        long documentStops = -1;
+        for(string reader: {"document", "sax"}){
+            if(reader == "document" && megabytes > documentLimit){
+                continue;
+            }
+            double elapsed, peakMemory;
+            long stops = measureReader(reader, timetableFile, elapsed, peakMemory);
+            if(reader == "document"){
+                documentStops = stops;
+            }
+            else if(documentStops >= 0 && stops != documentStops){
+                cerr << "stop count mismatch: " << documentStops << " vs " << stops << endl;
+            }
+            cout << round(fileMegabytes) << "\t" << stops << "\t" << reader << "\t" << elapsed << "\t"
+                 << fileMegabytes / (elapsed / 1000) << "\t" << peakMemory << endl;
+        }
+        filesystem::remove(timetableFile);
+        if(megabytes == largestMegabytes){
+            break;
+        }
+    }
+}
+
+/// writes a distance file with a row for every pair of stations
+void generateDistances(string distanceFile, int numberStations, unsigned int seed){
+    mt19937 generator(seed);
+    uniform_real_distribution<double> distanceDistribution(0.1, 30.0);
+    ofstream file(distanceFile);
+    file << "from,to,distance\n";
+    char line[64];
+    for(int i = 0; i < numberStations; i++){
+        for(int j = 0; j < numberStations; j++){
+            int length = snprintf(line, sizeof(line), "%d,%d,%.3f\n", i, j, distanceDistribution(generator));
+            file.write(line, length);
+        }
+    }
+}
+
+/// the distances as Parser::parseDistanceFile read them before MappedCSV and DistanceMatrix
+vector<vector<double>> lineDistances(string distanceFile, int numberStations){
+    FileReader reader;
+    vector<vector<double>> distances(numberStations, vector<double>(numberStations));
+    for(auto &row: reader.readCSV(distanceFile)){
+        distances[stoi(row[0])][stoi(row[1])] = stof(row[2]);
+    }
+    for(int i = 0; i < numberStations; i++){
+        for(int j = 0; j <= i; j++){
+            distances[i][j] = i == j ? 0.0 : distances[j][i];
+        }
+    }
+    return distances;
+}
+
+/// compare the throughput of the line reader with the mapped reader on generated distance files
+void benchmarkCSV(){
+    string distanceFile = filesystem::temp_directory_path().string() + "/scheduler_benchmark_distances.csv";
+    int cores = max(1, (int) thread::hardware_concurrency());
+
+    Parser parser;
+
+    cout << "stations\tfile (MB)\treader\ttime (ms)\tMB/s\tmatrix (MB)" << endl;
+    for(int numberStations: {500, 2000, 4000}){
+        generateDistances(distanceFile, numberStations, 42);
+        double fileMegabytes = filesystem::file_size(distanceFile) / (1024.0 * 1024.0);
+        auto report = [&](string reader, chrono::steady_clock::time_point start, double matrixBytes){
+            double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            cout << numberStations << "\t" << round(fileMegabytes) << "\t" << reader << "\t" << elapsed << "\t"
+                 << fileMegabytes / (elapsed / 1000) << "\t" << matrixBytes / (1024 * 1024) << endl;
+        };
+
+        auto start = chrono::steady_clock::now();
+        vector<vector<double>> expected = lineDistances(distanceFile, numberStations);
+        report("getline", start, (double) numberStations * numberStations * sizeof(double));
+        for(int threads: {1, cores}){
+            start = chrono::steady_clock::now();
+            shared_ptr<const DistanceMatrix> distances = parser.parseDistanceFile(distanceFile, numberStations,
+                                                                                  threads);
+            report("mapped, " + to_string(threads) + " threads", start, distances->bytes());
+            bool same = true;
+            for(int i = 0; i < numberStations; i++){
+                DistanceMatrix::Row row = distances->row(i);
+                for(int j = 0; j < numberStations; j++){
+                    same = same && row[j] == expected[i][j];
+                }
+            }
+            if(!same){
+                cerr << "distances differ for " << numberStations << " stations" << endl;
+            }
+            if(cores == 1){
+                break;
+            }
+        }
+        filesystem::remove(distanceFile);
+    }
+}
+
+/// the parameters of a synthetic fleet, with a charger at every chargerSpacing-th station and CEW of equal length over
+/// the day
+ModelParameters fleetParameters(SyntheticFleet &fleet, int numberStations, int numberWindows, int chargerSpacing = 2){
+    ModelParameters parameters;
+    mt19937 generator(42);
+    uniform_real_distribution<double> distanceDistribution(0.1, 5.0);
+    uniform_real_distribution<double> energyDistribution(0.0, 100.0);
+    DistanceMatrix *distances = new DistanceMatrix(numberStations);
+    for(int i = 0; i < numberStations; i++){
+        parameters.chargingStops.push_back(i % chargerSpacing == 0 ? 1 : 0);
+        for(int j = i + 1; j < numberStations; j++){
+            distances->set(i, j, distanceDistribution(generator));
+        }
+    }
+    parameters.distances = shared_ptr<const DistanceMatrix>(distances);
+    parameters.numberStations = numberStations;
+    for(int k = 0; k < numberWindows; k++){
+        parameters.cleanEnergyWindows.push_back({24.0 * k / numberWindows, 24.0 * (k + 1) / numberWindows,
+                                                 energyDistribution(generator)});
+    }
+    for(int n = 0; n < fleet.numberBuses(); n++){
+        parameters.busKeys.push_back(n);
+    }
+    parameters.stopStart = fleet.stopStart;
+    parameters.stations = fleet.stations;
+    parameters.scheduledTimes = fleet.times;
+    parameters.rests = vector<int>(fleet.stations.size(), 0);
+    return parameters;
+}
+
+/// the size of the model and the time taken to build it for an increasing number of CEW
+void benchmarkCEW(){
+    RunConfig config;
+    config.chargeRate = 600;
+    config.busEnergyCost = 1.0;
+    config.busSpeed = 35;
+    config.maxBatteryCapacity = 120;
+    config.minBatteryCapacity = 12;
+    config.startingCapacity = 30;
+    config.maxChargeTime = 0.16;
+    config.minChargeTime = 0.0166;
+    config.deviationTime = 0.0833;
+    int numberStations = 200;
+    int stopsPerBus = 40;
+    ostringstream log;
+
+    cout << "buses\tstops\tCEW\tcolumns\trows\tnonzeros\tbuild (ms)" << endl;
+    for(int numberBuses: {100, 500}){
+        SyntheticFleet fleet = generateFleet(numberBuses, numberStations, stopsPerBus, 42);
+        for(int numberWindows: {4, 24, 96}){
+            ModelParameters parameters = fleetParameters(fleet, numberStations, numberWindows);
+            auto start = chrono::steady_clock::now();
+            SchedulingProblem problem(parameters, config, log);
+            problem.build();
+            double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            cout << numberBuses << "\t" << parameters.totalStops() << "\t" << numberWindows << "\t"
+                 << problem.model.numberColumns() << "\t" << problem.model.numberRows() << "\t"
+                 << problem.model.numberNonzeros() << "\t" << elapsed << endl;
+            log.str("");
+        }
+    }
+}
+
+/// the size of the model with and without the stops at stations without a charger, for fewer and fewer chargers
+void benchmarkStops(){
+    RunConfig config;
+    config.chargeRate = 600;
+    config.busEnergyCost = 1.0;
+    config.busSpeed = 35;
+    config.maxBatteryCapacity = 120;
+    config.minBatteryCapacity = 12;
+    config.startingCapacity = 30;
+    config.maxChargeTime = 0.16;
+    config.minChargeTime = 0.0166;
+    config.deviationTime = 0.0833;
+    int numberStations = 200;
+    int stopsPerBus = 40;
+    int numberBuses = 200;
+    ostringstream log;
+    SyntheticFleet fleet = generateFleet(numberBuses, numberStations, stopsPerBus, 42);
+
+    cout << "chargers\tstops\tkept stops\tcompressed\tcolumns\trows\tnonzeros\tbuild (ms)" << endl;
+    for(int chargerSpacing: {1, 4, 10, 25}){
+        ModelParameters parameters = fleetParameters(fleet, numberStations, 24, chargerSpacing);
+        for(bool compress: {false, true}){
+            config.compressStops = compress;
+            auto start = chrono::steady_clock::now();
+            SchedulingProblem problem(parameters, config, log);
+            problem.build();
+            double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            StopSegments segments;
+            segments.build(problem.parameters, parameters.chargingStops, config.deviationTime, config.maxChargeTime,
+                           compress);
+            cout << numberStations / chargerSpacing << "\t" << parameters.totalStops() << "\t"
+                 << segments.numberKept() << "\t" << (compress ? "yes" : "no") << "\t"
+                 << problem.model.numberColumns() << "\t" << problem.model.numberRows() << "\t"
+                 << problem.model.numberNonzeros() << "\t" << elapsed << endl;
+            log.str("");
+        }
+    }
+}
+
+/// the time of the subgradient iterations of the decomposition with an increasing number of threads, the subproblems
+/// are solved by the default backend of the build
+void benchmarkDecomposition(int numberBuses){
+    RunConfig config;
+    config.chargeRate = 600;
+    config.busEnergyCost = 1.0;
+    config.busSpeed = 35;
+    config.maxBatteryCapacity = 120;
+    config.minBatteryCapacity = 12;
+    config.startingCapacity = 100;
+    config.maxChargeTime = 0.16;
+    config.minChargeTime = 0.0166;
+    config.deviationTime = 0.0833;
+    config.decompositionIterations = 5;
+    int numberStations = 200;
+    int stopsPerBus = 40;
+    int cores = max(1, (int) thread::hardware_concurrency());
+    ostringstream log;
+    SyntheticFleet fleet = generateFleet(numberBuses, numberStations, stopsPerBus, 42);
+    ModelParameters parameters = fleetParameters(fleet, numberStations, 24, 4);
+
+    cout << "buses\tthreads\titerations\ttime (s)\tspeedup\tlower bound\tbest schedule\tstatus" << endl;
+    double singleThread = 0.0;
+    for(int threads = 1; threads <= cores; threads *= 2){
+        config.threads = threads;
+        auto start = chrono::steady_clock::now();
+        LagrangianDecomposition decomposition(parameters, config, log);
+        decomposition.run();
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if(threads == 1){
+            singleThread = elapsed;
+        }
+        cout << numberBuses << "\t" << threads << "\t" << decomposition.iterations() << "\t" << elapsed << "\t"
+             << singleThread / elapsed << "\t" << decomposition.lowerBound() << "\t" << decomposition.upperBound()
+             << "\t" << decomposition.status() << endl;
+        log.str("");
+    }
+}
+
+/// the time of a plan of every bus with the dynamic programming planner and its non-clean energy, next to the greedy
+/// schedule of the same fleet. The plans ignore the other buses at the chargers, the greedy schedule does not
+void benchmarkPlanner(){
+    RunConfig config;
+    config.chargeRate = 600;
+    config.busEnergyCost = 1.0;
+    config.busSpeed = 35;
+    config.maxBatteryCapacity = 120;
+    config.minBatteryCapacity = 12;
+    config.startingCapacity = 100;
+    config.maxChargeTime = 0.16;
+    config.minChargeTime = 0.0166;
+    config.deviationTime = 0.0833;
+    int numberStations = 200;
+    int stopsPerBus = 40;
+
+    cout << "buses\ttime step (min)\tper bus (ms)\tplanned\tnon-clean\tgreedy (ms)\tgreedy non-clean" << endl;
+    for(int numberBuses: {100, 500}){
+        SyntheticFleet fleet = generateFleet(numberBuses, numberStations, stopsPerBus, 42);
+        ModelParameters parameters = fleetParameters(fleet, numberStations, 24, 4);
+        parameters.setLegs(config.busEnergyCost, config.busSpeed);
+
+        auto greedyStart = chrono::steady_clock::now();
+        GreedyScheduler heuristic(config);
+        heuristic.buildSchedule(parameters, parameters.cleanEnergyWindows);
+        double greedyTime = chrono::duration<double, milli>(chrono::steady_clock::now() - greedyStart).count();
+
+        for(double minutes: {1.0, 0.5}){
+            config.dpTimeStep = minutes / 60;
+            BusChargePlanner planner(parameters, config, parameters.cleanEnergyWindows);
+            int planned = 0;
+            double nonRenewable = 0.0;
+            auto start = chrono::steady_clock::now();
+            for(int n = 0; n < planner.numberBuses(); n++){
+                ChargePlan plan = planner.plan(n);
+                planned += plan.feasible ? 1 : 0;
+                nonRenewable += plan.nonRenewable;
+            }
+            double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            cout << numberBuses << "\t" << minutes << "\t" << elapsed / numberBuses << "\t" << planned << "\t"
+                 << nonRenewable << "\t" << greedyTime << "\t" << heuristic.objectiveValue() << endl;
+        }
+    }
+}
+
+/// the placements evaluated per second by the placement search with an increasing number of threads
+void benchmarkPlacement(int numberBuses){
+    RunConfig config;
+    config.chargeRate = 600;
+    config.busEnergyCost = 1.0;
+    config.busSpeed = 35;
+    config.maxBatteryCapacity = 120;
+    config.minBatteryCapacity = 12;
+    config.startingCapacity = 100;
+    config.maxChargeTime = 0.16;
+    config.minChargeTime = 0.0166;
+    config.deviationTime = 0.0833;
+    config.placementBudget = 40;
+    config.placementIterations = 10;
+    config.placementCandidates = 32;
+    int numberStations = 200;
+    int stopsPerBus = 40;
+    int cores = max(1, (int) thread::hardware_concurrency());
+    ostringstream log;
+    SyntheticFleet fleet = generateFleet(numberBuses, numberStations, stopsPerBus, 42);
+    ModelParameters parameters = fleetParameters(fleet, numberStations, 24, 4);
+
+    cout << "buses\tthreads\tplacements\ttime (s)\tplacements/s\tunplanned buses\tnon-clean" << endl;
+    for(int threads = 1; threads <= cores; threads *= 2){
+        config.threads = threads;
+        PlacementSearch search(parameters, config, log);
+        vector<Placement> best = search.run();
+        cout << numberBuses << "\t" << threads << "\t" << search.evaluatedPlacements() << "\t"
+             << search.elapsedTime() << "\t" << search.evaluatedPlacements() / search.elapsedTime() << "\t"
+             << best.front().score.unplannedBuses << "\t" << best.front().score.nonRenewable << endl;
+        log.str("");
+    }
+}
+
+/// the CEW scenarios per second of the simulation of a greedy schedule of a synthetic fleet over a whole day
+void benchmarkSimulation(int numberScenarios){
+    RunConfig config;
+    config.chargeRate = 600;
+    config.busEnergyCost = 1.0;
+    config.busSpeed = 35;
+    config.maxBatteryCapacity = 120;
+    config.minBatteryCapacity = 12;
+    config.startingCapacity = 30;
+    config.maxChargeTime = 0.16;
+    config.minChargeTime = 0.0166;
+    config.deviationTime = 0.0833;
+    int numberStations = 200;
+    int stopsPerBus = 40;
+
+    cout << "buses\tcharges\tCEW\tscenarios\ttime (s)\tscenarios/s\tmean non-clean" << endl;
+    for(int numberBuses: {100, 500, 2000}){
+        SyntheticFleet fleet = generateFleet(numberBuses, numberStations, stopsPerBus, 42);
+        ModelParameters parameters = fleetParameters(fleet, numberStations, 96);
+        parameters.setLegs(config.busEnergyCost, config.busSpeed);
+        GreedyScheduler heuristic(config);
+        primitiveVariables schedule = heuristic.buildSchedule(parameters, parameters.cleanEnergyWindows);
+
+        ScenarioBatch scenarios;
+        scenarios.addPerturbed(parameters.cleanEnergyWindows, numberScenarios, 0.2, 0.5, 42);
+        auto start = chrono::steady_clock::now();
+        ScheduleSimulator simulator(schedule, config, {0.0, 6.0, 12.0, 18.0, 24.0});
+        SimulationResult result = simulator.run(scenarios);
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        double meanNonRenewable = accumulate(result.totalNonRenewable.begin(), result.totalNonRenewable.end(), 0.0) /
+                                  numberScenarios;
+        cout << numberBuses << "\t" << accumulate(schedule.charge.begin(), schedule.charge.end(), 0) << "\t"
+             << scenarios.numberWindows() << "\t" << numberScenarios << "\t" << elapsed << "\t"
+             << numberScenarios / elapsed << "\t" << meanNonRenewable << endl;
+    }
+}
+
+/// the CEW parser before splitCleanEnergyWindows, which erases each window from the front of the string
+vector<CleanEnergyWindow> erasingCEWParser(string windows){
+    vector<CleanEnergyWindow> cleanEnergyWindows;
+    while(windows.find(",") != string::npos){
+        string window = windows.substr(0, windows.find(","));
+        windows.erase(0, windows.find(",") + 1);
+        cleanEnergyWindows.push_back({stod(window.substr(0, window.find("-"))),
+                                      stod(window.substr(window.find("-") + 1)),
+                                      stod(window.substr(window.find("=") + 1))});
+    }
+    return cleanEnergyWindows;
+}
+
+/// compare the CEW parser before and after the single pass parser for an increasing number of windows, and the lookup
+/// of the CEW of a key in a CEW store
+void benchmarkCEWParser(){
+    string folder = filesystem::temp_directory_path().string() + "/scheduler_benchmark_cew";
+    string storeFile = folder + ".store";
+    mt19937 generator(42);
+    uniform_real_distribution<double> energyDistribution(0.0, 800.0);
+
+    cout << "CEW\terase (ms)\tsingle pass (ms)\tspeed-up\tstore lookup (ms)" << endl;
+    for(int numberWindows: {96, 10000, 100000}){
+        string windows;
+        for(int k = 0; k < numberWindows; k++){
+            windows += to_string(24.0 * k / numberWindows) + "-" + to_string(24.0 * (k + 1) / numberWindows) + "=" +
+                       to_string(energyDistribution(generator)) + ",";
+        }
+        filesystem::create_directories(folder + "/predicted/MPM");
+        ofstream(folder + "/predicted/MPM/2022-2-14-0.txt") << windows << "\n";
+
+        auto start = chrono::steady_clock::now();
+        vector<CleanEnergyWindow> erased = erasingCEWParser(windows);
+        auto eraseEnd = chrono::steady_clock::now();
+        vector<CleanEnergyWindow> split;
+        string error;
+        Parser::splitCleanEnergyWindows(windows, split, error);
+        auto splitEnd = chrono::steady_clock::now();
+
+        long numberFiles;
+        CEWStore::compile(folder, storeFile, numberFiles, error);
+        auto lookupStart = chrono::steady_clock::now();
+        CEWStore store;
+        vector<CleanEnergyWindow> stored;
+        store.open(storeFile, error);
+        store.windows("predicted/MPM/2022-2-14-0", stored);
+        auto lookupEnd = chrono::steady_clock::now();
+
+        double eraseTime = chrono::duration<double, milli>(eraseEnd - start).count();
+        double splitTime = chrono::duration<double, milli>(splitEnd - eraseEnd).count();
+        double lookupTime = chrono::duration<double, milli>(lookupEnd - lookupStart).count();
+        if(erased.size() != split.size() || stored.size() != split.size()){
+            cerr << "window count mismatch: " << erased.size() << " " << split.size() << " " << stored.size() << endl;
+        }
+        cout << numberWindows << "\t" << eraseTime << "\t" << splitTime << "\t" << eraseTime / max(splitTime, 1e-9)
+             << "\t" << lookupTime << endl;
+        filesystem::remove_all(folder);
+        filesystem::remove(storeFile);
+    }
+}
+
+/// the CEW of a day of the CEW folder, the windows of each file of the day from its hour until the hour of the next
+/// file. Empty if the folder has no file for the day
+vector<CleanEnergyWindow> dayWindows(string folder, string day){
+    Parser parser;
+    ostringstream log;
+    vector<CleanEnergyWindow> windows;
+    for(int hour: {0, 6, 12, 18}){
+        string cewFile = folder + "/" + day + "-" + to_string(hour) + ".txt";
+        if(!filesystem::exists(cewFile)){
+            continue;
+        }
+        for(auto &window: parser.parseCleanEnergyWindows(parser.readCEWFile(cewFile), 1.0, log)){
+            if(window.startTime >= hour && window.startTime < hour + 6){
+                windows.push_back(window);
+            }
+        }
+    }
+    return windows;
+}
+
+/// the number of CEW of the days of the CEW folder after coarsening, and the size of the model, the time of the
+/// decomposition with the dynamic programming subproblems and the objective with the CEW of one day and the coarse
+/// CEW. The schedule of the coarse CEW is also evaluated with the original CEW
+void benchmarkCoarsening(string cewFolder){
+    RunConfig config;
+    config.chargeRate = 600;
+    config.busEnergyCost = 1.0;
+    config.busSpeed = 35;
+    config.maxBatteryCapacity = 120;
+    config.minBatteryCapacity = 12;
+    config.startingCapacity = 100;
+    config.maxChargeTime = 0.16;
+    config.minChargeTime = 0.0166;
+    config.deviationTime = 0.0833;
+    config.decompositionIterations = 10;
+    config.subproblemSolver = "dp";
+    int numberStations = 200;
+    int stopsPerBus = 40;
+    int chargerSpacing = 4;
+    int chargers = numberStations / chargerSpacing;
+    vector<double> tolerances{0.0, 0.01, 0.05, 0.1};
+
+    cout << "CEW\tdays\tCEW\tcoarse CEW (tolerance 0, 0.01, 0.05, 0.1)" << endl;
+    vector<CleanEnergyWindow> example;
+    for(string datatype: {"ideal/MPM", "ideal/SPM", "predicted/MPM", "predicted/SPM"}){
+        int days = 0;
+        long numberWindows = 0;
+        vector<long> coarseWindows(tolerances.size(), 0);
+        for(int date = 1; date <= 28; date++){
+            vector<CleanEnergyWindow> windows = dayWindows(cewFolder + "/" + datatype, "2022-2-" + to_string(date));
+            if(windows.empty()){
+                continue;
+            }
+            if(example.size() < windows.size()){
+                example = windows;
+            }
+            days++;
+            numberWindows += windows.size();
+            for(int t = 0; t < tolerances.size(); t++){
+                coarseWindows[t] += CEWCoarsening(windows, config.chargeRate, chargers, tolerances[t])
+                        .coarseWindows().size();
+            }
+        }
+        cout << datatype << "\t" << days << "\t" << numberWindows;
+        for(long coarse: coarseWindows){
+            cout << "\t" << coarse;
+        }
+        cout << endl;
+    }
+    if(example.empty()){
+        cerr << "no CEW files in " << cewFolder << endl;
+        return;
+    }
+
+    /// the share of a location, so the fleet can not charge with clean energy only
+    for(auto &window: example){
+        window.availableEnergy *= 0.05;
+    }
+    ostringstream log;
+    SyntheticFleet fleet = generateFleet(100, numberStations, stopsPerBus, 42);
+    ModelParameters parameters = fleetParameters(fleet, numberStations, 0, chargerSpacing);
+    cout << "tolerance\tCEW\terror bound\tcolumns\trows\tdecomposition (s)\tobjective\toriginal CEW objective"
+         << endl;
+    for(double tolerance: tolerances){
+        CEWCoarsening coarsening(example, config.chargeRate, chargers, tolerance);
+        parameters.cleanEnergyWindows = coarsening.coarseWindows();
+        SchedulingProblem problem(parameters, config, log);
+        problem.build();
+
+        auto start = chrono::steady_clock::now();
+        LagrangianDecomposition decomposition(parameters, config, log);
+        primitiveVariables schedule = decomposition.run();
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        primitiveVariables refined = coarsening.refine(schedule, config);
+        double nonRenewable = accumulate(refined.nonRenewable.begin(), refined.nonRenewable.end(), 0.0);
+        cout << tolerance << "\t" << coarsening.coarseWindows().size() << "\t" << coarsening.errorBound() << "\t"
+             << problem.model.numberColumns() << "\t" << problem.model.numberRows() << "\t" << elapsed << "\t"
+             << decomposition.upperBound() << "\t" << nonRenewable << "\t" << decomposition.status() << endl;
+        log.str("");
+    }
+}
+
+/// the time and size of the report and the result files of a greedy schedule of a large fleet
+void benchmarkResults(int numberBuses){
+    RunConfig config;
+    config.chargeRate = 600;
+    config.busEnergyCost = 1.0;
+    config.busSpeed = 35;
+    config.maxBatteryCapacity = 120;
+    config.minBatteryCapacity = 12;
+    config.startingCapacity = 100;
+    config.maxChargeTime = 0.16;
+    config.minChargeTime = 0.0166;
+    config.deviationTime = 0.0833;
+    config.method = "SPM";
+    config.discountFactor = 0.01;
+    int numberStations = 200;
+    int stopsPerBus = 40;
+    SyntheticFleet fleet = generateFleet(numberBuses, numberStations, stopsPerBus, 42);
+    ModelParameters parameters = fleetParameters(fleet, numberStations, 96, 4);
+    parameters.setLegs(config.busEnergyCost, config.busSpeed);
+    for(int i = 0; i < numberStations; i++){
+        parameters.stationData.push_back({"Station" + to_string(i)});
+    }
+    GreedyScheduler heuristic(config);
+    primitiveVariables schedule = heuristic.buildSchedule(parameters, parameters.cleanEnergyWindows);
+    schedule.chargingStations = parameters.chargingStops;
+    RunOutcome outcome{0.0, 24.0, heuristic.objectiveValue(), "Greedy", 0.0, 0, config.method};
+    string resultFile = filesystem::temp_directory_path().string() + "/scheduler_benchmark_results";
+
+    cout << "buses\tstops\toutput\ttime (ms)\tsize (MB)" << endl;
+    auto measure = [&](string name, const function<void()> &write, const vector<string> &files){
+        auto start = chrono::steady_clock::now();
+        write();
+        double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        double size = 0.0;
+        for(auto &file: files){
+            size += filesystem::file_size(file) / 1e6;
+            filesystem::remove(file);
+        }
+        cout << numberBuses << "\t" << parameters.totalStops() << "\t" << name << "\t" << elapsed << "\t" << size
+             << endl;
+    };
+    for(string report: {"full", "summary"}){
+        measure("report " + report, [&](){
+            ofstream file(resultFile + ".txt");
+            Output printer(file);
+            printer.printResults(schedule, parameters.stationData, outcome, report == "summary");
+        }, {resultFile + ".txt"});
+    }
+    measure("jsonl", [&](){
+        Output().writeResults(schedule, parameters.stationData, outcome, resultFile + ".jsonl", "jsonl");
+    }, {resultFile + ".jsonl"});
+    vector<string> csvFiles;
+    for(string name: {"summary", "buses", "stops", "windows", "windowBuses"}){
+        csvFiles.push_back(resultFile + "_" + name + ".csv");
+    }
+    measure("csv", [&](){
+        Output().writeResults(schedule, parameters.stationData, outcome, resultFile, "csv");
+    }, csvFiles);
+    measure("jsonl summary", [&](){
+        Output().writeResults(schedule, parameters.stationData, outcome, resultFile + ".jsonl", "jsonl", true);
+    }, {resultFile + ".jsonl"});
+}
+
+/// the time of each phase of a run of generated instances of growing size: parsing the files, building the model,
+/// solving it and writing the results. The solve uses the default backend of the build, or without a MIP solver 10
+/// iterations of the decomposition with the dynamic program on a grid of a minute and 0.1 kWh without a time limit.
+/// Its bounds are no lower bounds, so it only stops early if the plans satisfy the relaxed rows. The rows are appended
+/// to resultCsv with label, e.g. the commit, so the runs of different commits can be compared, the solver, iterations
+/// and status columns tell how the instance was solved. The allocations are those of the whole run of an instance
+void benchmarkSuite(string resultCsv, string label){
+    vector<InstanceSpec> ladder = {{.numberStations=20, .numberBuses=40, .stopsPerBus=40},
+                                   {.numberStations=100, .numberBuses=200, .stopsPerBus=40},
+                                   {.numberStations=500, .numberBuses=500, .stopsPerBus=40}};
+    string folder = filesystem::temp_directory_path().string() + "/scheduler_benchmark_suite";
+    bool header = !filesystem::exists(resultCsv);
+    ofstream results(resultCsv, ios::app);
+    if(header){
+        results << "label,stations,buses,stopsPerBus,windows,stops,solver,parse (ms),build (ms),solve (ms),"
+                   "output (ms),objective,allocations,iterations,status" << endl;
+    }
+    cout << "stations\tbuses\tstops\tsolver\tparse (ms)\tbuild (ms)\tsolve (ms)\toutput (ms)\tobjective\tallocations"
+            "\titerations\tstatus" << endl;
+    for(auto &spec: ladder){
+        map<string, string> arguments = InstanceGenerator(spec).write(folder);
+        RunConfig config = RunConfig::fromArguments(arguments);
+        config.decompositionIterations = 10;
+        config.dpTimeStep = 1.0 / 60.0;
+        config.dpEnergyStep = 0.1;
+        RunMetrics metrics;
+        MetricsScope metricsScope(metrics);
+        stringstream log;
+        auto milliseconds = [](chrono::steady_clock::time_point start){
+            return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        };
+
+        auto start = chrono::steady_clock::now();
+        Parser parser;
+        ModelParameters parameters = parser.parseLocationData(arguments);
+        parameters.cleanEnergyWindows = parser.parseCleanEnergyWindows(arguments["CEW"], config.powerRatio, log);
+        double parseTime = milliseconds(start);
+
+        start = chrono::steady_clock::now();
+        SchedulingProblem problem(parameters, config, log);
+        problem.build();
+        double buildTime = milliseconds(start);
+
+        /// the mps backend only writes the model, so the decomposition solves the instance instead
+        string solver = defaultSolverBackend();
+        primitiveVariables schedule;
+        double objective;
+        int iterations = 0;
+        string status;
+        start = chrono::steady_clock::now();
+        if(solver != "mps"){
+            Solver backend(config, log);
+            schedule = backend.solve(problem);
+            objective = backend.result().objectiveValue;
+            status = backend.result().status;
+        }
+        else{
+            solver = "lagrangian dp";
+            config.subproblemSolver = "dp";
+            config.timeout = 0;
+            LagrangianDecomposition decomposition(parameters, config, log);
+            schedule = decomposition.run();
+            objective = decomposition.upperBound();
+            iterations = decomposition.iterations();
+            status = decomposition.status();
+        }
+        double solveTime = milliseconds(start);
+
+        start = chrono::steady_clock::now();
+        RunOutcome outcome{0.0, 24.0, objective, solver, 0.0, solveTime / 1000, config.method};
+        ofstream report(folder + "/report.txt");
+        Output(report).printResults(schedule, parameters.stationData, outcome);
+        Output().writeResults(schedule, parameters.stationData, outcome, folder + "/results.jsonl", "jsonl");
+        report.close();
+        double outputTime = milliseconds(start);
+
+        cout << spec.numberStations << "\t" << spec.numberBuses << "\t" << parameters.totalStops() << "\t" << solver
+             << "\t" << parseTime << "\t" << buildTime << "\t" << solveTime << "\t" << outputTime << "\t" << objective
+             << "\t" << metrics.allocations() << "\t" << iterations << "\t" << status << endl;
+        results << label << "," << spec.numberStations << "," << spec.numberBuses << "," << spec.stopsPerBus << ","
+                << spec.numberWindows << "," << parameters.totalStops() << "," << solver << "," << parseTime << ","
+                << buildTime << "," << solveTime << "," << outputTime << "," << objective << ","
+                << metrics.allocations() << "," << iterations << ",\"" << status << "\"" << endl;
+    }
+    filesystem::remove_all(folder);
+}
+
+int main(int argc, char *argv[]) {
+    string benchmark = argc > 1 ? argv[1] : "conflicts";
+
+    if(benchmark == "conflicts"){
+        benchmarkConflicts();
+    }
+    else if(benchmark == "solutions"){
+        benchmarkSolutions();
+    }
+    else if(benchmark == "csv"){
+        benchmarkCSV();
+    }
+    else if(benchmark == "cew"){
+        benchmarkCEW();
+    }
+    else if(benchmark == "stops"){
+        benchmarkStops();
+    }
+    else if(benchmark == "decomposition"){
+        benchmarkDecomposition(argc > 2 ? stoi(argv[2]) : 200);
+    }
+    else if(benchmark == "planner"){
+        benchmarkPlanner();
+    }
+    else if(benchmark == "placement"){
+        benchmarkPlacement(argc > 2 ? stoi(argv[2]) : 100);
+    }
+    else if(benchmark == "simulation"){
+        benchmarkSimulation(argc > 2 ? stoi(argv[2]) : 10000);
+    }
+    else if(benchmark == "cewparser"){
+        benchmarkCEWParser();
+    }
+    else if(benchmark == "coarsening"){
+        benchmarkCoarsening(argc > 2 ? argv[2] : "../../CEWs/February");
+    }
+    else if(benchmark == "results"){
+        benchmarkResults(argc > 2 ? stoi(argv[2]) : 2000);
+    }
+    else if(benchmark == "busdata"){
+        benchmarkBusData(argc > 2 ? stol(argv[2]) : 1024);
+    }
+    else if(benchmark == "suite"){
+        benchmarkSuite(argc > 2 ? argv[2] : "benchmark_suite.csv", argc > 3 ? argv[3] : "");
+    }
+    else{
+        cerr << "Unknown benchmark " << benchmark << endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include <iostream>
+#include <chrono>
+#include "string"
+#include "vector"
+#include "CEWStore.h"
+
+using namespace std;
+
+/// compiles a folder of CEW files into a CEW store and looks up the CEW of a store
+///     cew_store <CEW folder> <store>
+/// the keys are the paths of the files below the folder without ".txt", e.g. predicted/MPM/2022-2-14-6
+///     cew_store --list <store>
+///     cew_store --show <store> <key>
+int main(int argc, char *argv[]) {
+    if(argc < 3){
+        cout << "usage: cew_store <CEW folder> <store>" << endl;
+        cout << "       cew_store --list <store>" << endl;
+        cout << "       cew_store --show <store> <key>" << endl;
+        return -1;
+    }
+    string argument = argv[1];
+    string error;
+    if(argument == "--list" || argument == "--show"){
+        CEWStore store;
+        if(!store.open(argv[2], error)){
+            cout << error << endl;
+            return -1;
+        }
+        if(argument == "--list"){
+            for(int e = 0; e < store.numberEntries(); e++){
+                cout << store.key(e) << endl;
+            }
+            return 0;
+        }
+        vector<CleanEnergyWindow> windows;
+        if(argc < 4 || !store.windows(argv[3], windows)){
+            cout << argv[2] << " has no CEW for " << (argc < 4 ? "" : argv[3]) << endl;
+            return -1;
+        }
+        for(auto &window: windows){
+            cout << window.startTime << "-" << window.endTime << "=" << window.availableEnergy << ",";
+        }
+        cout << endl;
+        return 0;
+    }
+
+    auto startTime = chrono::steady_clock::now();
+    long numberFiles;
+    if(!CEWStore::compile(argument, argv[2], numberFiles, error)){
+        cout << error << endl;
+        return -1;
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    cout << argument << " -> " << argv[2] << ": " << numberFiles << " CEW files in " << elapsed << " s" << endl;
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include <iostream>
+#include "fstream"
+#include "map"
+#include "string"
+#include "InstanceGenerator.h"
+#include "Parser.h"
+
+using namespace std;
+
+/// writes a synthetic instance to a folder and prints the arguments of a run of it, which are also written to
+/// arguments.txt in the folder
+///     instance_generator --folder <folder> [--stations 200] [--buses 100] [--stopsPerBus 40] [--chargerDensity 0.1]
+///                        [--windows 48] [--seed 42]
+///     scheduler $(cat <folder>/arguments.txt)
+int main(int argc, char *argv[]) {
+    map<string, string> arguments = Parser().parseArguments(argc, argv);
+    if(arguments.find("folder") == arguments.end()){
+        cout << "usage: instance_generator --folder <folder> [--stations 200] [--buses 100] [--stopsPerBus 40] "
+                "[--chargerDensity 0.1] [--windows 48] [--seed 42]" << endl;
+        return -1;
+    }
+    InstanceSpec spec;
+    try{
+        if(arguments.count("stations")) spec.numberStations = stoi(arguments["stations"]);
+        if(arguments.count("buses")) spec.numberBuses = stoi(arguments["buses"]);
+        if(arguments.count("stopsPerBus")) spec.stopsPerBus = stoi(arguments["stopsPerBus"]);
+        if(arguments.count("chargerDensity")) spec.chargerDensity = stod(arguments["chargerDensity"]);
+        if(arguments.count("windows")) spec.numberWindows = stoi(arguments["windows"]);
+        if(arguments.count("seed")) spec.seed = stoul(arguments["seed"]);
+    }
+    catch(const exception &e){
+        cout << "The sizes of the instance must be numbers" << endl;
+        return -1;
+    }
+
+    map<string, string> runArguments = InstanceGenerator(spec).write(arguments["folder"]);
+    ofstream argumentFile(arguments["folder"] + "/arguments.txt");
+    for(auto &[key, value]: runArguments){
+        /// an empty value can not be given on the command line, the scheduler uses its default
+        if(!value.empty()){
+            argumentFile << "--" << key << " " << value << " ";
+            cout << "--" << key << " " << value << " ";
+        }
+    }
+    argumentFile << endl;
+    cout << endl;
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <iostream>
+#include "string"
+#include "vector"
+#include "cstdio"
+#include "DataStructures.h"
+#include "Output.h"
+#include "Parser.h"
+#include "SolutionArchive.h"
+
+using namespace std;
+
+/// writes the solution in the given format, reads it back and reports the fields which did not survive
+bool roundTrip(const primitiveVariables &solution, string format, string temporaryFile){
+    Output writer;
+    Parser parser;
+    if(format == "binary"){
+        writer.writeSolutionFile(solution, temporaryFile);
+    }
+    else{
+        writer.writeTextSolutionFile(solution, temporaryFile);
+    }
+    vector<string> fields = differentFields(solution, parser.parseSolutionFile(temporaryFile));
+    remove(temporaryFile.c_str());
+
+    cout << format << " round trip: " << (fields.empty() ? "ok" : "fields differ:");
+    for(string &field: fields){
+        cout << " " << field;
+    }
+    cout << endl;
+    return fields.empty();
+}
+
+/// converts solution files between the binary archive and the boost text archive
+///     solution_convert <input> <output> [binary|text]
+/// the format of the input is detected, the output is a binary archive unless text is given.
+///     solution_convert --check <input>
+/// reads the input and checks that every field is kept when it is written and read in both formats
+int main(int argc, char *argv[]) {
+    if(argc < 3){
+        cout << "usage: solution_convert <input> <output> [binary|text]" << endl;
+        cout << "       solution_convert --check <input>" << endl;
+        return -1;
+    }
+    Parser parser;
+    string argument = argv[1];
+    if(argument == "--check"){
+        string input = argv[2];
+        primitiveVariables solution = parser.parseSolutionFile(input);
+        cout << input << ": " << (SolutionArchive::isArchive(input) ? "binary" : "text") << " archive with "
+             << solution.buses.size() << " buses" << endl;
+        bool binary = roundTrip(solution, "binary", input + ".check.bin");
+        bool text = roundTrip(solution, "text", input + ".check.txt");
+        return binary && text ? 0 : 1;
+    }
+
+    string output = argv[2];
+    string format = argc > 3 ? argv[3] : "binary";
+    primitiveVariables solution = parser.parseSolutionFile(argument);
+    Output writer;
+    if(format == "text"){
+        writer.writeTextSolutionFile(solution, output);
+    }
+    else if(format == "binary"){
+        writer.writeSolutionFile(solution, output);
+    }
+    else{
+        cout << "Unknown format " << format << endl;
+        return -1;
+    }
+    cout << argument << " -> " << output << " (" << format << ")" << endl;
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include <iostream>
+#include <random>
+#include "string"
+#include "vector"
+#include "map"
+#include "filesystem"
+#include "fstream"
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/map.hpp>
+#include "DataStructures.h"
+#include "Output.h"
+#include "Parser.h"
+
+using namespace std;
+
+/// a solution of buses with different numbers of stops, every field set. The CEW uses are ordered by bus, stop and
+/// window like the ones flattened from the nested layout, SPM solutions also have ases and discounts
+primitiveVariables generateSolution(bool spm, unsigned int seed){
+    primitiveVariables solution;
+    mt19937 generator(seed);
+    uniform_real_distribution<double> value(0.0, 100.0);
+    uniform_int_distribution<int> binary(0, 1);
+    int numberStations = 12;
+    int numberWindows = 4;
+    for(int i = 0; i < numberStations; i++){
+        solution.chargingStations.push_back(binary(generator));
+    }
+    for(int k = 0; k < numberWindows; k++){
+        solution.powerExcess.push_back({6.0 + k / 3.0, 6.0 + (k + 1) / 3.0, value(generator)});
+    }
+    vector<int> stops = {5, 1, 8};
+    for(int n = 0; n < stops.size(); n++){
+        solution.buses.push_back(10 * n + 3);
+        solution.stopStart.push_back(solution.stopStart.back() + stops[n]);
+        for(int i = 0; i < stops[n]; i++){
+            solution.busSequences.push_back(generator() % numberStations);
+            solution.nonRenewable.push_back(value(generator));
+            solution.arrivalTime.push_back(value(generator) / 7.0);
+            solution.scheduledTime.push_back(value(generator) / 7.0);
+            solution.deviationTime.push_back(value(generator) / 1000.0);
+            solution.capacity.push_back(value(generator));
+            solution.chargeTime.push_back(value(generator) / 600.0);
+            solution.chargeAmount.push_back(value(generator));
+            solution.charge.push_back(binary(generator));
+            if(spm){
+                solution.ases.push_back(binary(generator));
+                solution.discounts.push_back(value(generator) / 10.0);
+            }
+            for(int k = 0; k < numberWindows; k++){
+                if(binary(generator) == 1){
+                    solution.cleanEnergy.push_back({k, n, i, value(generator), value(generator) / 600.0, 1});
+                }
+            }
+        }
+    }
+    return solution;
+}
+
+/// the solution in the layout keyed by bus of the version 0 and 1 archives
+nestedVariables nestVariables(const primitiveVariables &solution){
+    nestedVariables nested;
+    nested.buses = solution.buses;
+    nested.chargingStations = solution.chargingStations;
+    nested.powerExcess = solution.powerExcess;
+    nested.windowEnergyUsed = vector<map<int, vector<double>>>(solution.powerExcess.size());
+    for(int n = 0; n < solution.buses.size(); n++){
+        int b = solution.buses[n];
+        int first = solution.stopStart[n];
+        int end = solution.stopStart[n + 1];
+        auto nest = [&](auto &field, const auto &flat){
+            if(!flat.empty()){
+                field[b].assign(flat.begin() + first, flat.begin() + end);
+            }
+        };
+        nest(nested.busSequences, solution.busSequences);
+        nest(nested.nonRenewable, solution.nonRenewable);
+        nest(nested.arrivalTime, solution.arrivalTime);
+        nest(nested.scheduledTime, solution.scheduledTime);
+        nest(nested.deviationTime, solution.deviationTime);
+        nest(nested.capacity, solution.capacity);
+        nest(nested.chargeTime, solution.chargeTime);
+        nest(nested.chargeAmount, solution.chargeAmount);
+        nest(nested.charge, solution.charge);
+        nest(nested.ases, solution.ases);
+        nest(nested.discounts, solution.discounts);
+        for(auto &windowEnergy: nested.windowEnergyUsed){
+            windowEnergy[b] = vector<double>(end - first, 0.0);
+        }
+        nested.cleanChargeTime[b] = vector<vector<double>>(end - first,
+                                                           vector<double>(solution.powerExcess.size(), 0.0));
+        nested.cleanWindowCharge[b] = vector<vector<int>>(end - first, vector<int>(solution.powerExcess.size(), 0));
+    }
+    for(auto &use: solution.cleanEnergy){
+        int b = solution.buses[use.bus];
+        nested.windowEnergyUsed[use.window][b][use.stop] = use.energy;
+        nested.cleanChargeTime[b][use.stop][use.window] = use.chargeTime;
+        nested.cleanWindowCharge[b][use.stop][use.window] = use.charge;
+    }
+    return nested;
+}
+
+/// writes the fields of primitiveVariables in the order of an older class version, so the text archive is the one
+/// that version wrote
+template<int Version>
+struct LegacyVariables{
+    primitiveVariables flat;
+    nestedVariables nested;
+
+    template<class Archive>
+    void serialize(Archive &ar, const unsigned int version){
+        if(Version == 2){
+            vector<vector<double>> tripTime;
+            vector<vector<double>> tripCost;
+            ar & flat.buses & flat.stopStart & flat.chargingStations & flat.busSequences & flat.nonRenewable;
+            ar & flat.arrivalTime & flat.scheduledTime & flat.deviationTime & flat.capacity & flat.chargeTime;
+            ar & flat.chargeAmount & flat.charge & tripTime & tripCost & flat.powerExcess & flat.cleanEnergy;
+            ar & flat.ases & flat.discounts;
+            return;
+        }
+        ar & nested.buses & nested.chargingStations & nested.busSequences & nested.nonRenewable & nested.arrivalTime;
+        ar & nested.scheduledTime & nested.deviationTime & nested.capacity & nested.chargeTime & nested.chargeAmount;
+        ar & nested.charge;
+        if(Version == 1){
+            ar & nested.tripTime & nested.tripCost & nested.powerExcess & nested.windowEnergyUsed & nested.ases;
+            ar & nested.discounts & nested.cleanChargeTime & nested.cleanWindowCharge;
+        }
+    }
+};
+BOOST_CLASS_VERSION(LegacyVariables<0>, 0)
+BOOST_CLASS_VERSION(LegacyVariables<1>, 1)
+BOOST_CLASS_VERSION(LegacyVariables<2>, 2)
+
+/// reads file and reports the fields which differ from expected
+bool check(string name, const primitiveVariables &expected, string file){
+    vector<string> fields = differentFields(expected, Parser().parseSolutionFile(file));
+    filesystem::remove(file);
+    cout << name << ": " << (fields.empty() ? "ok" : "fields differ:");
+    for(string &field: fields){
+        cout << " " << field;
+    }
+    cout << endl;
+    return fields.empty();
+}
+
+template<int Version>
+bool checkLegacy(const primitiveVariables &solution, primitiveVariables expected, string file){
+    LegacyVariables<Version> legacy{solution, nestVariables(solution)};
+    {
+        ofstream stream(file);
+        boost::archive::text_oarchive archive(stream);
+        archive << legacy;
+    }
+    return check("text archive version " + to_string(Version), expected, file);
+}
+
+/// writes MPM and SPM solutions in the binary archive and the text archive, converts between them and reads text
+/// archives of the older class versions, every field has to be read back as it was written
+int main(){
+    string directory = filesystem::temp_directory_path().string() + "/scheduler_solution_test";
+    filesystem::create_directories(directory);
+    Output writer;
+    bool passed = true;
+    for(string method: {"MPM", "SPM"}){
+        cout << method << endl;
+        primitiveVariables solution = generateSolution(method == "SPM", 42);
+        string binaryFile = directory + "/solution.bin";
+        string textFile = directory + "/solution.txt";
+
+        writer.writeSolutionFile(solution, binaryFile);
+        passed &= check("binary archive", solution, binaryFile);
+        writer.writeTextSolutionFile(solution, textFile);
+        passed &= check("text archive", solution, textFile);
+
+        writer.writeTextSolutionFile(solution, textFile);
+        writer.writeSolutionFile(Parser().parseSolutionFile(textFile), binaryFile);
+        passed &= check("text to binary archive", solution, binaryFile);
+        writer.writeSolutionFile(solution, binaryFile);
+        writer.writeTextSolutionFile(Parser().parseSolutionFile(binaryFile), textFile);
+        passed &= check("binary to text archive", solution, textFile);
+        filesystem::remove(binaryFile);
+
+        /// version 0 ends with the charges, version 1 holds the CEW uses as the nested CEW fields
+        primitiveVariables charges = solution;
+        charges.powerExcess.clear();
+        charges.cleanEnergy.clear();
+        charges.ases.clear();
+        charges.discounts.clear();
+        passed &= checkLegacy<0>(solution, charges, textFile);
+        passed &= checkLegacy<1>(solution, solution, textFile);
+        passed &= checkLegacy<2>(solution, solution, textFile);
+    }
+    filesystem::remove_all(directory);
+    cout << (passed ? "passed" : "failed") << endl;
+    return passed ? 0 : 1;
+}
@@ -1,4 +1,6 @@
 #!/bin/sh
+# The same experiments can be run inside a single process, parsing each location once and solving configurations
+# concurrently: ./scheduler --sweep ../../example_sweep.json (see example_sweep.json for the grid format)
 # Declare the data-sets and their location on the computer drive
 locations=("location_1" "location_2")
 locationPaths=("path_to_location_1_data" "path_to_location_2_data")
@@ -156,10 +158,10 @@ do
 							if(($t > 0))
 							then
 							  # If we are recalculating the schedule then execute this
-								./scheduler --discountFactor "${discountFactor}" --busEnergyCost "${busEnergyCost}" --chargeRate "${chargeRate}" --bigM "${bigM}" --maxSolutions $maxSolutions --LPFile $LPFile --timeout $timeout --solutionSaveFile ../../${folderName}/"${location}"/"${datatype}"/"${method}"/"${resultDir}"/${solutionSaveFile}  --maxBatteryCapacity "${maxBatteryCapacity}" --minBatteryCapacity "${minBatteryCapacity}" --deviationTime "${deviationTime}" --timeWindows "${timeWindows}" --busSpeed "$busSpeed" --busDataFile "${path}"/${busDataFile} --stationDataFile "${path}"/${stationDataFile} --stationDistanceFile "${path}"/"${stationDistanceFile}" --logFile ../../${folderName}/"${location}"/"${datatype}"/"${method}"/"${resultDir}"/"${logFile}" --horizonStartTime "${horizonStartTime}" --startingCapacity "${startingCapacity}" --chargingStationsFile ../../charging_station_locations/"${chargeStationDistance}"/"${location}""${chargingStationsFile}" --powerRatio "${powerRatio}" --maxChargeTime "${maxChargeTime}" --minChargeTime "${minChargeTime}" --location "${location}" --horizonEndTime "${horizonEndTime}" --method "${method}" --solutionDataFile ../../${folderName}/"${location}"/"${datatype}"/"${method}"/"${date}"_"${location}"_"${maxBatteryCapacity}"_"${deviationTime}"_"${busSpeed}"_"${horizonStartTimes[$t-1]}"_"${powerRatio}"/${solutionSaveFile} --recalculate "true" --warmingSolutionFile ${LPFile} > ../../${folderName}/"${location}"/"${datatype}"/"${method}"/"${resultDir}"/result.txt
+								./scheduler --discountFactor "${discountFactor}" --busEnergyCost "${busEnergyCost}" --chargeRate "${chargeRate}" --bigM "${bigM}" --maxSolutions $maxSolutions --LPFile $LPFile --timeout $timeout --solutionSaveFile ../../${folderName}/"${location}"/"${datatype}"/"${method}"/"${resultDir}"/${solutionSaveFile}  --maxBatteryCapacity "${maxBatteryCapacity}" --minBatteryCapacity "${minBatteryCapacity}" --deviationTime "${deviationTime}" --CEW "${timeWindows}" --busSpeed "$busSpeed" --busDataFile "${path}"/${busDataFile} --stationDataFile "${path}"/${stationDataFile} --stationDistanceFile "${path}"/"${stationDistanceFile}" --logFile ../../${folderName}/"${location}"/"${datatype}"/"${method}"/"${resultDir}"/"${logFile}" --horizonStartTime "${horizonStartTime}" --startingCapacity "${startingCapacity}" --chargingStationsFile ../../charging_station_locations/"${chargeStationDistance}"/"${location}""${chargingStationsFile}" --powerRatio "${powerRatio}" --maxChargeTime "${maxChargeTime}" --minChargeTime "${minChargeTime}" --location "${location}" --horizonEndTime "${horizonEndTime}" --method "${method}" --solutionDataFile ../../${folderName}/"${location}"/"${datatype}"/"${method}"/"${date}"_"${location}"_"${maxBatteryCapacity}"_"${deviationTime}"_"${busSpeed}"_"${horizonStartTimes[$t-1]}"_"${powerRatio}"/${solutionSaveFile} --recalculate "true" --warmingSolutionFile ${LPFile} --metricsFile ../../${folderName}/"${location}"/"${datatype}"/"${method}"/"${resultDir}"/metrics.json > ../../${folderName}/"${location}"/"${datatype}"/"${method}"/"${resultDir}"/result.txt
 							else
 							  # Otherwise if its the first time we are calculating the schedule for this configuration execute this
-							  ./scheduler --discountFactor "${discountFactor}" --busEnergyCost "${busEnergyCost}" --chargeRate "${chargeRate}" --bigM "${bigM}" --maxSolutions $maxSolutions --LPFile $LPFile --timeout $timeout --solutionSaveFile ../../${folderName}/"${location}"/"${datatype}"/"${method}"/"${resultDir}"/${solutionSaveFile}  --maxBatteryCapacity "${maxBatteryCapacity}" --minBatteryCapacity "${minBatteryCapacity}" --deviationTime "${deviationTime}" --timeWindows "${timeWindows}" --busSpeed "$busSpeed" --busDataFile "${path}"/${busDataFile} --stationDataFile "${path}"/${stationDataFile} --stationDistanceFile "${path}"/"${stationDistanceFile}" --logFile ../../${folderName}/"${location}"/"${datatype}"/"${method}"/"${resultDir}"/"${logFile}" --horizonStartTime "${horizonStartTime}" --startingCapacity "${startingCapacity}" --chargingStationsFile ../../charging_station_locations/"${chargeStationDistance}"/"${location}""${chargingStationsFile}" --powerRatio "${powerRatio}" --maxChargeTime "${maxChargeTime}" --minChargeTime "${minChargeTime}" --location "${location}" --horizonEndTime "${horizonEndTime}" --method "${method}" --warmingSolutionFile ../../warming_solutions/"${location}"/"${chargeStationDistance}"/"${method}"/"${warmingSolutionFile}" > ../../${folderName}/"${location}"/"${datatype}"/"${method}"/"${resultDir}"/result.txt
+							  ./scheduler --discountFactor "${discountFactor}" --busEnergyCost "${busEnergyCost}" --chargeRate "${chargeRate}" --bigM "${bigM}" --maxSolutions $maxSolutions --LPFile $LPFile --timeout $timeout --solutionSaveFile ../../${folderName}/"${location}"/"${datatype}"/"${method}"/"${resultDir}"/${solutionSaveFile}  --maxBatteryCapacity "${maxBatteryCapacity}" --minBatteryCapacity "${minBatteryCapacity}" --deviationTime "${deviationTime}" --CEW "${timeWindows}" --busSpeed "$busSpeed" --busDataFile "${path}"/${busDataFile} --stationDataFile "${path}"/${stationDataFile} --stationDistanceFile "${path}"/"${stationDistanceFile}" --logFile ../../${folderName}/"${location}"/"${datatype}"/"${method}"/"${resultDir}"/"${logFile}" --horizonStartTime "${horizonStartTime}" --startingCapacity "${startingCapacity}" --chargingStationsFile ../../charging_station_locations/"${chargeStationDistance}"/"${location}""${chargingStationsFile}" --powerRatio "${powerRatio}" --maxChargeTime "${maxChargeTime}" --minChargeTime "${minChargeTime}" --location "${location}" --horizonEndTime "${horizonEndTime}" --method "${method}" --warmingSolutionFile ../../warming_solutions/"${location}"/"${chargeStationDistance}"/"${method}"/"${warmingSolutionFile}" --metricsFile ../../${folderName}/"${location}"/"${datatype}"/"${method}"/"${resultDir}"/metrics.json > ../../${folderName}/"${location}"/"${datatype}"/"${method}"/"${resultDir}"/result.txt
 							fi
 							cd ../..
 						done
@@ -169,6 +171,6 @@ do
 		done
 	done
 done
-rm code/release-build/model.lp
+rm code/release-build/model.mps
 rm code/release-build/solution.lp
 find . -name scheduleDetails -type f -delete